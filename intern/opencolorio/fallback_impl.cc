@@ -63,7 +63,7 @@ struct FallbackTransform {
     delete display_transform;
   }
 
-  void applyRGB(float *pixel)
+  virtual void applyRGB(float *pixel)
   {
     if (type == TRANSFORM_LINEAR_TO_SRGB) {
       applyLinearRGB(pixel);
@@ -91,7 +91,7 @@ struct FallbackTransform {
     }
   }
 
-  void applyRGBA(float *pixel)
+  virtual void applyRGBA(float *pixel)
   {
     if (type == TRANSFORM_LINEAR_TO_SRGB) {
       applyLinearRGBA(pixel);
@@ -170,6 +170,21 @@ struct FallbackGroupTransform : FallbackTransform {
       delete transform;
     }
   }
+
+  void applyRGB(float *pixel) override
+  {
+    for (auto transform : list) {
+      transform->applyRGB(pixel);
+    }
+  }
+
+  void applyRGBA(float *pixel) override
+  {
+    for (auto transform : list) {
+      transform->applyRGBA(pixel);
+    }
+  }
+
   std::vector<FallbackTransform *> list;
 };
 
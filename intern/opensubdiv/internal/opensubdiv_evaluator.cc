@@ -133,6 +133,11 @@ void evaluateFaceVarying(OpenSubdiv_Evaluator *evaluator,
       face_varying_channel, ptex_face_index, face_u, face_v, face_varying);
 }
 
+size_t getMemoryUsage(const OpenSubdiv_Evaluator *evaluator)
+{
+  return evaluator->internal->memory_usage;
+}
+
 void assignFunctionPointers(OpenSubdiv_Evaluator *evaluator)
 {
   evaluator->setCoarsePositions = setCoarsePositions;
@@ -150,6 +155,8 @@ void assignFunctionPointers(OpenSubdiv_Evaluator *evaluator)
   evaluator->evaluateFaceVarying = evaluateFaceVarying;
 
   evaluator->evaluatePatchesLimit = evaluatePatchesLimit;
+
+  evaluator->getMemoryUsage = getMemoryUsage;
 }
 
 }  // namespace
@@ -736,7 +736,7 @@ void CpuEvalOutputAPI::evaluatePatchesLimit(const OpenSubdiv_PatchCoord *patch_c
 }  // namespace blender
 
 OpenSubdiv_EvaluatorInternal::OpenSubdiv_EvaluatorInternal()
-    : eval_output(NULL), patch_map(NULL), patch_table(NULL)
+    : eval_output(NULL), patch_map(NULL), patch_table(NULL), memory_usage(0)
 {
 }
 
@@ -747,6 +747,63 @@ OpenSubdiv_EvaluatorInternal::~OpenSubdiv_EvaluatorInternal()
   delete patch_table;
 }
 
+namespace {
+
+using blender::opensubdiv::vector;
+
+// Memory used by the copy of the stencil table which is kept by the evaluator.
+size_t stencilTableMemoryUsage(const StencilTable *table)
+{
+  if (table == NULL) {
+    return 0;
+  }
+  return table->GetSizes().size() * sizeof(int) +
+         table->GetOffsets().size() * sizeof(OpenSubdiv::Far::Index) +
+         table->GetControlIndices().size() * sizeof(OpenSubdiv::Far::Index) +
+         table->GetWeights().size() * sizeof(float);
+}
+
+// Memory used by the refined topology levels, patch table and its CPU copy, stencil tables and
+// vertex buffers of the evaluator.
+//
+// Is an estimate: the topology levels are accounted with the size of their per-component
+// arrays, without the allocation overhead.
+size_t evaluatorMemoryUsage(const TopologyRefiner *refiner,
+                            const StencilTable *vertex_stencils,
+                            const StencilTable *varying_stencils,
+                            const vector<const StencilTable *> &all_face_varying_stencils,
+                            const PatchTable *patch_table)
+{
+  // Refined topology: incident components of every vertex, edge and face, their tags and
+  // sharpness.
+  size_t memory = 0;
+  memory += (size_t)refiner->GetNumVerticesTotal() * 32;
+  memory += (size_t)refiner->GetNumEdgesTotal() * 32;
+  memory += (size_t)refiner->GetNumFacesTotal() * 16;
+  memory += (size_t)refiner->GetNumFaceVerticesTotal() * 16;
+  // Stencil tables.
+  memory += stencilTableMemoryUsage(vertex_stencils);
+  memory += stencilTableMemoryUsage(varying_stencils);
+  foreach (const StencilTable *table, all_face_varying_stencils) {
+    memory += stencilTableMemoryUsage(table);
+  }
+  // Patch table is kept for the patch map, and copied into the CPU patch table.
+  const size_t patch_table_memory = patch_table->GetPatchControlVerticesTable().size() *
+                                        sizeof(OpenSubdiv::Far::Index) +
+                                    (size_t)patch_table->GetNumPatchesTotal() *
+                                        sizeof(OpenSubdiv::Far::PatchParam);
+  memory += patch_table_memory * 2;
+  // Vertex buffers: coarse and refined positions, and face-varying coordinates.
+  const size_t num_coarse_vertices = refiner->GetLevel(0).GetNumVertices();
+  memory += (num_coarse_vertices + vertex_stencils->GetNumStencils()) * 3 * sizeof(float);
+  foreach (const StencilTable *table, all_face_varying_stencils) {
+    memory += (size_t)table->GetNumStencils() * 2 * sizeof(float);
+  }
+  return memory;
+}
+
+}  // namespace
+
 OpenSubdiv_EvaluatorInternal *openSubdiv_createEvaluatorInternal(
     OpenSubdiv_TopologyRefiner *topology_refiner)
 {
@@ -862,6 +919,8 @@ OpenSubdiv_EvaluatorInternal *openSubdiv_createEvaluatorInternal(
   evaluator_descr->eval_output = new blender::opensubdiv::CpuEvalOutputAPI(eval_output, patch_map);
   evaluator_descr->patch_map = patch_map;
   evaluator_descr->patch_table = patch_table;
+  evaluator_descr->memory_usage = evaluatorMemoryUsage(
+      refiner, vertex_stencils, varying_stencils, all_face_varying_stencils, patch_table);
   // TOOD(sergey): Look into whether we've got duplicated stencils arrays.
   delete vertex_stencils;
   delete varying_stencils;
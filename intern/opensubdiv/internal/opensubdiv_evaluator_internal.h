@@ -144,6 +144,8 @@ struct OpenSubdiv_EvaluatorInternal {
   blender::opensubdiv::CpuEvalOutputAPI *eval_output;
   const OpenSubdiv::Far::PatchMap *patch_map;
   const OpenSubdiv::Far::PatchTable *patch_table;
+  // Estimated memory used by the refined topology and evaluator, in bytes.
+  size_t memory_usage;
 };
 
 OpenSubdiv_EvaluatorInternal *openSubdiv_createEvaluatorInternal(
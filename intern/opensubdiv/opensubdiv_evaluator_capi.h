@@ -19,6 +19,8 @@
 #ifndef OPENSUBDIV_EVALUATOR_CAPI_H_
 #define OPENSUBDIV_EVALUATOR_CAPI_H_
 
+#include <stddef.h>  // for size_t
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -122,6 +124,9 @@ typedef struct OpenSubdiv_Evaluator {
                                float *dPdu,
                                float *dPdv);
 
+  // Estimated memory used by the evaluator and the refined topology it is created for, in bytes.
+  size_t (*getMemoryUsage)(const struct OpenSubdiv_Evaluator *evaluator);
+
   // Internal storage for the use in this module only.
   //
   // This is where actual OpenSubdiv's evaluator is living.
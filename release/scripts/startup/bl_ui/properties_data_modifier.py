@@ -1145,6 +1145,11 @@ class DATA_PT_modifiers(ModifierButtonsPanel, Panel):
 
             col.prop(md, "quality")
 
+            col.prop(md, "use_camera_levels")
+            sub = col.column()
+            sub.active = md.use_camera_levels
+            sub.prop(md, "camera_edge_size")
+
         col = split.column()
         col.label(text="Options:")
 
@@ -833,6 +833,7 @@ class VIEW3D_PT_sculpt_options(Panel, View3DPaintPanel):
         col.prop(sculpt, "show_low_resolution")
         col.prop(sculpt, "use_sculpt_delay_updates")
         col.prop(sculpt, "use_deform_only")
+        col.prop(sculpt, "use_optimized_vertex_order")
 
         col.separator()
 
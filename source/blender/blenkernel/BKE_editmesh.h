@@ -84,6 +84,12 @@ typedef struct BMEditMesh {
    */
   char needs_flush_to_id;
 
+  /**
+   * Set while an interactive operation (transform) only moves vertices,
+   * so the draw cache can keep its topology and attribute buffers.
+   */
+  char is_deform_only_update;
+
 } BMEditMesh;
 
 /* editmesh.c */
@@ -264,6 +264,7 @@ void BKE_mesh_vert_coords_apply_with_mat4(struct Mesh *mesh,
                                           const float mat[4][4]);
 void BKE_mesh_vert_coords_apply(struct Mesh *mesh, const float (*vert_coords)[3]);
 void BKE_mesh_vert_normals_apply(struct Mesh *mesh, const short (*vertNormals)[3]);
+void BKE_mesh_vert_reorder(struct Mesh *mesh, const unsigned int *vert_order);
 
 /* *** mesh_evaluate.c *** */
 
@@ -685,6 +686,8 @@ enum {
   BKE_MESH_BATCH_DIRTY_SHADING,
   BKE_MESH_BATCH_DIRTY_UVEDIT_ALL,
   BKE_MESH_BATCH_DIRTY_UVEDIT_SELECT,
+  /** Only vertex coordinates changed, topology and other attributes are the same. */
+  BKE_MESH_BATCH_DIRTY_DEFORM,
 };
 void BKE_mesh_batch_cache_dirty_tag(struct Mesh *me, int mode);
 void BKE_mesh_batch_cache_free(struct Mesh *me);
@@ -48,6 +48,8 @@ void BKE_movieclip_clear_cache(struct MovieClip *clip);
 void BKE_movieclip_clear_proxy_cache(struct MovieClip *clip);
 
 void BKE_movieclip_convert_multilayer_ibuf(struct ImBuf *ibuf);
+struct ImBuf *BKE_movieclip_ibuf_from_memory(
+    const unsigned char *mem, size_t size, int flag, char *colorspace, const char *descr);
 
 struct ImBuf *BKE_movieclip_get_ibuf(struct MovieClip *clip, struct MovieClipUser *user);
 struct ImBuf *BKE_movieclip_get_postprocessed_ibuf(struct MovieClip *clip,
@@ -438,6 +438,17 @@ void BKE_sculpt_bvh_update_from_ccg(struct PBVH *pbvh, struct SubdivCCG *subdiv_
 
 bool BKE_sculptsession_use_pbvh_draw(const struct Object *ob, const struct View3D *v3d);
 
+/* Vertex layer storing the original index of each vertex while the vertices of a sculpted mesh
+ * are reordered by #BKE_sculpt_vertex_order_optimize. */
+#define SCULPT_ORIG_VERT_INDEX_LAYER_NAME "_sculpt_orig_vert_index"
+/* Vertex layer storing the index of each vertex in the order computed by
+ * #BKE_sculpt_vertex_order_optimize. It is kept when leaving sculpt mode, so entering again gives
+ * the same order, which sculpt undo steps refer to. */
+#define SCULPT_VERT_ORDER_LAYER_NAME "_sculpt_vert_order"
+
+bool BKE_sculpt_vertex_order_optimize(struct Main *bmain, struct Object *ob);
+bool BKE_sculpt_vertex_order_restore(struct Mesh *me);
+
 enum {
   SCULPT_MASK_LAYER_CALC_VERT = (1 << 0),
   SCULPT_MASK_LAYER_CALC_LOOP = (1 << 1),
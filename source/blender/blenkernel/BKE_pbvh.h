@@ -122,6 +122,7 @@ void BKE_pbvh_build_bmesh(PBVH *bvh,
                           struct BMLog *log,
                           const int cd_vert_node_offset,
                           const int cd_face_node_offset);
+void BKE_pbvh_vert_order_by_node(PBVH *bvh, int *r_vert_order);
 void BKE_pbvh_free(PBVH *bvh);
 
 /* Hierarchical Search in the BVH, two methods:
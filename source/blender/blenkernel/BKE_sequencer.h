@@ -87,9 +87,14 @@ void BKE_sequence_iterator_end(SeqIterator *iter);
   } \
   ((void)0)
 
+/* Maximum number of prefetch threads rendering frames concurrently. */
+#define SEQ_PREFETCH_WORKERS_MAX 8
+
 typedef enum eSeqTaskId {
   SEQ_TASK_MAIN_RENDER,
+  /* Prefetch workers use consecutive IDs starting here. */
   SEQ_TASK_PREFETCH_RENDER,
+  SEQ_TASK_MAX = SEQ_TASK_PREFETCH_RENDER + SEQ_PREFETCH_WORKERS_MAX,
 } eSeqTaskId;
 
 typedef struct SeqRenderData {
@@ -312,6 +317,10 @@ void BKE_sequencer_proxy_rebuild(struct SeqIndexBuildContext *context,
                                  short *stop,
                                  short *do_update,
                                  float *num_frames_prefetched);
+void BKE_sequencer_proxy_rebuild_queue(ListBase *queue,
+                                       short *stop,
+                                       short *do_update,
+                                       float *progress);
 void BKE_sequencer_proxy_rebuild_finish(struct SeqIndexBuildContext *context, bool stop);
 
 void BKE_sequencer_proxy_set(struct Sequence *seq, bool value);
@@ -186,6 +186,12 @@ typedef struct Subdiv {
   /* Statistics for debugging. */
   SubdivStats stats;
 
+  /* Hash of the topology this descriptor was created for. Descriptors created with the cached-aware
+   * semantic are kept in a topology cache when freed, so they can be re-used by a later update
+   * with the same topology instead of building a new topology refiner and evaluator. */
+  uint32_t topology_hash;
+  bool use_topology_cache;
+
   /* Cached values, are not supposed to be accessed directly. */
   struct {
     /* Indexed by base face index, element indicates total number of ptex
@@ -233,7 +239,8 @@ Subdiv *BKE_subdiv_new_from_mesh(const SubdivSettings *settings, const struct Me
 /* Similar to above, but will not re-create descriptor if it was created for the
  * same settings and topology.
  * If settings or topology did change, the existing descriptor is freed and a
- * new one is created from scratch.
+ * new one is taken from the topology cache, or created from scratch if there
+ * is no cached descriptor with matching settings and topology.
  *
  * NOTE: It is allowed to pass NULL as an existing subdivision surface
  * descriptor. This will create a new descriptor without any extra checks.
@@ -245,8 +252,17 @@ Subdiv *BKE_subdiv_update_from_mesh(Subdiv *subdiv,
                                     const SubdivSettings *settings,
                                     const struct Mesh *mesh);
 
+/* Descriptors created by BKE_subdiv_update_from_converter() are moved to the
+ * topology cache instead of being freed, until the cache exceeds its memory
+ * budget. */
 void BKE_subdiv_free(Subdiv *subdiv);
 
+/* Free cached descriptors exceeding the memory budget, after the memory cache limit preference
+ * was lowered. */
+void BKE_subdiv_topology_cache_trim(void);
+/* Free all descriptors kept in the topology cache. */
+void BKE_subdiv_topology_cache_clear(void);
+
 /* ============================ DISPLACEMENT API ============================ */
 
 void BKE_subdiv_displacement_attach_from_multires(Subdiv *subdiv,
@@ -103,6 +103,29 @@ void BKE_subdiv_eval_displacement(struct Subdiv *subdiv,
 void BKE_subdiv_eval_final_point(
     struct Subdiv *subdiv, const int ptex_face_index, const float u, const float v, float r_P[3]);
 
+/* Batched queries.
+ *
+ * Evaluate limit surface at a number of (u, v) coordinates of the same ptex face with a single
+ * call to the evaluator. This avoids per-point overhead of going through the evaluator and lets
+ * OpenSubdiv evaluate patch basis for many points at once.
+ *
+ * Derivatives are only evaluated when both r_dPdu and r_dPdv are not NULL. */
+
+void BKE_subdiv_eval_limit_points(struct Subdiv *subdiv,
+                                  const int ptex_face_index,
+                                  const float (*uvs)[2],
+                                  const int num_points,
+                                  float (*r_P)[3],
+                                  float (*r_dPdu)[3],
+                                  float (*r_dPdv)[3]);
+
+/* Evaluate points on a limit surface with displacement applied to them. */
+void BKE_subdiv_eval_final_points(struct Subdiv *subdiv,
+                                  const int ptex_face_index,
+                                  const float (*uvs)[2],
+                                  const int num_points,
+                                  float (*r_P)[3]);
+
 /* Patch queries at given resolution.
  *
  * Will evaluate patch at uniformly distributed (u, v) coordinates on a grid
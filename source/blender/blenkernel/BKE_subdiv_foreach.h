@@ -70,6 +70,18 @@ typedef void (*SubdivForeachVertexInnerCb)(const struct SubdivForeachContext *co
                                            const int coarse_corner,
                                            const int subdiv_vertex_index);
 
+/* Maximum number of vertices passed to a single SubdivForeachVerticesInnerCb call. */
+#define SUBDIV_FOREACH_VERTICES_INNER_BATCH_SIZE 256
+
+typedef void (*SubdivForeachVerticesInnerCb)(const struct SubdivForeachContext *context,
+                                             void *tls,
+                                             const int ptex_face_index,
+                                             const float (*uvs)[2],
+                                             const int num_vertices,
+                                             const int coarse_poly_index,
+                                             const int coarse_corner,
+                                             const int start_subdiv_vertex_index);
+
 typedef void (*SubdivForeachEdgeCb)(const struct SubdivForeachContext *context,
                                     void *tls,
                                     const int coarse_edge_index,
@@ -128,6 +140,10 @@ typedef struct SubdivForeachContext {
   SubdivForeachVertexFromEdgeCb vertex_edge;
   /* Called exactly once, always corresponds to a single ptex face. */
   SubdivForeachVertexInnerCb vertex_inner;
+  /* Same as above, but called for a span of consecutive subdivision vertices of the same ptex
+   * face, which allows to evaluate their limit positions with a single evaluator call.
+   * When set, it is used instead of vertex_inner. */
+  SubdivForeachVerticesInnerCb vertices_inner;
   /* Called once for each loose vertex. One loose coarse vertexcorresponds
    * to a single subdivision vertex.
    */
@@ -2179,6 +2179,90 @@ float BKE_brush_curve_strength(const Brush *br, float p, const float len)
   return strength;
 }
 
+/**
+ * Same as #BKE_brush_curve_strength for many distances at once, replacing each distance in
+ * \a values by its strength. The falloff preset is only checked once, so the loops over the
+ * values are simple enough to be vectorized.
+ */
+void BKE_brush_curve_strength_array(const Brush *br,
+                                    float *values,
+                                    const int values_len,
+                                    const float len)
+{
+  float p[64];
+  bool inside[64];
+
+  for (int offset = 0; offset < values_len; offset += ARRAY_SIZE(p)) {
+    float *v = values + offset;
+    const int n = min_ii(values_len - offset, ARRAY_SIZE(p));
+
+    for (int i = 0; i < n; i++) {
+      inside[i] = v[i] < len;
+      /* Clamp so the curves never see values outside of their domain,
+       * distances outside of the brush are discarded below. */
+      p[i] = max_ff(1.0f - v[i] / len, 0.0f);
+    }
+
+    switch (br->curve_preset) {
+      case BRUSH_CURVE_CUSTOM:
+        for (int i = 0; i < n; i++) {
+          v[i] = inside[i] ? BKE_curvemapping_evaluateF(br->curve, 0, 1.0f - p[i]) : 0.0f;
+        }
+        continue;
+      case BRUSH_CURVE_SHARP:
+        for (int i = 0; i < n; i++) {
+          v[i] = p[i] * p[i];
+        }
+        break;
+      case BRUSH_CURVE_SMOOTH:
+        for (int i = 0; i < n; i++) {
+          v[i] = 3.0f * p[i] * p[i] - 2.0f * p[i] * p[i] * p[i];
+        }
+        break;
+      case BRUSH_CURVE_SMOOTHER:
+        for (int i = 0; i < n; i++) {
+          v[i] = pow3f(p[i]) * (p[i] * (p[i] * 6.0f - 15.0f) + 10.0f);
+        }
+        break;
+      case BRUSH_CURVE_ROOT:
+        for (int i = 0; i < n; i++) {
+          v[i] = sqrtf(p[i]);
+        }
+        break;
+      case BRUSH_CURVE_LIN:
+        for (int i = 0; i < n; i++) {
+          v[i] = p[i];
+        }
+        break;
+      case BRUSH_CURVE_SPHERE:
+        for (int i = 0; i < n; i++) {
+          v[i] = sqrtf(2 * p[i] - p[i] * p[i]);
+        }
+        break;
+      case BRUSH_CURVE_POW4:
+        for (int i = 0; i < n; i++) {
+          v[i] = p[i] * p[i] * p[i] * p[i];
+        }
+        break;
+      case BRUSH_CURVE_INVSQUARE:
+        for (int i = 0; i < n; i++) {
+          v[i] = p[i] * (2.0f - p[i]);
+        }
+        break;
+      case BRUSH_CURVE_CONSTANT:
+      default:
+        for (int i = 0; i < n; i++) {
+          v[i] = 1.0f;
+        }
+        break;
+    }
+
+    for (int i = 0; i < n; i++) {
+      v[i] = inside[i] ? v[i] : 0.0f;
+    }
+  }
+}
+
 /* Uses the brush curve control to find a strength value between 0 and 1 */
 float BKE_brush_curve_strength_clamped(Brush *br, float p, const float len)
 {
@@ -222,6 +222,8 @@ static void image_add_view(Image *ima, const char *viewname, const char *filepat
 
 typedef struct ImageCacheKey {
   int index;
+  /* Buffer is a frame of a sequence or movie, not part of the hash. */
+  bool is_frame;
 } ImageCacheKey;
 
 static unsigned int imagecache_hashhash(const void *key_v)
@@ -242,7 +244,7 @@ static void imagecache_keydata(void *userkey, int *framenr, int *proxy, int *ren
 {
   ImageCacheKey *key = userkey;
 
-  *framenr = IMA_INDEX_ENTRY(key->index);
+  *framenr = key->is_frame ? IMA_INDEX_ENTRY(key->index) : IMB_MOVIECACHE_NO_FRAMENR;
   *proxy = IMB_PROXY_NONE;
   *render_flags = 0;
 }
@@ -261,6 +263,7 @@ static void imagecache_put(Image *image, int index, ImBuf *ibuf)
   }
 
   key.index = index;
+  key.is_frame = ELEM(image->source, IMA_SRC_SEQUENCE, IMA_SRC_MOVIE);
 
   IMB_moviecache_put(image->cache, &key, ibuf);
 }
@@ -273,6 +276,7 @@ static void imagecache_remove(Image *image, int index)
 
   ImageCacheKey key;
   key.index = index;
+  key.is_frame = ELEM(image->source, IMA_SRC_SEQUENCE, IMA_SRC_MOVIE);
   IMB_moviecache_remove(image->cache, &key);
 }
 
@@ -281,6 +285,7 @@ static struct ImBuf *imagecache_get(Image *image, int index)
   if (image->cache) {
     ImageCacheKey key;
     key.index = index;
+    key.is_frame = ELEM(image->source, IMA_SRC_SEQUENCE, IMA_SRC_MOVIE);
     return IMB_moviecache_get(image->cache, &key);
   }
 
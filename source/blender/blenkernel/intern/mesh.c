@@ -30,11 +30,13 @@
 #include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
 
+#include "BLI_array_utils.h"
 #include "BLI_bitmap.h"
 #include "BLI_edgehash.h"
 #include "BLI_ghash.h"
 #include "BLI_hash.h"
 #include "BLI_linklist.h"
+#include "BLI_listbase.h"
 #include "BLI_math.h"
 #include "BLI_memarena.h"
 #include "BLI_string.h"
@@ -1641,6 +1643,83 @@ void BKE_mesh_vert_normals_apply(Mesh *mesh, const short (*vert_normals)[3])
   mesh->runtime.cd_dirty_vert &= ~CD_MASK_NORMAL;
 }
 
+/**
+ * Reorder the vertices of \a mesh in place, along with all vertex custom-data layers and
+ * shape keys. Edges, loops and the selection history are updated to the new indices.
+ *
+ * \param vert_order: For each new vertex index, the index it had before (a permutation).
+ */
+void BKE_mesh_vert_reorder(Mesh *mesh, const uint *vert_order)
+{
+  const int totvert = mesh->totvert;
+  BLI_assert(mesh->edit_mesh == NULL);
+
+  uint *vert_map = MEM_malloc_arrayN(totvert, sizeof(*vert_map), __func__);
+  for (int i = 0; i < totvert; i++) {
+    vert_map[vert_order[i]] = i;
+  }
+
+  /* Vertex data is moved as raw bytes, layers keep ownership of their elements' allocations
+   * (e.g. deform weights), only their position in the array changes. */
+  void *arr_temp = NULL;
+  size_t arr_temp_size = 0;
+  for (int i = 0; i < mesh->vdata.totlayer; i++) {
+    CustomDataLayer *layer = &mesh->vdata.layers[i];
+    const int n = i - CustomData_get_layer_index(&mesh->vdata, layer->type);
+    void *data = CustomData_duplicate_referenced_layer_n(&mesh->vdata, layer->type, n, totvert);
+    const size_t stride = (size_t)CustomData_sizeof(layer->type);
+    if (arr_temp_size < stride * totvert) {
+      MEM_SAFE_FREE(arr_temp);
+      arr_temp_size = stride * totvert;
+      arr_temp = MEM_mallocN(arr_temp_size, __func__);
+    }
+    _bli_array_permute(data, totvert, stride, vert_order, arr_temp);
+  }
+
+  if (mesh->key) {
+    LISTBASE_FOREACH (KeyBlock *, kb, &mesh->key->block) {
+      if (kb->totelem != totvert) {
+        continue;
+      }
+      const size_t stride = (size_t)mesh->key->elemsize;
+      if (arr_temp_size < stride * totvert) {
+        MEM_SAFE_FREE(arr_temp);
+        arr_temp_size = stride * totvert;
+        arr_temp = MEM_mallocN(arr_temp_size, __func__);
+      }
+      _bli_array_permute(kb->data, totvert, stride, vert_order, arr_temp);
+    }
+  }
+  MEM_SAFE_FREE(arr_temp);
+
+  BKE_mesh_update_customdata_pointers(mesh, false);
+
+  MEdge *medge = CustomData_duplicate_referenced_layer(&mesh->edata, CD_MEDGE, mesh->totedge);
+  mesh->medge = medge;
+  for (int i = 0; i < mesh->totedge; i++) {
+    medge[i].v1 = vert_map[medge[i].v1];
+    medge[i].v2 = vert_map[medge[i].v2];
+  }
+
+  MLoop *mloop = CustomData_duplicate_referenced_layer(&mesh->ldata, CD_MLOOP, mesh->totloop);
+  mesh->mloop = mloop;
+  for (int i = 0; i < mesh->totloop; i++) {
+    mloop[i].v = vert_map[mloop[i].v];
+  }
+
+  for (int i = 0; i < mesh->totselect; i++) {
+    if (mesh->mselect[i].type == ME_VSEL) {
+      mesh->mselect[i].index = (int)vert_map[mesh->mselect[i].index];
+    }
+  }
+
+  /* Legacy faces are not used by the original mesh, simply regenerate them on demand. */
+  BKE_mesh_tessface_clear(mesh);
+  BKE_mesh_runtime_clear_geometry(mesh);
+
+  MEM_freeN(vert_map);
+}
+
 /**
  * Compute 'split' (aka loop, or per face corner's) normals.
  *
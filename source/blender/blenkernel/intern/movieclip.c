@@ -313,6 +313,24 @@ static void movieclip_convert_multilayer_add_pass(void *UNUSED(layer),
   }
 }
 
+/* Only the first combined pass is used by BKE_movieclip_convert_multilayer_ibuf(), so the other
+ * passes are not read at all. */
+static bool movieclip_multilayer_read_filter(void *userdata,
+                                             const char *UNUSED(layname),
+                                             const char *pass_name,
+                                             const char *chan_id)
+{
+  bool *has_combined_pass = userdata;
+  if (*has_combined_pass) {
+    return false;
+  }
+  if (STREQ(pass_name, RE_PASSNAME_COMBINED) || STREQ(chan_id, "RGBA") || STREQ(chan_id, "RGB")) {
+    *has_combined_pass = true;
+    return true;
+  }
+  return false;
+}
+
 #endif /* WITH_OPENEXR */
 
 /* Will try to make image buffer usable when originating from the multi-layer
@@ -348,6 +366,24 @@ void BKE_movieclip_convert_multilayer_ibuf(struct ImBuf *ibuf)
 #endif
 }
 
+/* Load a frame from memory, reading only the pass of multilayer images which is used by
+ * BKE_movieclip_convert_multilayer_ibuf(). */
+ImBuf *BKE_movieclip_ibuf_from_memory(
+    const unsigned char *mem, size_t size, int flag, char *colorspace, const char *descr)
+{
+  ImBuf *ibuf;
+#ifdef WITH_OPENEXR
+  bool has_combined_pass = false;
+  IMB_exr_read_filter(movieclip_multilayer_read_filter, &has_combined_pass);
+#endif
+  ibuf = IMB_ibImageFromMemory(mem, size, flag, colorspace, descr);
+#ifdef WITH_OPENEXR
+  IMB_exr_read_filter(NULL, NULL);
+#endif
+  BKE_movieclip_convert_multilayer_ibuf(ibuf);
+  return ibuf;
+}
+
 static ImBuf *movieclip_load_sequence_file(MovieClip *clip,
                                            const MovieClipUser *user,
                                            int framenr,
@@ -384,7 +420,14 @@ static ImBuf *movieclip_load_sequence_file(MovieClip *clip,
   loadflag = IB_rect | IB_multilayer | IB_alphamode_detect | IB_metadata;
 
   /* read ibuf */
+#ifdef WITH_OPENEXR
+  bool has_combined_pass = false;
+  IMB_exr_read_filter(movieclip_multilayer_read_filter, &has_combined_pass);
+#endif
   ibuf = IMB_loadiffname(name, loadflag, colorspace);
+#ifdef WITH_OPENEXR
+  IMB_exr_read_filter(NULL, NULL);
+#endif
   BKE_movieclip_convert_multilayer_ibuf(ibuf);
 
   return ibuf;
@@ -589,7 +632,7 @@ static int moviecache_getitempriority(void *last_userkey_v, void *priority_data_
   MovieClipImBufCacheKey *last_userkey = (MovieClipImBufCacheKey *)last_userkey_v;
   MovieClipCachePriorityData *priority_data = (MovieClipCachePriorityData *)priority_data_v;
 
-  return -abs(last_userkey->framenr - priority_data->framenr);
+  return IMB_moviecache_frame_priority(last_userkey->framenr, priority_data->framenr);
 }
 
 static void moviecache_prioritydeleter(void *priority_data_v)
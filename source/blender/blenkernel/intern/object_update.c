@@ -348,9 +348,14 @@ void BKE_object_eval_uber_transform(Depsgraph *depsgraph, Object *object)
 void BKE_object_batch_cache_dirty_tag(Object *ob)
 {
   switch (ob->type) {
-    case OB_MESH:
-      BKE_mesh_batch_cache_dirty_tag(ob->data, BKE_MESH_BATCH_DIRTY_ALL);
+    case OB_MESH: {
+      Mesh *mesh = ob->data;
+      const bool is_deform_only = (mesh->edit_mesh != NULL) &&
+                                  mesh->edit_mesh->is_deform_only_update;
+      BKE_mesh_batch_cache_dirty_tag(
+          mesh, is_deform_only ? BKE_MESH_BATCH_DIRTY_DEFORM : BKE_MESH_BATCH_DIRTY_ALL);
       break;
+    }
     case OB_LATTICE:
       BKE_lattice_batch_cache_dirty_tag(ob->data, BKE_LATTICE_BATCH_DIRTY_ALL);
       break;
@@ -1944,3 +1944,212 @@ bool BKE_sculptsession_use_pbvh_draw(const Object *ob, const View3D *v3d)
     return true;
   }
 }
+
+/* -------------------------------------------------------------------- */
+/** \name Sculpt Vertex Order
+ *
+ * Brushes iterate over the vertices of PBVH nodes, which are scattered over the whole vertex
+ * array of the mesh. Optionally the vertices are reordered by PBVH leaf when entering sculpt
+ * mode, so the vertices of a node are contiguous in memory. The original index of every vertex
+ * is stored in a layer which is saved with the mesh, so the original order can be restored when
+ * leaving sculpt mode, also after undo or loading a file saved in sculpt mode.
+ *
+ * The order is only computed once. Sculpt undo steps store vertex indices and can be applied
+ * after sculpt mode was left and entered again, so the order is kept in a second layer and
+ * reused as long as it is valid for the mesh.
+ * \{ */
+
+typedef struct SculptVertexOrderUserData {
+  const ID *ob_id;
+  const ID *me_id;
+  bool is_referenced;
+} SculptVertexOrderUserData;
+
+static void sculpt_vertex_order_modifier_id_walk(void *userData,
+                                                 Object *UNUSED(ob),
+                                                 ID **idpoin,
+                                                 int UNUSED(cb_flag))
+{
+  SculptVertexOrderUserData *data = userData;
+  if (*idpoin != NULL && ELEM(*idpoin, data->ob_id, data->me_id)) {
+    data->is_referenced = true;
+  }
+}
+
+static bool sculpt_vertex_order_supported(Main *bmain, Object *ob)
+{
+  if (ob->type != OB_MESH) {
+    return false;
+  }
+  Mesh *me = ob->data;
+  if (ID_IS_LINKED(me) || ID_REAL_USERS(me) > 1 || me->edit_mesh != NULL ||
+      me->totpoly == 0 || (me->flag & ME_SCULPT_DYNAMIC_TOPOLOGY)) {
+    return false;
+  }
+  /* Modifiers and particles may store vertex indices (hooks, bindings, emission...). */
+  if (!BLI_listbase_is_empty(&ob->modifiers) || !BLI_listbase_is_empty(&ob->particlesystem)) {
+    return false;
+  }
+  /* Modifiers of other objects may store vertex indices of this mesh as well (surface and mesh
+   * deform bindings, hooks...). Refuse when any of them references the object or its mesh. */
+  SculptVertexOrderUserData data = {
+      .ob_id = &ob->id,
+      .me_id = &me->id,
+      .is_referenced = false,
+  };
+  LISTBASE_FOREACH (Object *, ob_iter, &bmain->objects) {
+    if (ob_iter->parent == ob && ELEM(ob_iter->partype, PARVERT1, PARVERT3)) {
+      return false;
+    }
+    if (ob_iter != ob) {
+      BKE_modifiers_foreach_ID_link(ob_iter, sculpt_vertex_order_modifier_id_walk, &data);
+      if (data.is_referenced) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/* Invert a vertex layer holding a permutation of the vertex indices. Tools changing the topology
+ * don't maintain the sculpt layers, so this fails when the layer is not a permutation. */
+static bool sculpt_vertex_order_layer_invert(const int *layer, const int totvert, int *r_inverse)
+{
+  BLI_bitmap *vert_found = BLI_BITMAP_NEW(totvert, __func__);
+  bool is_valid = true;
+  for (int i = 0; i < totvert; i++) {
+    const int v = layer[i];
+    if (v < 0 || v >= totvert || BLI_BITMAP_TEST(vert_found, v)) {
+      is_valid = false;
+      break;
+    }
+    BLI_BITMAP_ENABLE(vert_found, v);
+    r_inverse[v] = i;
+  }
+  MEM_freeN(vert_found);
+  return is_valid;
+}
+
+static void sculpt_vertex_order_layer_free(Mesh *me, const char *name)
+{
+  const int layer_index = CustomData_get_named_layer_index(&me->vdata, CD_PROP_INT, name);
+  if (layer_index != -1) {
+    CustomData_free_layer(&me->vdata, CD_PROP_INT, me->totvert, layer_index);
+    BKE_mesh_update_customdata_pointers(me, false);
+  }
+}
+
+/* Order the vertices by the leaves of the PBVH sculpt mode builds for the mesh. */
+static void sculpt_vertex_order_calc(Mesh *me, int *r_vert_order)
+{
+  const int looptris_num = poly_to_tri_count(me->totpoly, me->totloop);
+  MLoopTri *looptri = MEM_malloc_arrayN(looptris_num, sizeof(*looptri), __func__);
+  BKE_mesh_recalc_looptri(me->mloop, me->mpoly, me->mvert, me->totloop, me->totpoly, looptri);
+
+  /* Build the same tree as sculpt mode does, the leaves only depend on the face positions. */
+  PBVH *pbvh = BKE_pbvh_new();
+  BKE_pbvh_build_mesh(pbvh,
+                      me,
+                      me->mpoly,
+                      me->mloop,
+                      me->mvert,
+                      me->totvert,
+                      &me->vdata,
+                      &me->ldata,
+                      &me->pdata,
+                      looptri,
+                      looptris_num);
+
+  BKE_pbvh_vert_order_by_node(pbvh, r_vert_order);
+  /* Frees the looptris as well. */
+  BKE_pbvh_free(pbvh);
+}
+
+/**
+ * Reorder the vertices of the mesh of \a ob by PBVH leaf node.
+ * Does nothing when the mesh is already reordered or when other data may depend on
+ * the vertex indices (modifiers of any object using the mesh, particles, vertex parents).
+ *
+ * \return true if the mesh was modified.
+ */
+bool BKE_sculpt_vertex_order_optimize(Main *bmain, Object *ob)
+{
+  if (!sculpt_vertex_order_supported(bmain, ob)) {
+    return false;
+  }
+  Mesh *me = ob->data;
+  if (CustomData_get_named_layer_index(
+          &me->vdata, CD_PROP_INT, SCULPT_ORIG_VERT_INDEX_LAYER_NAME) != -1) {
+    return false;
+  }
+
+  int *vert_order = MEM_malloc_arrayN(me->totvert, sizeof(*vert_order), __func__);
+
+  /* Reuse the order of previous sessions. Computing it again from sculpted positions would give
+   * a different order than the one the sculpt undo steps were recorded with. */
+  const int *order_index = CustomData_get_layer_named(
+      &me->vdata, CD_PROP_INT, SCULPT_VERT_ORDER_LAYER_NAME);
+  if (order_index == NULL ||
+      !sculpt_vertex_order_layer_invert(order_index, me->totvert, vert_order)) {
+    sculpt_vertex_order_layer_free(me, SCULPT_VERT_ORDER_LAYER_NAME);
+    sculpt_vertex_order_calc(me, vert_order);
+
+    int *new_order_index = CustomData_add_layer_named(
+        &me->vdata, CD_PROP_INT, CD_CALLOC, NULL, me->totvert, SCULPT_VERT_ORDER_LAYER_NAME);
+    for (int i = 0; i < me->totvert; i++) {
+      new_order_index[vert_order[i]] = i;
+    }
+  }
+
+  bool is_identity = true;
+  for (int i = 0; i < me->totvert; i++) {
+    if (vert_order[i] != i) {
+      is_identity = false;
+      break;
+    }
+  }
+
+  if (!is_identity) {
+    int *orig_index = CustomData_add_layer_named(
+        &me->vdata, CD_PROP_INT, CD_CALLOC, NULL, me->totvert, SCULPT_ORIG_VERT_INDEX_LAYER_NAME);
+    for (int i = 0; i < me->totvert; i++) {
+      orig_index[i] = i;
+    }
+    /* The layer is reordered along with the vertices, so it maps each vertex to its
+     * original index afterwards. */
+    BKE_mesh_vert_reorder(me, (const uint *)vert_order);
+    DEG_id_tag_update(&me->id, ID_RECALC_GEOMETRY);
+  }
+
+  MEM_freeN(vert_order);
+  return !is_identity;
+}
+
+/**
+ * Restore the vertex order of a mesh reordered by #BKE_sculpt_vertex_order_optimize.
+ *
+ * \return true if the mesh was modified.
+ */
+bool BKE_sculpt_vertex_order_restore(Mesh *me)
+{
+  const int layer_index = CustomData_get_named_layer_index(
+      &me->vdata, CD_PROP_INT, SCULPT_ORIG_VERT_INDEX_LAYER_NAME);
+  if (layer_index == -1) {
+    return false;
+  }
+
+  /* Only restore a valid permutation. The order layer is reordered along with the vertices and
+   * stays, for the next time sculpt mode is entered. */
+  const int *orig_index = me->vdata.layers[layer_index].data;
+  int *vert_order = MEM_malloc_arrayN(me->totvert, sizeof(*vert_order), __func__);
+  if (sculpt_vertex_order_layer_invert(orig_index, me->totvert, vert_order)) {
+    BKE_mesh_vert_reorder(me, (const uint *)vert_order);
+  }
+  MEM_freeN(vert_order);
+
+  sculpt_vertex_order_layer_free(me, SCULPT_ORIG_VERT_INDEX_LAYER_NAME);
+  DEG_id_tag_update(&me->id, ID_RECALC_GEOMETRY);
+  return true;
+}
+
+/** \} */
@@ -48,6 +48,7 @@
 #include "pbvh_intern.h"
 
 #include <limits.h>
+#include <stdlib.h>
 
 #define LEAF_LIMIT 10000
 
@@ -280,6 +281,13 @@ static int map_insert_vert(
   }
 }
 
+static int vert_index_cmp(const void *a_p, const void *b_p)
+{
+  const int a = *(const int *)a_p;
+  const int b = *(const int *)b_p;
+  return (a > b) - (a < b);
+}
+
 /* Find vertices used by the faces in this node and update the draw buffers */
 static void build_mesh_leaf_node(PBVH *bvh, PBVHNode *node)
 {
@@ -330,6 +338,21 @@ static void build_mesh_leaf_node(PBVH *bvh, PBVHNode *node)
     vert_indices[ndx] = POINTER_AS_INT(BLI_ghashIterator_getKey(&gh_iter));
   }
 
+  /* Sort the unique and the shared vertices by index, so iterating over the node walks
+   * the vertex arrays in memory order instead of hash order. */
+  const int totvert = node->uniq_verts + node->face_verts;
+  qsort(vert_indices, node->uniq_verts, sizeof(int), vert_index_cmp);
+  qsort(vert_indices + node->uniq_verts, node->face_verts, sizeof(int), vert_index_cmp);
+
+  int *vert_remap = MEM_mallocN(sizeof(int) * totvert, __func__);
+  for (int i = 0; i < totvert; i++) {
+    int ndx = POINTER_AS_INT(BLI_ghash_lookup(map, POINTER_FROM_INT(vert_indices[i])));
+    if (ndx < 0) {
+      ndx = -ndx + node->uniq_verts - 1;
+    }
+    vert_remap[ndx] = i;
+  }
+
   for (int i = 0; i < totface; i++) {
     const int sides = 3;
 
@@ -337,9 +360,12 @@ static void build_mesh_leaf_node(PBVH *bvh, PBVHNode *node)
       if (face_vert_indices[i][j] < 0) {
         face_vert_indices[i][j] = -face_vert_indices[i][j] + node->uniq_verts - 1;
       }
+      face_vert_indices[i][j] = vert_remap[face_vert_indices[i][j]];
     }
   }
 
+  MEM_freeN(vert_remap);
+
   BKE_pbvh_node_mark_rebuild_draw(node);
 
   BKE_pbvh_node_fully_hidden_set(node, !has_visible);
@@ -621,6 +647,50 @@ void BKE_pbvh_build_mesh(PBVH *bvh,
   MEM_freeN(bvh->vert_bitmap);
 }
 
+/**
+ * Fill \a r_vert_order (of size totvert) with the vertex indices of a mesh PBVH, ordered
+ * by leaf node. Reordering the mesh vertices this way makes the unique vertices of every
+ * node a contiguous range, so brushes access memory sequentially instead of gathering
+ * vertices from the whole mesh. Vertices not used by any face are put at the end.
+ */
+void BKE_pbvh_vert_order_by_node(PBVH *bvh, int *r_vert_order)
+{
+  BLI_assert(bvh->type == PBVH_FACES);
+
+  BLI_bitmap *vert_used = BLI_BITMAP_NEW(bvh->totvert, __func__);
+  int vert_order_len = 0;
+
+  /* Visit the leaves depth first, so consecutive leaves are close in space too. */
+  int *stack = MEM_mallocN(sizeof(int) * max_ii(bvh->totnode, 1), __func__);
+  int stack_len = 0;
+  if (bvh->totnode > 0) {
+    stack[stack_len++] = 0;
+  }
+  while (stack_len > 0) {
+    PBVHNode *node = &bvh->nodes[stack[--stack_len]];
+    if (!(node->flag & PBVH_Leaf)) {
+      stack[stack_len++] = node->children_offset + 1;
+      stack[stack_len++] = node->children_offset;
+      continue;
+    }
+    for (int i = 0; i < node->uniq_verts; i++) {
+      const int v = node->vert_indices[i];
+      BLI_BITMAP_ENABLE(vert_used, v);
+      r_vert_order[vert_order_len++] = v;
+    }
+  }
+  MEM_freeN(stack);
+
+  for (int v = 0; v < bvh->totvert; v++) {
+    if (!BLI_BITMAP_TEST(vert_used, v)) {
+      r_vert_order[vert_order_len++] = v;
+    }
+  }
+  BLI_assert(vert_order_len == bvh->totvert);
+
+  MEM_freeN(vert_used);
+}
+
 /* Do a full rebuild with on Grids data structure */
 void BKE_pbvh_build_grids(PBVH *bvh,
                           CCGElem **grids,
@@ -26,6 +26,8 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "atomic_ops.h"
+
 #include "DNA_scene_types.h"
 #include "DNA_sequence_types.h"
 #include "DNA_space_types.h" /* for FILE_MAX. */
@@ -42,6 +44,7 @@
 #include "BLI_listbase.h"
 #include "BLI_mempool.h"
 #include "BLI_path_util.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 
 #include "BKE_global.h"
@@ -49,6 +52,15 @@
 #include "BKE_scene.h"
 #include "BKE_sequencer.h"
 
+#ifdef WITH_LZO
+#  ifdef WITH_SYSTEM_LZO
+#    include <lzo/lzo1x.h>
+#  else
+#    include "minilzo.h"
+#  endif
+#  define LZO_OUT_LEN(size) ((size) + (size) / 16 + 64 + 3)
+#endif
+
 /**
  * Sequencer Cache Design Notes
  * ============================
@@ -81,24 +93,41 @@
  * For each cached non-temp image, image data and supplementary info are written to HDD.
  * Multiple(DCACHE_IMAGES_PER_FILE) images share the same file.
  * Each of these files contains header DiskCacheHeader followed by image data.
- * Zlib compression with user definable level can be used to compress image data(per image)
- * Images are written in order in which they are rendered.
+ * Compression method is stored per image. Low compression uses LZO when available, high
+ * compression uses zlib. With no compression, image data is copied to file as is.
+ * Images are written in order in which they are rendered, by a background thread.
+ * Rendering is not blocked by writes unless DCACHE_WRITE_QUEUE_MAX images are pending.
  * Overwriting of individual entry is not possible.
  * Stored images are deleted by invalidation, or when size of all files exceeds maximum
  * size specified in user preferences.
  * To distinguish 2 blend files with same name, scene->ed->disk_cache_timestamp
  * is used as UID. Blend file can still be copied manually which may cause conflict.
  *
+ * List of cache files with their size and modification time is stored in index file
+ * (DCACHE_INDEX_FNAME) in cache directory, so the directory doesn't have to be traversed
+ * each time disk cache is created. If the index is missing or outdated, directory is scanned.
+ *
  */
 
 /* <cache type>-<resolution X>x<resolution Y>-<rendersize>%(<view_id>)-<frame no>.dcf */
 #define DCACHE_FNAME_FORMAT "%d-%dx%d-%d%%(%d)-%d.dcf"
 #define DCACHE_IMAGES_PER_FILE 100
-#define DCACHE_CURRENT_VERSION 1
+#define DCACHE_CURRENT_VERSION 2
+#define DCACHE_INDEX_FNAME "cache_index"
+#define DCACHE_INDEX_SAVE_INTERVAL 32
+#define DCACHE_WRITE_QUEUE_MAX 16
 #define COLORSPACE_NAME_MAX 64 /* XXX: defined in imb intern */
 
+/* DiskCacheHeaderEntry.compression */
+enum {
+  DCACHE_COMPRESSION_NONE = 0,
+  DCACHE_COMPRESSION_ZLIB = 1,
+  DCACHE_COMPRESSION_LZO = 2,
+};
+
 typedef struct DiskCacheHeaderEntry {
   unsigned char encoding;
+  unsigned char compression;
   uint64_t frameno;
   uint64_t size_compressed;
   uint64_t size_raw;
@@ -116,8 +145,19 @@ typedef struct SeqDiskCache {
   ListBase files;
   ThreadMutex read_write_mutex;
   size_t size_total;
+  /* Background writer. Pool is created on first write and freed when queue is flushed. */
+  TaskPool *write_pool;
+  ThreadMutex write_pool_mutex;
+  unsigned int write_queue_len;
+  int writes_since_index_save;
 } SeqDiskCache;
 
+typedef struct DiskCacheWriteJob {
+  char path[FILE_MAX];
+  float nfra;
+  ImBuf *ibuf;
+} DiskCacheWriteJob;
+
 typedef struct DiskCacheFile {
   struct DiskCacheFile *next, *prev;
   char path[FILE_MAX];
@@ -138,7 +178,8 @@ typedef struct SeqCache {
   ThreadMutex iterator_mutex;
   struct BLI_mempool *keys_pool;
   struct BLI_mempool *items_pool;
-  struct SeqCacheKey *last_key;
+  /* Last key put by each task, to link intermediate items of the frame it renders. */
+  struct SeqCacheKey *last_key[SEQ_TASK_MAX];
   size_t memory_used;
   SeqDiskCache *disk_cache;
 } SeqCache;
@@ -166,24 +207,34 @@ typedef struct SeqCacheKey {
 static ThreadMutex cache_create_lock = BLI_MUTEX_INITIALIZER;
 static float seq_cache_cfra_to_frame_index(Sequence *seq, float cfra);
 static float seq_cache_frame_index_to_cfra(Sequence *seq, float nfra);
+static void seq_disk_cache_write_queue_flush(SeqDiskCache *disk_cache);
 
 static char *seq_disk_cache_base_dir(void)
 {
   return U.sequencer_disk_cache_dir;
 }
 
-static int seq_disk_cache_compression_level(void)
+/* Returns compression method, zlib compression level is stored in r_level. */
+static int seq_disk_cache_compression_get(int *r_level)
 {
   switch (U.sequencer_disk_cache_compression) {
     case USER_SEQ_DISK_CACHE_COMPRESSION_NONE:
-      return 0;
+      *r_level = 0;
+      return DCACHE_COMPRESSION_NONE;
     case USER_SEQ_DISK_CACHE_COMPRESSION_LOW:
-      return 1;
+      *r_level = 1;
+#ifdef WITH_LZO
+      return DCACHE_COMPRESSION_LZO;
+#else
+      return DCACHE_COMPRESSION_ZLIB;
+#endif
     case USER_SEQ_DISK_CACHE_COMPRESSION_HIGH:
-      return 9;
+      *r_level = 9;
+      return DCACHE_COMPRESSION_ZLIB;
   }
 
-  return U.sequencer_disk_cache_compression;
+  *r_level = U.sequencer_disk_cache_compression;
+  return DCACHE_COMPRESSION_ZLIB;
 }
 
 static size_t seq_disk_cache_size_limit(void)
@@ -224,7 +275,6 @@ static void seq_disk_cache_get_files(SeqDiskCache *disk_cache, char *path)
 {
   struct direntry *filelist, *fl;
   uint nbr, i;
-  disk_cache->size_total = 0;
 
   i = nbr = BLI_filelist_dir_contents(path, &filelist);
   fl = filelist;
@@ -260,6 +310,93 @@ static void seq_disk_cache_get_files(SeqDiskCache *disk_cache, char *path)
   BLI_filelist_free(filelist, nbr);
 }
 
+static void seq_disk_cache_scan_files(SeqDiskCache *disk_cache)
+{
+  BLI_freelistN(&disk_cache->files);
+  disk_cache->size_total = 0;
+  seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
+}
+
+static void seq_disk_cache_get_index_path(char *path, size_t path_len)
+{
+  BLI_join_dirfile(path, path_len, seq_disk_cache_base_dir(), DCACHE_INDEX_FNAME);
+}
+
+/* Index file format: version on first line, then `<size> <mtime> <path>` for each file. */
+static bool seq_disk_cache_index_read(SeqDiskCache *disk_cache)
+{
+  char path[FILE_MAX];
+  seq_disk_cache_get_index_path(path, sizeof(path));
+
+  FILE *file = BLI_fopen(path, "r");
+  if (!file) {
+    return false;
+  }
+
+  int version = 0;
+  if (fscanf(file, "%d\n", &version) != 1 || version != DCACHE_CURRENT_VERSION) {
+    fclose(file);
+    return false;
+  }
+
+  char line[FILE_MAX + 64];
+  while (fgets(line, sizeof(line), file)) {
+    int64_t size, mtime;
+    int path_start = 0;
+
+    if (sscanf(line, "%" SCNd64 " %" SCNd64 " %n", &size, &mtime, &path_start) != 2 ||
+        path_start == 0) {
+      continue;
+    }
+
+    char *file_path = line + path_start;
+    file_path[strcspn(file_path, "\r\n")] = '\0';
+    if (file_path[0] == '\0') {
+      continue;
+    }
+
+    DiskCacheFile *cache_file = seq_disk_cache_add_file_to_list(disk_cache, file_path);
+    cache_file->fstat.st_size = size;
+    cache_file->fstat.st_mtime = mtime;
+    disk_cache->size_total += size;
+  }
+
+  fclose(file);
+  return true;
+}
+
+/* Write to temporary file first, so interrupted write doesn't leave broken index behind. */
+static void seq_disk_cache_index_write(SeqDiskCache *disk_cache)
+{
+  char path[FILE_MAX];
+  char path_temp[FILE_MAX];
+
+  if (seq_disk_cache_base_dir()[0] == '\0') {
+    return;
+  }
+
+  seq_disk_cache_get_index_path(path, sizeof(path));
+  BLI_snprintf(path_temp, sizeof(path_temp), "%s.tmp", path);
+  BLI_make_existing_file(path_temp);
+
+  FILE *file = BLI_fopen(path_temp, "w");
+  if (!file) {
+    return;
+  }
+
+  fprintf(file, "%d\n", DCACHE_CURRENT_VERSION);
+  LISTBASE_FOREACH (DiskCacheFile *, cache_file, &disk_cache->files) {
+    fprintf(file,
+            "%" PRId64 " %" PRId64 " %s\n",
+            (int64_t)cache_file->fstat.st_size,
+            (int64_t)cache_file->fstat.st_mtime,
+            cache_file->path);
+  }
+  fclose(file);
+
+  BLI_rename(path_temp, path);
+}
+
 static DiskCacheFile *seq_disk_cache_get_oldest_file(SeqDiskCache *disk_cache)
 {
   DiskCacheFile *oldest_file = disk_cache->files.first;
@@ -291,14 +428,17 @@ static bool seq_disk_cache_enforce_limits(SeqDiskCache *disk_cache)
 
     if (!oldest_file) {
       /* We shouldn't enforce limits with no files, do re-scan. */
-      seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
+      seq_disk_cache_scan_files(disk_cache);
+      if (disk_cache->files.first == NULL) {
+        break;
+      }
       continue;
     }
 
     if (BLI_exists(oldest_file->path) == 0) {
-      /* File may have been manually deleted during runtime, do re-scan. */
-      BLI_freelistN(&disk_cache->files);
-      seq_disk_cache_get_files(disk_cache, seq_disk_cache_base_dir());
+      /* File may have been manually deleted during runtime or index may be outdated,
+       * do re-scan. */
+      seq_disk_cache_scan_files(disk_cache);
       continue;
     }
 
@@ -309,7 +449,8 @@ static bool seq_disk_cache_enforce_limits(SeqDiskCache *disk_cache)
   return true;
 }
 
-static DiskCacheFile *seq_disk_cache_get_file_entry_by_path(SeqDiskCache *disk_cache, char *path)
+static DiskCacheFile *seq_disk_cache_get_file_entry_by_path(SeqDiskCache *disk_cache,
+                                                            const char *path)
 {
   DiskCacheFile *cache_file = disk_cache->files.first;
 
@@ -323,13 +464,17 @@ static DiskCacheFile *seq_disk_cache_get_file_entry_by_path(SeqDiskCache *disk_c
 }
 
 /* Update file size and timestamp. */
-static void seq_disk_cache_update_file(SeqDiskCache *disk_cache, char *path)
+static void seq_disk_cache_update_file(SeqDiskCache *disk_cache, const char *path)
 {
   DiskCacheFile *cache_file;
   int64_t size_before;
   int64_t size_after;
 
   cache_file = seq_disk_cache_get_file_entry_by_path(disk_cache, path);
+  if (cache_file == NULL) {
+    /* File was created after index was written. */
+    cache_file = seq_disk_cache_add_file_to_list(disk_cache, path);
+  }
   size_before = cache_file->fstat.st_size;
 
   if (BLI_stat(path, &cache_file->fstat) == -1) {
@@ -401,7 +546,8 @@ static void seq_disk_cache_create_version_file(char *path)
   }
 }
 
-static void seq_disk_cache_handle_versioning(SeqDiskCache *disk_cache)
+/* Returns true if outdated cache files were deleted. */
+static bool seq_disk_cache_handle_versioning(SeqDiskCache *disk_cache)
 {
   char path[FILE_MAX];
   char path_version_file[FILE_MAX];
@@ -422,11 +568,14 @@ static void seq_disk_cache_handle_versioning(SeqDiskCache *disk_cache)
     if (version != DCACHE_CURRENT_VERSION) {
       BLI_delete(path, false, true);
       seq_disk_cache_create_version_file(path_version_file);
+      return true;
     }
   }
   else {
     seq_disk_cache_create_version_file(path_version_file);
   }
+
+  return false;
 }
 
 static void seq_disk_cache_delete_invalid_files(SeqDiskCache *disk_cache,
@@ -464,6 +613,9 @@ static void seq_disk_cache_invalidate(Scene *scene,
   int end;
   SeqDiskCache *disk_cache = scene->ed->cache->disk_cache;
 
+  /* Pending writes may belong to invalidated range. */
+  seq_disk_cache_write_queue_flush(disk_cache);
+
   BLI_mutex_lock(&disk_cache->read_write_mutex);
 
   start = seq_changed->startdisp - DCACHE_IMAGES_PER_FILE;
@@ -474,31 +626,109 @@ static void seq_disk_cache_invalidate(Scene *scene,
   BLI_mutex_unlock(&disk_cache->read_write_mutex);
 }
 
+static size_t write_mem_to_file_at_pos(const void *buf, size_t len, FILE *file, size_t offset)
+{
+  fseek(file, offset, 0);
+  return fwrite(buf, 1, len, file);
+}
+
+static size_t read_file_to_mem_at_pos(void *buf, size_t len, FILE *file, size_t offset)
+{
+  fseek(file, offset, 0);
+  return fread(buf, 1, len, file);
+}
+
+#ifdef WITH_LZO
+/* Returns 0 if data is not compressible, so it can be stored uncompressed. */
+static size_t lzo_mem_to_file_at_pos(const void *buf, size_t len, FILE *file, size_t offset)
+{
+  lzo_uint out_len = LZO_OUT_LEN(len);
+  unsigned char *out = MEM_mallocN(out_len, "seq disk cache lzo buffer");
+  void *wrkmem = MEM_mallocN(LZO1X_MEM_COMPRESS, "seq disk cache lzo wrkmem");
+  size_t bytes_written = 0;
+
+  int r = lzo1x_1_compress(buf, (lzo_uint)len, out, &out_len, wrkmem);
+  if (r == LZO_E_OK && out_len < len) {
+    bytes_written = write_mem_to_file_at_pos(out, out_len, file, offset);
+  }
+
+  MEM_freeN(wrkmem);
+  MEM_freeN(out);
+  return bytes_written;
+}
+
+static size_t lzo_file_to_mem_at_pos(
+    void *buf, size_t len, FILE *file, size_t offset, size_t len_compressed)
+{
+  if (len_compressed > LZO_OUT_LEN(len)) {
+    return 0;
+  }
+
+  unsigned char *in = MEM_mallocN(len_compressed, "seq disk cache lzo buffer");
+  size_t bytes_read = 0;
+
+  if (read_file_to_mem_at_pos(in, len_compressed, file, offset) == len_compressed) {
+    lzo_uint out_len = len;
+    int r = lzo1x_decompress_safe(in, (lzo_uint)len_compressed, buf, &out_len, NULL);
+    if (r == LZO_E_OK) {
+      bytes_read = out_len;
+    }
+  }
+
+  MEM_freeN(in);
+  return bytes_read;
+}
+#endif
+
 static size_t deflate_imbuf_to_file(ImBuf *ibuf,
                                     FILE *file,
                                     int level,
                                     DiskCacheHeaderEntry *header_entry)
 {
-  if (ibuf->rect) {
-    return BLI_gzip_mem_to_file_at_pos(
-        ibuf->rect, header_entry->size_raw, file, header_entry->offset, level);
-  }
-  else {
-    return BLI_gzip_mem_to_file_at_pos(
-        ibuf->rect_float, header_entry->size_raw, file, header_entry->offset, level);
+  void *data = ibuf->rect ? (void *)ibuf->rect : (void *)ibuf->rect_float;
+
+  switch (header_entry->compression) {
+    case DCACHE_COMPRESSION_ZLIB:
+      return BLI_gzip_mem_to_file_at_pos(
+          data, header_entry->size_raw, file, header_entry->offset, level);
+#ifdef WITH_LZO
+    case DCACHE_COMPRESSION_LZO: {
+      size_t bytes_written = lzo_mem_to_file_at_pos(
+          data, header_entry->size_raw, file, header_entry->offset);
+      if (bytes_written != 0) {
+        return bytes_written;
+      }
+      break;
+    }
+#endif
   }
+
+  header_entry->compression = DCACHE_COMPRESSION_NONE;
+  return write_mem_to_file_at_pos(data, header_entry->size_raw, file, header_entry->offset);
 }
 
 static size_t inflate_file_to_imbuf(ImBuf *ibuf, FILE *file, DiskCacheHeaderEntry *header_entry)
 {
-  if (ibuf->rect) {
-    return BLI_ungzip_file_to_mem_at_pos(
-        ibuf->rect, header_entry->size_raw, file, header_entry->offset);
-  }
-  else {
-    return BLI_ungzip_file_to_mem_at_pos(
-        ibuf->rect_float, header_entry->size_raw, file, header_entry->offset);
-  }
+  void *data = ibuf->rect ? (void *)ibuf->rect : (void *)ibuf->rect_float;
+
+  switch (header_entry->compression) {
+    case DCACHE_COMPRESSION_NONE:
+      return read_file_to_mem_at_pos(data, header_entry->size_raw, file, header_entry->offset);
+    case DCACHE_COMPRESSION_ZLIB:
+      return BLI_ungzip_file_to_mem_at_pos(
+          data, header_entry->size_raw, file, header_entry->offset);
+#ifdef WITH_LZO
+    case DCACHE_COMPRESSION_LZO:
+      return lzo_file_to_mem_at_pos(data,
+                                    header_entry->size_raw,
+                                    file,
+                                    header_entry->offset,
+                                    header_entry->size_compressed);
+#endif
+  }
+
+  /* Compressed by method, that is not available in this build. */
+  return 0;
 }
 
 static void seq_disk_cache_read_header(FILE *file, DiskCacheHeader *header)
@@ -522,7 +752,7 @@ static size_t seq_disk_cache_write_header(FILE *file, DiskCacheHeader *header)
   return fwrite(header, sizeof(*header), 1, file);
 }
 
-static int seq_disk_cache_add_header_entry(SeqCacheKey *key, ImBuf *ibuf, DiskCacheHeader *header)
+static int seq_disk_cache_add_header_entry(float nfra, ImBuf *ibuf, DiskCacheHeader *header)
 {
   int i;
   uint64_t offset = sizeof(*header);
@@ -555,7 +785,7 @@ static int seq_disk_cache_add_header_entry(SeqCacheKey *key, ImBuf *ibuf, DiskCa
   }
 
   header->entry[i].offset = offset;
-  header->entry[i].frameno = key->nfra;
+  header->entry[i].frameno = nfra;
 
   /* Store colorspace name of ibuf. */
   const char *colorspace_name;
@@ -584,11 +814,11 @@ static int seq_disk_cache_get_header_entry(SeqCacheKey *key, DiskCacheHeader *he
   return -1;
 }
 
-static bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf)
+static bool seq_disk_cache_write_file(SeqDiskCache *disk_cache,
+                                      const char *path,
+                                      float nfra,
+                                      ImBuf *ibuf)
 {
-  char path[FILE_MAX];
-
-  seq_disk_cache_get_file_path(disk_cache, key, path, sizeof(path));
   BLI_make_existing_file(path);
 
   FILE *file = BLI_fopen(path, "rb+");
@@ -603,9 +833,10 @@ static bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key
   DiskCacheHeader header;
   memset(&header, 0, sizeof(header));
   seq_disk_cache_read_header(file, &header);
-  int entry_index = seq_disk_cache_add_header_entry(key, ibuf, &header);
-  size_t bytes_written = deflate_imbuf_to_file(
-      ibuf, file, seq_disk_cache_compression_level(), &header.entry[entry_index]);
+  int entry_index = seq_disk_cache_add_header_entry(nfra, ibuf, &header);
+  int level;
+  header.entry[entry_index].compression = seq_disk_cache_compression_get(&level);
+  size_t bytes_written = deflate_imbuf_to_file(ibuf, file, level, &header.entry[entry_index]);
 
   if (bytes_written != 0) {
     /* Last step is writing header, as image data can be overwritten,
@@ -613,15 +844,79 @@ static bool seq_disk_cache_write_file(SeqDiskCache *disk_cache, SeqCacheKey *key
      */
     header.entry[entry_index].size_compressed = bytes_written;
     seq_disk_cache_write_header(file, &header);
-    seq_disk_cache_update_file(disk_cache, path);
     fclose(file);
+    seq_disk_cache_update_file(disk_cache, path);
 
     return true;
   }
 
+  fclose(file);
   return false;
 }
 
+static void seq_disk_cache_write_job_run(SeqDiskCache *disk_cache, DiskCacheWriteJob *job)
+{
+  BLI_mutex_lock(&disk_cache->read_write_mutex);
+  seq_disk_cache_write_file(disk_cache, job->path, job->nfra, job->ibuf);
+  if (++disk_cache->writes_since_index_save >= DCACHE_INDEX_SAVE_INTERVAL) {
+    disk_cache->writes_since_index_save = 0;
+    seq_disk_cache_index_write(disk_cache);
+  }
+  BLI_mutex_unlock(&disk_cache->read_write_mutex);
+  seq_disk_cache_enforce_limits(disk_cache);
+}
+
+static void seq_disk_cache_write_task(TaskPool *__restrict pool, void *taskdata)
+{
+  SeqDiskCache *disk_cache = BLI_task_pool_user_data(pool);
+  DiskCacheWriteJob *job = taskdata;
+
+  seq_disk_cache_write_job_run(disk_cache, job);
+  IMB_freeImBuf(job->ibuf);
+  atomic_sub_and_fetch_u(&disk_cache->write_queue_len, 1);
+}
+
+/* Key and sequence may be freed before job is executed, so everything needed to write image is
+ * copied to job. Image is referenced until it is written. */
+static void seq_disk_cache_write_async(SeqDiskCache *disk_cache, SeqCacheKey *key, ImBuf *ibuf)
+{
+  DiskCacheWriteJob *job = MEM_mallocN(sizeof(DiskCacheWriteJob), "DiskCacheWriteJob");
+  seq_disk_cache_get_file_path(disk_cache, key, job->path, sizeof(job->path));
+  job->nfra = key->nfra;
+  job->ibuf = ibuf;
+
+  /* Queue is full, write on this thread, so rendering can't run ahead of storage. */
+  if (atomic_add_and_fetch_u(&disk_cache->write_queue_len, 1) > DCACHE_WRITE_QUEUE_MAX) {
+    seq_disk_cache_write_job_run(disk_cache, job);
+    atomic_sub_and_fetch_u(&disk_cache->write_queue_len, 1);
+    MEM_freeN(job);
+    return;
+  }
+
+  IMB_refImBuf(ibuf);
+
+  BLI_mutex_lock(&disk_cache->write_pool_mutex);
+  if (disk_cache->write_pool == NULL) {
+    disk_cache->write_pool = BLI_task_pool_create_background_serial(disk_cache,
+                                                                    TASK_PRIORITY_LOW);
+  }
+  BLI_task_pool_push(disk_cache->write_pool, seq_disk_cache_write_task, job, true, NULL);
+  BLI_mutex_unlock(&disk_cache->write_pool_mutex);
+}
+
+/* Wait for all pending writes. Pool is freed, because background thread of serial pool is not
+ * restarted once it has been waited for. */
+static void seq_disk_cache_write_queue_flush(SeqDiskCache *disk_cache)
+{
+  BLI_mutex_lock(&disk_cache->write_pool_mutex);
+  if (disk_cache->write_pool != NULL) {
+    BLI_task_pool_work_and_wait(disk_cache->write_pool);
+    BLI_task_pool_free(disk_cache->write_pool);
+    disk_cache->write_pool = NULL;
+  }
+  BLI_mutex_unlock(&disk_cache->write_pool_mutex);
+}
+
 static ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *key)
 {
   char path[FILE_MAX];
@@ -683,6 +978,9 @@ static ImBuf *seq_disk_cache_read_file(SeqDiskCache *disk_cache, SeqCacheKey *ke
 #undef DCACHE_IMAGES_PER_FILE
 #undef COLORSPACE_NAME_MAX
 #undef DCACHE_CURRENT_VERSION
+#undef DCACHE_INDEX_FNAME
+#undef DCACHE_INDEX_SAVE_INTERVAL
+#undef DCACHE_WRITE_QUEUE_MAX
 
 static bool seq_cmp_render_data(const SeqRenderData *a, const SeqRenderData *b)
 {
@@ -789,6 +1087,13 @@ static void seq_cache_valfree(void *val)
   BLI_mempool_free(item->cache_owner->items_pool, item);
 }
 
+static void seq_cache_clear_last_keys(SeqCache *cache)
+{
+  for (int i = 0; i < SEQ_TASK_MAX; i++) {
+    cache->last_key[i] = NULL;
+  }
+}
+
 static void seq_cache_put(SeqCache *cache, SeqCacheKey *key, ImBuf *ibuf)
 {
   SeqCacheItem *item;
@@ -798,7 +1103,7 @@ static void seq_cache_put(SeqCache *cache, SeqCacheKey *key, ImBuf *ibuf)
 
   if (BLI_ghash_reinsert(cache->hash, key, item, seq_cache_keyfree, seq_cache_valfree)) {
     IMB_refImBuf(ibuf);
-    cache->last_key = key;
+    cache->last_key[key->task_id] = key;
     cache->memory_used += IMB_get_size_in_memory(ibuf);
   }
 }
@@ -1037,19 +1342,19 @@ static void seq_disk_cache_create(Main *bmain, Scene *scene)
   BLI_mutex_lock(&cache_create_lock);
   SeqCache *cache = seq_cache_get_from_scene(scene);
 
-  if (cache == NULL) {
-    return;
-  }
-
-  if (cache->disk_cache != NULL) {
+  if (cache == NULL || cache->disk_cache != NULL) {
+    BLI_mutex_unlock(&cache_create_lock);
     return;
   }
 
   cache->disk_cache = MEM_callocN(sizeof(SeqDiskCache), "SeqDiskCache");
   cache->disk_cache->bmain = bmain;
   BLI_mutex_init(&cache->disk_cache->read_write_mutex);
-  seq_disk_cache_handle_versioning(cache->disk_cache);
-  seq_disk_cache_get_files(cache->disk_cache, seq_disk_cache_base_dir());
+  BLI_mutex_init(&cache->disk_cache->write_pool_mutex);
+  if (seq_disk_cache_handle_versioning(cache->disk_cache) ||
+      !seq_disk_cache_index_read(cache->disk_cache)) {
+    seq_disk_cache_scan_files(cache->disk_cache);
+  }
   cache->disk_cache->timestamp = scene->ed->disk_cache_timestamp;
   BLI_mutex_unlock(&cache_create_lock);
 }
@@ -1062,7 +1367,7 @@ static void seq_cache_create(Main *bmain, Scene *scene)
     cache->keys_pool = BLI_mempool_create(sizeof(SeqCacheKey), 0, 64, BLI_MEMPOOL_NOP);
     cache->items_pool = BLI_mempool_create(sizeof(SeqCacheItem), 0, 64, BLI_MEMPOOL_NOP);
     cache->hash = BLI_ghash_new(seq_cache_hashhash, seq_cache_hashcmp, "SeqCache hash");
-    cache->last_key = NULL;
+    seq_cache_clear_last_keys(cache);
     cache->bmain = bmain;
     BLI_mutex_init(&cache->iterator_mutex);
     scene->ed->cache = cache;
@@ -1112,7 +1417,10 @@ void BKE_sequencer_cache_destruct(Scene *scene)
   BLI_mutex_end(&cache->iterator_mutex);
 
   if (cache->disk_cache != NULL) {
+    seq_disk_cache_write_queue_flush(cache->disk_cache);
+    seq_disk_cache_index_write(cache->disk_cache);
     BLI_freelistN(&cache->disk_cache->files);
+    BLI_mutex_end(&cache->disk_cache->write_pool_mutex);
     BLI_mutex_end(&cache->disk_cache->read_write_mutex);
     MEM_freeN(cache->disk_cache);
   }
@@ -1146,7 +1454,7 @@ void BKE_sequencer_cache_cleanup(Scene *scene)
     BLI_ghashIterator_step(&gh_iter);
     BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
   }
-  cache->last_key = NULL;
+  seq_cache_clear_last_keys(cache);
   seq_cache_unlock(scene);
 }
 
@@ -1210,7 +1518,7 @@ void BKE_sequencer_cache_cleanup_sequence(Scene *scene,
       BLI_ghash_remove(cache->hash, key, seq_cache_keyfree, seq_cache_valfree);
     }
   }
-  cache->last_key = NULL;
+  seq_cache_clear_last_keys(cache);
   seq_cache_unlock(scene);
 }
 
@@ -1305,8 +1613,8 @@ bool BKE_sequencer_cache_put_if_possible(const SeqRenderData *context,
     return true;
   }
   else {
-    seq_cache_set_temp_cache_linked(scene, scene->ed->cache->last_key);
-    scene->ed->cache->last_key = NULL;
+    seq_cache_set_temp_cache_linked(scene, scene->ed->cache->last_key[context->task_id]);
+    scene->ed->cache->last_key[context->task_id] = NULL;
     return false;
   }
 }
@@ -1378,27 +1686,27 @@ void BKE_sequencer_cache_put(const SeqRenderData *context,
   /* Item stored for later use */
   if (flag & type) {
     key->is_temp_cache = false;
-    key->link_prev = cache->last_key;
+    key->link_prev = cache->last_key[key->task_id];
   }
 
-  SeqCacheKey *temp_last_key = cache->last_key;
+  SeqCacheKey *temp_last_key = cache->last_key[key->task_id];
   seq_cache_put(cache, key, i);
 
   /* Restore pointer to previous item as this one will be freed when stack is rendered. */
   if (key->is_temp_cache) {
-    cache->last_key = temp_last_key;
+    cache->last_key[key->task_id] = temp_last_key;
   }
 
   /* Set last_key's reference to this key so we can look up chain backwards.
-   * Item is already put in cache, so cache->last_key points to current key.
+   * Item is already put in cache, so the task's last_key points to current key.
    */
   if (flag & type && temp_last_key) {
-    temp_last_key->link_next = cache->last_key;
+    temp_last_key->link_next = cache->last_key[key->task_id];
   }
 
   /* Reset linking. */
   if (key->type == SEQ_CACHE_STORE_FINAL_OUT) {
-    cache->last_key = NULL;
+    cache->last_key[key->task_id] = NULL;
   }
 
   seq_cache_unlock(scene);
@@ -1409,10 +1717,7 @@ void BKE_sequencer_cache_put(const SeqRenderData *context,
         seq_disk_cache_create(context->bmain, context->scene);
       }
 
-      BLI_mutex_lock(&cache->disk_cache->read_write_mutex);
-      seq_disk_cache_write_file(cache->disk_cache, key, i);
-      BLI_mutex_unlock(&cache->disk_cache->read_write_mutex);
-      seq_disk_cache_enforce_limits(cache->disk_cache);
+      seq_disk_cache_write_async(cache->disk_cache, key, i);
     }
   }
 }
@@ -1441,7 +1746,7 @@ void BKE_sequencer_cache_iterate(
     interrupt = callback_iter(userdata, key->seq, key->nfra, key->type, key->cost);
   }
 
-  cache->last_key = NULL;
+  seq_cache_clear_last_keys(cache);
   seq_cache_unlock(scene);
 }
 
@@ -35,6 +35,7 @@
 #include "BLI_path_util.h"
 #include "BLI_rect.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
@@ -61,6 +62,10 @@
 
 #include "BLF_api.h"
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 static struct SeqEffectHandle get_sequence_effect_impl(int seq_type);
 
 static void slice_get_byte_buffers(const SeqRenderData *context,
@@ -113,6 +118,56 @@ static void slice_get_float_buffers(const SeqRenderData *context,
   }
 }
 
+#ifdef __SSE2__
+/* Same as straight_uchar_to_premul_float(), but result is kept in SSE register. */
+BLI_INLINE __m128 straight_uchar_to_premul_float_sse2(const unsigned char color[4])
+{
+  const __m128i zero = _mm_setzero_si128();
+  __m128i color_i = _mm_cvtsi32_si128(*(const int *)color);
+  color_i = _mm_unpacklo_epi16(_mm_unpacklo_epi8(color_i, zero), zero);
+
+  const float alpha = color[3] * (1.0f / 255.0f);
+  const float fac = alpha * (1.0f / 255.0f);
+  return _mm_mul_ps(_mm_cvtepi32_ps(color_i), _mm_setr_ps(fac, fac, fac, 1.0f / 255.0f));
+}
+
+/* Same as premul_float_to_straight_uchar(), including rounding of unit_float_to_uchar_clamp(). */
+BLI_INLINE void premul_float_to_straight_uchar_sse2(unsigned char *result, __m128 color)
+{
+  const float alpha = _mm_cvtss_f32(_mm_shuffle_ps(color, color, _MM_SHUFFLE(3, 3, 3, 3)));
+  if (alpha != 0.0f && alpha != 1.0f) {
+    const float alpha_inv = 1.0f / alpha;
+    color = _mm_mul_ps(color, _mm_setr_ps(alpha_inv, alpha_inv, alpha_inv, 1.0f));
+  }
+
+  color = _mm_add_ps(_mm_mul_ps(color, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f));
+  color = _mm_min_ps(_mm_max_ps(color, _mm_setzero_ps()), _mm_set1_ps(255.0f));
+
+  __m128i color_i = _mm_cvttps_epi32(color);
+  color_i = _mm_packs_epi32(color_i, color_i);
+  color_i = _mm_packus_epi16(color_i, color_i);
+  *(int *)result = _mm_cvtsi128_si32(color_i);
+}
+
+/* Scale color channels of 4 straight alpha byte pixels by `fac * alpha`:
+ * `((fac * alpha) * c) >> 16` for each channel. `fac` must be in 0..256 range,
+ * so `fac * alpha` fits in 16 bits and the shift is high half of 16 bit product. */
+BLI_INLINE __m128i alpha_scale_uchar_sse2(__m128i color, __m128i fac)
+{
+  const __m128i zero = _mm_setzero_si128();
+  __m128i lo = _mm_unpacklo_epi8(color, zero);
+  __m128i hi = _mm_unpackhi_epi8(color, zero);
+  __m128i alpha_lo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)),
+                                         _MM_SHUFFLE(3, 3, 3, 3));
+  __m128i alpha_hi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)),
+                                         _MM_SHUFFLE(3, 3, 3, 3));
+
+  lo = _mm_mulhi_epu16(_mm_mullo_epi16(alpha_lo, fac), lo);
+  hi = _mm_mulhi_epu16(_mm_mullo_epi16(alpha_hi, fac), hi);
+  return _mm_packus_epi16(lo, hi);
+}
+#endif
+
 /*********************** Glow effect *************************/
 
 enum {
@@ -194,6 +249,42 @@ static void init_alpha_over_or_under(Sequence *seq)
   seq->seq1 = seq2;
 }
 
+BLI_INLINE void alphaover_pixel_byte(float fac,
+                                     const unsigned char *cp1,
+                                     const unsigned char *cp2,
+                                     unsigned char *rt)
+{
+  /* rt = rt1 over rt2  (alpha from rt1) */
+  const float mfac = 1.0f - fac * (cp1[3] * (1.0f / 255.0f));
+
+  if (fac <= 0.0f) {
+    *((unsigned int *)rt) = *((const unsigned int *)cp2);
+  }
+  else if (mfac <= 0.0f) {
+    *((unsigned int *)rt) = *((const unsigned int *)cp1);
+  }
+  else {
+#ifdef __SSE2__
+    const __m128 rt1 = straight_uchar_to_premul_float_sse2(cp1);
+    const __m128 rt2 = straight_uchar_to_premul_float_sse2(cp2);
+    premul_float_to_straight_uchar_sse2(
+        rt, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(fac), rt1), _mm_mul_ps(_mm_set1_ps(mfac), rt2)));
+#else
+    float tempc[4], rt1[4], rt2[4];
+
+    straight_uchar_to_premul_float(rt1, cp1);
+    straight_uchar_to_premul_float(rt2, cp2);
+
+    tempc[0] = fac * rt1[0] + mfac * rt2[0];
+    tempc[1] = fac * rt1[1] + mfac * rt2[1];
+    tempc[2] = fac * rt1[2] + mfac * rt2[2];
+    tempc[3] = fac * rt1[3] + mfac * rt2[3];
+
+    premul_float_to_straight_uchar(rt, tempc);
+#endif
+  }
+}
+
 static void do_alphaover_effect_byte(float facf0,
                                      float facf1,
                                      int x,
@@ -202,44 +293,18 @@ static void do_alphaover_effect_byte(float facf0,
                                      unsigned char *rect2,
                                      unsigned char *out)
 {
-  float fac2, mfac, fac, fac4;
   int xo;
   unsigned char *cp1, *cp2, *rt;
-  float tempc[4], rt1[4], rt2[4];
 
   xo = x;
   cp1 = rect1;
   cp2 = rect2;
   rt = out;
 
-  fac2 = facf0;
-  fac4 = facf1;
-
   while (y--) {
     x = xo;
     while (x--) {
-      /* rt = rt1 over rt2  (alpha from rt1) */
-
-      straight_uchar_to_premul_float(rt1, cp1);
-      straight_uchar_to_premul_float(rt2, cp2);
-
-      fac = fac2;
-      mfac = 1.0f - fac2 * rt1[3];
-
-      if (fac <= 0.0f) {
-        *((unsigned int *)rt) = *((unsigned int *)cp2);
-      }
-      else if (mfac <= 0.0f) {
-        *((unsigned int *)rt) = *((unsigned int *)cp1);
-      }
-      else {
-        tempc[0] = fac * rt1[0] + mfac * rt2[0];
-        tempc[1] = fac * rt1[1] + mfac * rt2[1];
-        tempc[2] = fac * rt1[2] + mfac * rt2[2];
-        tempc[3] = fac * rt1[3] + mfac * rt2[3];
-
-        premul_float_to_straight_uchar(rt, tempc);
-      }
+      alphaover_pixel_byte(facf0, cp1, cp2, rt);
       cp1 += 4;
       cp2 += 4;
       rt += 4;
@@ -252,26 +317,7 @@ static void do_alphaover_effect_byte(float facf0,
 
     x = xo;
     while (x--) {
-      straight_uchar_to_premul_float(rt1, cp1);
-      straight_uchar_to_premul_float(rt2, cp2);
-
-      fac = fac4;
-      mfac = 1.0f - (fac4 * rt1[3]);
-
-      if (fac <= 0.0f) {
-        *((unsigned int *)rt) = *((unsigned int *)cp2);
-      }
-      else if (mfac <= 0.0f) {
-        *((unsigned int *)rt) = *((unsigned int *)cp1);
-      }
-      else {
-        tempc[0] = fac * rt1[0] + mfac * rt2[0];
-        tempc[1] = fac * rt1[1] + mfac * rt2[1];
-        tempc[2] = fac * rt1[2] + mfac * rt2[2];
-        tempc[3] = fac * rt1[3] + mfac * rt2[3];
-
-        premul_float_to_straight_uchar(rt, tempc);
-      }
+      alphaover_pixel_byte(facf1, cp1, cp2, rt);
       cp1 += 4;
       cp2 += 4;
       rt += 4;
@@ -279,10 +325,34 @@ static void do_alphaover_effect_byte(float facf0,
   }
 }
 
+BLI_INLINE void alphaover_pixel_float(float fac, const float *rt1, const float *rt2, float *rt)
+{
+  /* rt = rt1 over rt2  (alpha from rt1) */
+  const float mfac = 1.0f - (fac * rt1[3]);
+
+  if (fac <= 0.0f) {
+    memcpy(rt, rt2, 4 * sizeof(float));
+  }
+  else if (mfac <= 0.0f) {
+    memcpy(rt, rt1, 4 * sizeof(float));
+  }
+  else {
+#ifdef __SSE2__
+    _mm_storeu_ps(rt,
+                  _mm_add_ps(_mm_mul_ps(_mm_set1_ps(fac), _mm_loadu_ps(rt1)),
+                             _mm_mul_ps(_mm_set1_ps(mfac), _mm_loadu_ps(rt2))));
+#else
+    rt[0] = fac * rt1[0] + mfac * rt2[0];
+    rt[1] = fac * rt1[1] + mfac * rt2[1];
+    rt[2] = fac * rt1[2] + mfac * rt2[2];
+    rt[3] = fac * rt1[3] + mfac * rt2[3];
+#endif
+  }
+}
+
 static void do_alphaover_effect_float(
     float facf0, float facf1, int x, int y, float *rect1, float *rect2, float *out)
 {
-  float fac2, mfac, fac, fac4;
   int xo;
   float *rt1, *rt2, *rt;
 
@@ -291,29 +361,10 @@ static void do_alphaover_effect_float(
   rt2 = rect2;
   rt = out;
 
-  fac2 = facf0;
-  fac4 = facf1;
-
   while (y--) {
     x = xo;
     while (x--) {
-      /* rt = rt1 over rt2  (alpha from rt1) */
-
-      fac = fac2;
-      mfac = 1.0f - (fac2 * rt1[3]);
-
-      if (fac <= 0.0f) {
-        memcpy(rt, rt2, 4 * sizeof(float));
-      }
-      else if (mfac <= 0) {
-        memcpy(rt, rt1, 4 * sizeof(float));
-      }
-      else {
-        rt[0] = fac * rt1[0] + mfac * rt2[0];
-        rt[1] = fac * rt1[1] + mfac * rt2[1];
-        rt[2] = fac * rt1[2] + mfac * rt2[2];
-        rt[3] = fac * rt1[3] + mfac * rt2[3];
-      }
+      alphaover_pixel_float(facf0, rt1, rt2, rt);
       rt1 += 4;
       rt2 += 4;
       rt += 4;
@@ -326,21 +377,7 @@ static void do_alphaover_effect_float(
 
     x = xo;
     while (x--) {
-      fac = fac4;
-      mfac = 1.0f - (fac4 * rt1[3]);
-
-      if (fac <= 0.0f) {
-        memcpy(rt, rt2, 4 * sizeof(float));
-      }
-      else if (mfac <= 0.0f) {
-        memcpy(rt, rt1, 4 * sizeof(float));
-      }
-      else {
-        rt[0] = fac * rt1[0] + mfac * rt2[0];
-        rt[1] = fac * rt1[1] + mfac * rt2[1];
-        rt[2] = fac * rt1[2] + mfac * rt2[2];
-        rt[3] = fac * rt1[3] + mfac * rt2[3];
-      }
+      alphaover_pixel_float(facf1, rt1, rt2, rt);
       rt1 += 4;
       rt2 += 4;
       rt += 4;
@@ -380,6 +417,52 @@ static void do_alphaover_effect(const SeqRenderData *context,
 
 /*********************** Alpha Under *************************/
 
+BLI_INLINE void alphaunder_pixel_byte(float fac,
+                                      const unsigned char *cp1,
+                                      const unsigned char *cp2,
+                                      unsigned char *rt)
+{
+  /* rt = rt1 under rt2  (alpha from rt2) */
+  const float alpha2 = cp2[3] * (1.0f / 255.0f);
+
+  /* this complex optimization is because the
+   * 'skybuf' can be crossed in
+   */
+  if (alpha2 <= 0.0f && fac >= 1.0f) {
+    *((unsigned int *)rt) = *((const unsigned int *)cp1);
+  }
+  else if (alpha2 >= 1.0f) {
+    *((unsigned int *)rt) = *((const unsigned int *)cp2);
+  }
+  else {
+    const float mfac = fac * (1.0f - alpha2);
+
+    if (mfac <= 0) {
+      *((unsigned int *)rt) = *((const unsigned int *)cp2);
+    }
+    else {
+#ifdef __SSE2__
+      const __m128 rt1 = straight_uchar_to_premul_float_sse2(cp1);
+      const __m128 rt2 = straight_uchar_to_premul_float_sse2(cp2);
+      premul_float_to_straight_uchar_sse2(rt,
+                                          _mm_add_ps(_mm_mul_ps(_mm_set1_ps(mfac), rt1), rt2));
+#else
+      float tempc[4], rt1[4], rt2[4];
+
+      straight_uchar_to_premul_float(rt1, cp1);
+      straight_uchar_to_premul_float(rt2, cp2);
+
+      tempc[0] = (mfac * rt1[0] + rt2[0]);
+      tempc[1] = (mfac * rt1[1] + rt2[1]);
+      tempc[2] = (mfac * rt1[2] + rt2[2]);
+      tempc[3] = (mfac * rt1[3] + rt2[3]);
+
+      premul_float_to_straight_uchar(rt, tempc);
+#endif
+    }
+  }
+}
+
 static void do_alphaunder_effect_byte(float facf0,
                                       float facf1,
                                       int x,
@@ -388,50 +471,18 @@ static void do_alphaunder_effect_byte(float facf0,
                                       unsigned char *rect2,
                                       unsigned char *out)
 {
-  float fac2, fac, fac4;
   int xo;
   unsigned char *cp1, *cp2, *rt;
-  float tempc[4], rt1[4], rt2[4];
 
   xo = x;
   cp1 = rect1;
   cp2 = rect2;
   rt = out;
 
-  fac2 = facf0;
-  fac4 = facf1;
-
   while (y--) {
     x = xo;
     while (x--) {
-      /* rt = rt1 under rt2  (alpha from rt2) */
-      straight_uchar_to_premul_float(rt1, cp1);
-      straight_uchar_to_premul_float(rt2, cp2);
-
-      /* this complex optimization is because the
-       * 'skybuf' can be crossed in
-       */
-      if (rt2[3] <= 0.0f && fac2 >= 1.0f) {
-        *((unsigned int *)rt) = *((unsigned int *)cp1);
-      }
-      else if (rt2[3] >= 1.0f) {
-        *((unsigned int *)rt) = *((unsigned int *)cp2);
-      }
-      else {
-        fac = (fac2 * (1.0f - rt2[3]));
-
-        if (fac <= 0) {
-          *((unsigned int *)rt) = *((unsigned int *)cp2);
-        }
-        else {
-          tempc[0] = (fac * rt1[0] + rt2[0]);
-          tempc[1] = (fac * rt1[1] + rt2[1]);
-          tempc[2] = (fac * rt1[2] + rt2[2]);
-          tempc[3] = (fac * rt1[3] + rt2[3]);
-
-          premul_float_to_straight_uchar(rt, tempc);
-        }
-      }
+      alphaunder_pixel_byte(facf0, cp1, cp2, rt);
       cp1 += 4;
       cp2 += 4;
       rt += 4;
@@ -444,30 +495,7 @@ static void do_alphaunder_effect_byte(float facf0,
 
     x = xo;
     while (x--) {
-      straight_uchar_to_premul_float(rt1, cp1);
-      straight_uchar_to_premul_float(rt2, cp2);
-
-      if (rt2[3] <= 0.0f && fac4 >= 1.0f) {
-        *((unsigned int *)rt) = *((unsigned int *)cp1);
-      }
-      else if (rt2[3] >= 1.0f) {
-        *((unsigned int *)rt) = *((unsigned int *)cp2);
-      }
-      else {
-        fac = (fac4 * (1.0f - rt2[3]));
-
-        if (fac <= 0) {
-          *((unsigned int *)rt) = *((unsigned int *)cp2);
-        }
-        else {
-          tempc[0] = (fac * rt1[0] + rt2[0]);
-          tempc[1] = (fac * rt1[1] + rt2[1]);
-          tempc[2] = (fac * rt1[2] + rt2[2]);
-          tempc[3] = (fac * rt1[3] + rt2[3]);
-
-          premul_float_to_straight_uchar(rt, tempc);
-        }
-      }
+      alphaunder_pixel_byte(facf1, cp1, cp2, rt);
       cp1 += 4;
       cp2 += 4;
       rt += 4;
@@ -475,10 +503,42 @@ static void do_alphaunder_effect_byte(float facf0,
   }
 }
 
+BLI_INLINE void alphaunder_pixel_float(float fac, const float *rt1, const float *rt2, float *rt)
+{
+  /* rt = rt1 under rt2  (alpha from rt2) */
+
+  /* this complex optimization is because the
+   * 'skybuf' can be crossed in
+   */
+  if (rt2[3] <= 0 && fac >= 1.0f) {
+    memcpy(rt, rt1, 4 * sizeof(float));
+  }
+  else if (rt2[3] >= 1.0f) {
+    memcpy(rt, rt2, 4 * sizeof(float));
+  }
+  else {
+    const float mfac = fac * (1.0f - rt2[3]);
+
+    if (mfac == 0) {
+      memcpy(rt, rt2, 4 * sizeof(float));
+    }
+    else {
+#ifdef __SSE2__
+      _mm_storeu_ps(
+          rt, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(mfac), _mm_loadu_ps(rt1)), _mm_loadu_ps(rt2)));
+#else
+      rt[0] = mfac * rt1[0] + rt2[0];
+      rt[1] = mfac * rt1[1] + rt2[1];
+      rt[2] = mfac * rt1[2] + rt2[2];
+      rt[3] = mfac * rt1[3] + rt2[3];
+#endif
+    }
+  }
+}
+
 static void do_alphaunder_effect_float(
     float facf0, float facf1, int x, int y, float *rect1, float *rect2, float *out)
 {
-  float fac2, fac, fac4;
   int xo;
   float *rt1, *rt2, *rt;
 
@@ -487,36 +547,10 @@ static void do_alphaunder_effect_float(
   rt2 = rect2;
   rt = out;
 
-  fac2 = facf0;
-  fac4 = facf1;
-
   while (y--) {
     x = xo;
     while (x--) {
-      /* rt = rt1 under rt2  (alpha from rt2) */
-
-      /* this complex optimization is because the
-       * 'skybuf' can be crossed in
-       */
-      if (rt2[3] <= 0 && fac2 >= 1.0f) {
-        memcpy(rt, rt1, 4 * sizeof(float));
-      }
-      else if (rt2[3] >= 1.0f) {
-        memcpy(rt, rt2, 4 * sizeof(float));
-      }
-      else {
-        fac = fac2 * (1.0f - rt2[3]);
-
-        if (fac == 0) {
-          memcpy(rt, rt2, 4 * sizeof(float));
-        }
-        else {
-          rt[0] = fac * rt1[0] + rt2[0];
-          rt[1] = fac * rt1[1] + rt2[1];
-          rt[2] = fac * rt1[2] + rt2[2];
-          rt[3] = fac * rt1[3] + rt2[3];
-        }
-      }
+      alphaunder_pixel_float(facf0, rt1, rt2, rt);
       rt1 += 4;
       rt2 += 4;
       rt += 4;
@@ -529,25 +563,7 @@ static void do_alphaunder_effect_float(
 
     x = xo;
     while (x--) {
-      if (rt2[3] <= 0 && fac4 >= 1.0f) {
-        memcpy(rt, rt1, 4 * sizeof(float));
-      }
-      else if (rt2[3] >= 1.0f) {
-        memcpy(rt, rt2, 4 * sizeof(float));
-      }
-      else {
-        fac = fac4 * (1.0f - rt2[3]);
-
-        if (fac == 0) {
-          memcpy(rt, rt2, 4 * sizeof(float));
-        }
-        else {
-          rt[0] = fac * rt1[0] + rt2[0];
-          rt[1] = fac * rt1[1] + rt2[1];
-          rt[2] = fac * rt1[2] + rt2[2];
-          rt[3] = fac * rt1[3] + rt2[3];
-        }
-      }
+      alphaunder_pixel_float(facf1, rt1, rt2, rt);
       rt1 += 4;
       rt2 += 4;
       rt += 4;
@@ -587,6 +603,48 @@ static void do_alphaunder_effect(const SeqRenderData *context,
 
 /*********************** Cross *************************/
 
+static void cross_row_byte(int fac1,
+                           int fac2,
+                           int width,
+                           const unsigned char *rt1,
+                           const unsigned char *rt2,
+                           unsigned char *rt)
+{
+  int x = 0;
+
+#ifdef __SSE2__
+  /* Factors sum up to 256, when both are positive weighted sum fits in 16 bits. */
+  if (fac1 >= 0 && fac2 >= 0) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i fac1_v = _mm_set1_epi16((short)fac1);
+    const __m128i fac2_v = _mm_set1_epi16((short)fac2);
+
+    for (; x + 4 <= width; x += 4) {
+      const __m128i p1 = _mm_loadu_si128((const __m128i *)(rt1 + x * 4));
+      const __m128i p2 = _mm_loadu_si128((const __m128i *)(rt2 + x * 4));
+      __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(p1, zero), fac1_v),
+                                 _mm_mullo_epi16(_mm_unpacklo_epi8(p2, zero), fac2_v));
+      __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(p1, zero), fac1_v),
+                                 _mm_mullo_epi16(_mm_unpackhi_epi8(p2, zero), fac2_v));
+      lo = _mm_srli_epi16(lo, 8);
+      hi = _mm_srli_epi16(hi, 8);
+      _mm_storeu_si128((__m128i *)(rt + x * 4), _mm_packus_epi16(lo, hi));
+    }
+  }
+#endif
+
+  for (; x < width; x++) {
+    const unsigned char *cp1 = rt1 + x * 4;
+    const unsigned char *cp2 = rt2 + x * 4;
+    unsigned char *cp = rt + x * 4;
+
+    cp[0] = (fac1 * cp1[0] + fac2 * cp2[0]) >> 8;
+    cp[1] = (fac1 * cp1[1] + fac2 * cp2[1]) >> 8;
+    cp[2] = (fac1 * cp1[2] + fac2 * cp2[2]) >> 8;
+    cp[3] = (fac1 * cp1[3] + fac2 * cp2[3]) >> 8;
+  }
+}
+
 static void do_cross_effect_byte(float facf0,
                                  float facf1,
                                  int x,
@@ -610,37 +668,38 @@ static void do_cross_effect_byte(float facf0,
   fac3 = 256 - fac4;
 
   while (y--) {
-    x = xo;
-    while (x--) {
-      rt[0] = (fac1 * rt1[0] + fac2 * rt2[0]) >> 8;
-      rt[1] = (fac1 * rt1[1] + fac2 * rt2[1]) >> 8;
-      rt[2] = (fac1 * rt1[2] + fac2 * rt2[2]) >> 8;
-      rt[3] = (fac1 * rt1[3] + fac2 * rt2[3]) >> 8;
-
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
+    cross_row_byte(fac1, fac2, xo, rt1, rt2, rt);
+    rt1 += xo * 4;
+    rt2 += xo * 4;
+    rt += xo * 4;
 
     if (y == 0) {
       break;
     }
     y--;
 
-    x = xo;
-    while (x--) {
-      rt[0] = (fac3 * rt1[0] + fac4 * rt2[0]) >> 8;
-      rt[1] = (fac3 * rt1[1] + fac4 * rt2[1]) >> 8;
-      rt[2] = (fac3 * rt1[2] + fac4 * rt2[2]) >> 8;
-      rt[3] = (fac3 * rt1[3] + fac4 * rt2[3]) >> 8;
-
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
+    cross_row_byte(fac3, fac4, xo, rt1, rt2, rt);
+    rt1 += xo * 4;
+    rt2 += xo * 4;
+    rt += xo * 4;
   }
 }
 
+BLI_INLINE void cross_pixel_float(
+    float fac1, float fac2, const float *rt1, const float *rt2, float *rt)
+{
+#ifdef __SSE2__
+  _mm_storeu_ps(rt,
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(fac1), _mm_loadu_ps(rt1)),
+                           _mm_mul_ps(_mm_set1_ps(fac2), _mm_loadu_ps(rt2))));
+#else
+  rt[0] = fac1 * rt1[0] + fac2 * rt2[0];
+  rt[1] = fac1 * rt1[1] + fac2 * rt2[1];
+  rt[2] = fac1 * rt1[2] + fac2 * rt2[2];
+  rt[3] = fac1 * rt1[3] + fac2 * rt2[3];
+#endif
+}
+
 static void do_cross_effect_float(
     float facf0, float facf1, int x, int y, float *rect1, float *rect2, float *out)
 {
@@ -661,11 +720,7 @@ static void do_cross_effect_float(
   while (y--) {
     x = xo;
     while (x--) {
-      rt[0] = fac1 * rt1[0] + fac2 * rt2[0];
-      rt[1] = fac1 * rt1[1] + fac2 * rt2[1];
-      rt[2] = fac1 * rt1[2] + fac2 * rt2[2];
-      rt[3] = fac1 * rt1[3] + fac2 * rt2[3];
-
+      cross_pixel_float(fac1, fac2, rt1, rt2, rt);
       rt1 += 4;
       rt2 += 4;
       rt += 4;
@@ -678,11 +733,7 @@ static void do_cross_effect_float(
 
     x = xo;
     while (x--) {
-      rt[0] = fac3 * rt1[0] + fac4 * rt2[0];
-      rt[1] = fac3 * rt1[1] + fac4 * rt2[1];
-      rt[2] = fac3 * rt1[2] + fac4 * rt2[2];
-      rt[3] = fac3 * rt1[3] + fac4 * rt2[3];
-
+      cross_pixel_float(fac3, fac4, rt1, rt2, rt);
       rt1 += 4;
       rt2 += 4;
       rt += 4;
@@ -722,147 +773,36 @@ static void do_cross_effect(const SeqRenderData *context,
 
 /*********************** Gamma Cross *************************/
 
-/* copied code from initrender.c */
-static unsigned short gamtab[65536];
-static unsigned short igamtab1[256];
-static bool gamma_tabs_init = false;
-
-#define RE_GAMMA_TABLE_SIZE 400
-
-static float gamma_range_table[RE_GAMMA_TABLE_SIZE + 1];
-static float gamfactor_table[RE_GAMMA_TABLE_SIZE];
-static float inv_gamma_range_table[RE_GAMMA_TABLE_SIZE + 1];
-static float inv_gamfactor_table[RE_GAMMA_TABLE_SIZE];
-static float color_domain_table[RE_GAMMA_TABLE_SIZE + 1];
-static float color_step;
-static float inv_color_step;
-static float valid_gamma;
-static float valid_inv_gamma;
-
-static void makeGammaTables(float gamma)
+/* Gamma cross blends in gamma 2.0 space. Negative colors keep their sign. */
+BLI_INLINE float gammaCorrect(float c)
 {
-  /* we need two tables: one forward, one backward */
-  int i;
-
-  valid_gamma = gamma;
-  valid_inv_gamma = 1.0f / gamma;
-  color_step = 1.0f / RE_GAMMA_TABLE_SIZE;
-  inv_color_step = (float)RE_GAMMA_TABLE_SIZE;
-
-  /* We could squeeze out the two range tables to gain some memory */
-  for (i = 0; i < RE_GAMMA_TABLE_SIZE; i++) {
-    color_domain_table[i] = i * color_step;
-    gamma_range_table[i] = pow(color_domain_table[i], valid_gamma);
-    inv_gamma_range_table[i] = pow(color_domain_table[i], valid_inv_gamma);
-  }
-
-  /* The end of the table should match 1.0 carefully. In order to avoid
-   * rounding errors, we just set this explicitly. The last segment may
-   * have a different length than the other segments, but our
-   * interpolation is insensitive to that
-   */
-  color_domain_table[RE_GAMMA_TABLE_SIZE] = 1.0;
-  gamma_range_table[RE_GAMMA_TABLE_SIZE] = 1.0;
-  inv_gamma_range_table[RE_GAMMA_TABLE_SIZE] = 1.0;
-
-  /* To speed up calculations, we make these calc factor tables. They are
-   * multiplication factors used in scaling the interpolation
-   */
-  for (i = 0; i < RE_GAMMA_TABLE_SIZE; i++) {
-    gamfactor_table[i] = inv_color_step * (gamma_range_table[i + 1] - gamma_range_table[i]);
-    inv_gamfactor_table[i] = inv_color_step *
-                             (inv_gamma_range_table[i + 1] - inv_gamma_range_table[i]);
-  }
+  return c * fabsf(c);
 }
 
-static float gammaCorrect(float c)
+BLI_INLINE float invGammaCorrect(float c)
 {
-  int i;
-  float res;
-
-  i = floorf(c * inv_color_step);
-  /* Clip to range [0, 1]: outside, just do the complete calculation.
-   * We may have some performance problems here. Stretching up the LUT
-   * may help solve that, by exchanging LUT size for the interpolation.
-   * Negative colors are explicitly handled.
-   */
-  if (UNLIKELY(i < 0)) {
-    res = -powf(-c, valid_gamma);
-  }
-  else if (i >= RE_GAMMA_TABLE_SIZE) {
-    res = powf(c, valid_gamma);
-  }
-  else {
-    res = gamma_range_table[i] + ((c - color_domain_table[i]) * gamfactor_table[i]);
-  }
-
-  return res;
+  return (c < 0.0f) ? -sqrtf(-c) : sqrtf(c);
 }
 
-/* ------------------------------------------------------------------------- */
-
-static float invGammaCorrect(float c)
+#ifdef __SSE2__
+BLI_INLINE __m128 gamma_correct_sse2(__m128 c)
 {
-  int i;
-  float res = 0.0;
-
-  i = floorf(c * inv_color_step);
-  /* Negative colors are explicitly handled */
-  if (UNLIKELY(i < 0)) {
-    res = -powf(-c, valid_inv_gamma);
-  }
-  else if (i >= RE_GAMMA_TABLE_SIZE) {
-    res = powf(c, valid_inv_gamma);
-  }
-  else {
-    res = inv_gamma_range_table[i] + ((c - color_domain_table[i]) * inv_gamfactor_table[i]);
-  }
-
-  return res;
+  return _mm_mul_ps(c, _mm_andnot_ps(_mm_set1_ps(-0.0f), c));
 }
 
-static void gamtabs(float gamma)
+BLI_INLINE __m128 inv_gamma_correct_sse2(__m128 c)
 {
-  float val, igamma = 1.0f / gamma;
-  int a;
-
-  /* gamtab: in short, out short */
-  for (a = 0; a < 65536; a++) {
-    val = a;
-    val /= 65535.0f;
-
-    if (gamma == 2.0f) {
-      val = sqrtf(val);
-    }
-    else if (gamma != 1.0f) {
-      val = powf(val, igamma);
-    }
-
-    gamtab[a] = (65535.99f * val);
-  }
-  /* inverse gamtab1 : in byte, out short */
-  for (a = 1; a <= 256; a++) {
-    if (gamma == 2.0f) {
-      igamtab1[a - 1] = a * a - 1;
-    }
-    else if (gamma == 1.0f) {
-      igamtab1[a - 1] = 256 * a - 1;
-    }
-    else {
-      val = a / 256.0f;
-      igamtab1[a - 1] = (65535.0 * pow(val, gamma)) - 1;
-    }
-  }
+  const __m128 sign_mask = _mm_set1_ps(-0.0f);
+  return _mm_or_ps(_mm_sqrt_ps(_mm_andnot_ps(sign_mask, c)), _mm_and_ps(sign_mask, c));
 }
 
-static void build_gammatabs(void)
+BLI_INLINE __m128 gammacross_sse2(float fac1, float fac2, __m128 rt1, __m128 rt2)
 {
-  if (gamma_tabs_init == false) {
-    gamtabs(2.0f);
-    makeGammaTables(2.0f);
-    gamma_tabs_init = true;
-  }
+  const __m128 sum = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(fac1), inv_gamma_correct_sse2(rt1)),
+                                _mm_mul_ps(_mm_set1_ps(fac2), inv_gamma_correct_sse2(rt2)));
+  return gamma_correct_sse2(sum);
 }
+#endif
 
 static void init_gammacross(Sequence *UNUSED(seq))
 {
@@ -876,6 +816,33 @@ static void free_gammacross(Sequence *UNUSED(seq), const bool UNUSED(do_id_user)
 {
 }
 
+BLI_INLINE void gammacross_pixel_byte(float fac1,
+                                      float fac2,
+                                      const unsigned char *cp1,
+                                      const unsigned char *cp2,
+                                      unsigned char *rt)
+{
+#ifdef __SSE2__
+  premul_float_to_straight_uchar_sse2(rt,
+                                      gammacross_sse2(fac1,
+                                                      fac2,
+                                                      straight_uchar_to_premul_float_sse2(cp1),
+                                                      straight_uchar_to_premul_float_sse2(cp2)));
+#else
+  float rt1[4], rt2[4], tempc[4];
+
+  straight_uchar_to_premul_float(rt1, cp1);
+  straight_uchar_to_premul_float(rt2, cp2);
+
+  tempc[0] = gammaCorrect(fac1 * invGammaCorrect(rt1[0]) + fac2 * invGammaCorrect(rt2[0]));
+  tempc[1] = gammaCorrect(fac1 * invGammaCorrect(rt1[1]) + fac2 * invGammaCorrect(rt2[1]));
+  tempc[2] = gammaCorrect(fac1 * invGammaCorrect(rt1[2]) + fac2 * invGammaCorrect(rt2[2]));
+  tempc[3] = gammaCorrect(fac1 * invGammaCorrect(rt1[3]) + fac2 * invGammaCorrect(rt2[3]));
+
+  premul_float_to_straight_uchar(rt, tempc);
+#endif
+}
+
 static void do_gammacross_effect_byte(float facf0,
                                       float UNUSED(facf1),
                                       int x,
@@ -887,7 +854,6 @@ static void do_gammacross_effect_byte(float facf0,
   float fac1, fac2;
   int xo;
   unsigned char *cp1, *cp2, *rt;
-  float rt1[4], rt2[4], tempc[4];
 
   xo = x;
   cp1 = rect1;
@@ -897,43 +863,13 @@ static void do_gammacross_effect_byte(float facf0,
   fac2 = facf0;
   fac1 = 1.0f - fac2;
 
-  while (y--) {
-    x = xo;
-    while (x--) {
-      straight_uchar_to_premul_float(rt1, cp1);
-      straight_uchar_to_premul_float(rt2, cp2);
-
-      tempc[0] = gammaCorrect(fac1 * invGammaCorrect(rt1[0]) + fac2 * invGammaCorrect(rt2[0]));
-      tempc[1] = gammaCorrect(fac1 * invGammaCorrect(rt1[1]) + fac2 * invGammaCorrect(rt2[1]));
-      tempc[2] = gammaCorrect(fac1 * invGammaCorrect(rt1[2]) + fac2 * invGammaCorrect(rt2[2]));
-      tempc[3] = gammaCorrect(fac1 * invGammaCorrect(rt1[3]) + fac2 * invGammaCorrect(rt2[3]));
-
-      premul_float_to_straight_uchar(rt, tempc);
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
-
-    if (y == 0) {
-      break;
-    }
-    y--;
-
-    x = xo;
-    while (x--) {
-      straight_uchar_to_premul_float(rt1, cp1);
-      straight_uchar_to_premul_float(rt2, cp2);
-
-      tempc[0] = gammaCorrect(fac1 * invGammaCorrect(rt1[0]) + fac2 * invGammaCorrect(rt2[0]));
-      tempc[1] = gammaCorrect(fac1 * invGammaCorrect(rt1[1]) + fac2 * invGammaCorrect(rt2[1]));
-      tempc[2] = gammaCorrect(fac1 * invGammaCorrect(rt1[2]) + fac2 * invGammaCorrect(rt2[2]));
-      tempc[3] = gammaCorrect(fac1 * invGammaCorrect(rt1[3]) + fac2 * invGammaCorrect(rt2[3]));
-
-      premul_float_to_straight_uchar(rt, tempc);
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
+  /* Both fields use the same factor. */
+  x = xo * y;
+  while (x--) {
+    gammacross_pixel_byte(fac1, fac2, cp1, cp2, rt);
+    cp1 += 4;
+    cp2 += 4;
+    rt += 4;
   }
 }
 
@@ -952,42 +888,23 @@ static void do_gammacross_effect_float(
   fac2 = facf0;
   fac1 = 1.0f - fac2;
 
-  while (y--) {
-    x = xo * 4;
-    while (x--) {
-      *rt = gammaCorrect(fac1 * invGammaCorrect(*rt1) + fac2 * invGammaCorrect(*rt2));
-      rt1++;
-      rt2++;
-      rt++;
-    }
-
-    if (y == 0) {
-      break;
-    }
-    y--;
-
-    x = xo * 4;
-    while (x--) {
-      *rt = gammaCorrect(fac1 * invGammaCorrect(*rt1) + fac2 * invGammaCorrect(*rt2));
-
-      rt1++;
-      rt2++;
-      rt++;
-    }
+  /* Both fields use the same factor. */
+  x = xo * y;
+  while (x--) {
+#ifdef __SSE2__
+    _mm_storeu_ps(rt, gammacross_sse2(fac1, fac2, _mm_loadu_ps(rt1), _mm_loadu_ps(rt2)));
+#else
+    rt[0] = gammaCorrect(fac1 * invGammaCorrect(rt1[0]) + fac2 * invGammaCorrect(rt2[0]));
+    rt[1] = gammaCorrect(fac1 * invGammaCorrect(rt1[1]) + fac2 * invGammaCorrect(rt2[1]));
+    rt[2] = gammaCorrect(fac1 * invGammaCorrect(rt1[2]) + fac2 * invGammaCorrect(rt2[2]));
+    rt[3] = gammaCorrect(fac1 * invGammaCorrect(rt1[3]) + fac2 * invGammaCorrect(rt2[3]));
+#endif
+    rt1 += 4;
+    rt2 += 4;
+    rt += 4;
   }
 }
 
-static struct ImBuf *gammacross_init_execution(const SeqRenderData *context,
-                                               ImBuf *ibuf1,
-                                               ImBuf *ibuf2,
-                                               ImBuf *ibuf3)
-{
-  ImBuf *out = prepare_effect_imbufs(context, ibuf1, ibuf2, ibuf3);
-  build_gammatabs();
-
-  return out;
-}
-
 static void do_gammacross_effect(const SeqRenderData *context,
                                  Sequence *UNUSED(seq),
                                  float UNUSED(cfra),
@@ -1020,6 +937,40 @@ static void do_gammacross_effect(const SeqRenderData *context,
 
 /*********************** Add *************************/
 
+static void add_row_byte(
+    int fac, int width, const unsigned char *cp1, const unsigned char *cp2, unsigned char *rt)
+{
+  int x = 0;
+
+#ifdef __SSE2__
+  if (fac >= 0 && fac <= 256) {
+    const __m128i fac_v = _mm_set1_epi16((short)fac);
+    const __m128i alpha_mask = _mm_set1_epi32((int)0xff000000);
+
+    for (; x + 4 <= width; x += 4) {
+      const __m128i p1 = _mm_loadu_si128((const __m128i *)(cp1 + x * 4));
+      const __m128i p2 = _mm_loadu_si128((const __m128i *)(cp2 + x * 4));
+      const __m128i sum = _mm_adds_epu8(p1, alpha_scale_uchar_sse2(p2, fac_v));
+      _mm_storeu_si128(
+          (__m128i *)(rt + x * 4),
+          _mm_or_si128(_mm_andnot_si128(alpha_mask, sum), _mm_and_si128(alpha_mask, p1)));
+    }
+  }
+#endif
+
+  for (; x < width; x++) {
+    const unsigned char *c1 = cp1 + x * 4;
+    const unsigned char *c2 = cp2 + x * 4;
+    unsigned char *c = rt + x * 4;
+    const int m = fac * (int)c2[3];
+
+    c[0] = min_ii(c1[0] + ((m * c2[0]) >> 16), 255);
+    c[1] = min_ii(c1[1] + ((m * c2[1]) >> 16), 255);
+    c[2] = min_ii(c1[2] + ((m * c2[2]) >> 16), 255);
+    c[3] = c1[3];
+  }
+}
+
 static void do_add_effect_byte(float facf0,
                                float facf1,
                                int x,
@@ -1040,40 +991,37 @@ static void do_add_effect_byte(float facf0,
   fac3 = (int)(256.0f * facf1);
 
   while (y--) {
-    x = xo;
-
-    while (x--) {
-      const int m = fac1 * (int)cp2[3];
-      rt[0] = min_ii(cp1[0] + ((m * cp2[0]) >> 16), 255);
-      rt[1] = min_ii(cp1[1] + ((m * cp2[1]) >> 16), 255);
-      rt[2] = min_ii(cp1[2] + ((m * cp2[2]) >> 16), 255);
-      rt[3] = cp1[3];
-
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
+    add_row_byte(fac1, xo, cp1, cp2, rt);
+    cp1 += xo * 4;
+    cp2 += xo * 4;
+    rt += xo * 4;
 
     if (y == 0) {
       break;
     }
     y--;
 
-    x = xo;
-    while (x--) {
-      const int m = fac3 * (int)cp2[3];
-      rt[0] = min_ii(cp1[0] + ((m * cp2[0]) >> 16), 255);
-      rt[1] = min_ii(cp1[1] + ((m * cp2[1]) >> 16), 255);
-      rt[2] = min_ii(cp1[2] + ((m * cp2[2]) >> 16), 255);
-      rt[3] = cp1[3];
-
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
+    add_row_byte(fac3, xo, cp1, cp2, rt);
+    cp1 += xo * 4;
+    cp2 += xo * 4;
+    rt += xo * 4;
   }
 }
 
+BLI_INLINE void add_pixel_float(float fac, const float *rt1, const float *rt2, float *rt)
+{
+  const float m = (1.0f - (rt1[3] * (1.0f - fac))) * rt2[3];
+#ifdef __SSE2__
+  _mm_storeu_ps(rt,
+                _mm_add_ps(_mm_loadu_ps(rt1), _mm_mul_ps(_mm_set1_ps(m), _mm_loadu_ps(rt2))));
+#else
+  rt[0] = rt1[0] + m * rt2[0];
+  rt[1] = rt1[1] + m * rt2[1];
+  rt[2] = rt1[2] + m * rt2[2];
+#endif
+  rt[3] = rt1[3];
+}
+
 static void do_add_effect_float(
     float facf0, float facf1, int x, int y, float *rect1, float *rect2, float *out)
 {
@@ -1092,12 +1040,7 @@ static void do_add_effect_float(
   while (y--) {
     x = xo;
     while (x--) {
-      const float m = (1.0f - (rt1[3] * (1.0f - fac1))) * rt2[3];
-      rt[0] = rt1[0] + m * rt2[0];
-      rt[1] = rt1[1] + m * rt2[1];
-      rt[2] = rt1[2] + m * rt2[2];
-      rt[3] = rt1[3];
-
+      add_pixel_float(fac1, rt1, rt2, rt);
       rt1 += 4;
       rt2 += 4;
       rt += 4;
@@ -1110,12 +1053,7 @@ static void do_add_effect_float(
 
     x = xo;
     while (x--) {
-      const float m = (1.0f - (rt1[3] * (1.0f - fac3))) * rt2[3];
-      rt[0] = rt1[0] + m * rt2[0];
-      rt[1] = rt1[1] + m * rt2[1];
-      rt[2] = rt1[2] + m * rt2[2];
-      rt[3] = rt1[3];
-
+      add_pixel_float(fac3, rt1, rt2, rt);
       rt1 += 4;
       rt2 += 4;
       rt += 4;
@@ -1155,6 +1093,40 @@ static void do_add_effect(const SeqRenderData *context,
 
 /*********************** Sub *************************/
 
+static void sub_row_byte(
+    int fac, int width, const unsigned char *cp1, const unsigned char *cp2, unsigned char *rt)
+{
+  int x = 0;
+
+#ifdef __SSE2__
+  if (fac >= 0 && fac <= 256) {
+    const __m128i fac_v = _mm_set1_epi16((short)fac);
+    const __m128i alpha_mask = _mm_set1_epi32((int)0xff000000);
+
+    for (; x + 4 <= width; x += 4) {
+      const __m128i p1 = _mm_loadu_si128((const __m128i *)(cp1 + x * 4));
+      const __m128i p2 = _mm_loadu_si128((const __m128i *)(cp2 + x * 4));
+      const __m128i diff = _mm_subs_epu8(p1, alpha_scale_uchar_sse2(p2, fac_v));
+      _mm_storeu_si128(
+          (__m128i *)(rt + x * 4),
+          _mm_or_si128(_mm_andnot_si128(alpha_mask, diff), _mm_and_si128(alpha_mask, p1)));
+    }
+  }
+#endif
+
+  for (; x < width; x++) {
+    const unsigned char *c1 = cp1 + x * 4;
+    const unsigned char *c2 = cp2 + x * 4;
+    unsigned char *c = rt + x * 4;
+    const int m = fac * (int)c2[3];
+
+    c[0] = max_ii(c1[0] - ((m * c2[0]) >> 16), 0);
+    c[1] = max_ii(c1[1] - ((m * c2[1]) >> 16), 0);
+    c[2] = max_ii(c1[2] - ((m * c2[2]) >> 16), 0);
+    c[3] = c1[3];
+  }
+}
+
 static void do_sub_effect_byte(float facf0,
                                float facf1,
                                int x,
@@ -1175,39 +1147,37 @@ static void do_sub_effect_byte(float facf0,
   fac3 = (int)(256.0f * facf1);
 
   while (y--) {
-    x = xo;
-    while (x--) {
-      const int m = fac1 * (int)cp2[3];
-      rt[0] = max_ii(cp1[0] - ((m * cp2[0]) >> 16), 0);
-      rt[1] = max_ii(cp1[1] - ((m * cp2[1]) >> 16), 0);
-      rt[2] = max_ii(cp1[2] - ((m * cp2[2]) >> 16), 0);
-      rt[3] = cp1[3];
-
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
+    sub_row_byte(fac1, xo, cp1, cp2, rt);
+    cp1 += xo * 4;
+    cp2 += xo * 4;
+    rt += xo * 4;
 
     if (y == 0) {
       break;
     }
     y--;
 
-    x = xo;
-    while (x--) {
-      const int m = fac3 * (int)cp2[3];
-      rt[0] = max_ii(cp1[0] - ((m * cp2[0]) >> 16), 0);
-      rt[1] = max_ii(cp1[1] - ((m * cp2[1]) >> 16), 0);
-      rt[2] = max_ii(cp1[2] - ((m * cp2[2]) >> 16), 0);
-      rt[3] = cp1[3];
-
-      cp1 += 4;
-      cp2 += 4;
-      rt += 4;
-    }
+    sub_row_byte(fac3, xo, cp1, cp2, rt);
+    cp1 += xo * 4;
+    cp2 += xo * 4;
+    rt += xo * 4;
   }
 }
 
+BLI_INLINE void sub_pixel_float(float fac_inv, const float *rt1, const float *rt2, float *rt)
+{
+  const float m = (1.0f - (rt1[3] * fac_inv)) * rt2[3];
+#ifdef __SSE2__
+  const __m128 diff = _mm_sub_ps(_mm_loadu_ps(rt1), _mm_mul_ps(_mm_set1_ps(m), _mm_loadu_ps(rt2)));
+  _mm_storeu_ps(rt, _mm_max_ps(diff, _mm_setzero_ps()));
+#else
+  rt[0] = max_ff(rt1[0] - m * rt2[0], 0.0f);
+  rt[1] = max_ff(rt1[1] - m * rt2[1], 0.0f);
+  rt[2] = max_ff(rt1[2] - m * rt2[2], 0.0f);
+#endif
+  rt[3] = rt1[3];
+}
+
 static void do_sub_effect_float(
     float UNUSED(facf0), float facf1, int x, int y, float *rect1, float *rect2, float *out)
 {
@@ -1224,37 +1194,13 @@ static void do_sub_effect_float(
   // fac1 = facf0;
   fac3_inv = 1.0f - facf1;
 
-  while (y--) {
-    x = xo;
-    while (x--) {
-      const float m = (1.0f - (rt1[3] * fac3_inv)) * rt2[3];
-      rt[0] = max_ff(rt1[0] - m * rt2[0], 0.0f);
-      rt[1] = max_ff(rt1[1] - m * rt2[1], 0.0f);
-      rt[2] = max_ff(rt1[2] - m * rt2[2], 0.0f);
-      rt[3] = rt1[3];
-
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
-
-    if (y == 0) {
-      break;
-    }
-    y--;
-
-    x = xo;
-    while (x--) {
-      const float m = (1.0f - (rt1[3] * fac3_inv)) * rt2[3];
-      rt[0] = max_ff(rt1[0] - m * rt2[0], 0.0f);
-      rt[1] = max_ff(rt1[1] - m * rt2[1], 0.0f);
-      rt[2] = max_ff(rt1[2] - m * rt2[2], 0.0f);
-      rt[3] = rt1[3];
-
-      rt1 += 4;
-      rt2 += 4;
-      rt += 4;
-    }
+  /* Both fields use the same factor. */
+  x = xo * y;
+  while (x--) {
+    sub_pixel_float(fac3_inv, rt1, rt2, rt);
+    rt1 += 4;
+    rt2 += 4;
+    rt += 4;
   }
 }
 
@@ -1458,6 +1404,20 @@ static void do_mul_effect_byte(float facf0,
   }
 }
 
+BLI_INLINE void mul_pixel_float(float fac, const float *rt1, const float *rt2, float *rt)
+{
+#ifdef __SSE2__
+  const __m128 a = _mm_loadu_ps(rt1);
+  const __m128 b = _mm_sub_ps(_mm_loadu_ps(rt2), _mm_set1_ps(1.0f));
+  _mm_storeu_ps(rt, _mm_add_ps(a, _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(fac), a), b)));
+#else
+  rt[0] = rt1[0] + fac * rt1[0] * (rt2[0] - 1.0f);
+  rt[1] = rt1[1] + fac * rt1[1] * (rt2[1] - 1.0f);
+  rt[2] = rt1[2] + fac * rt1[2] * (rt2[2] - 1.0f);
+  rt[3] = rt1[3] + fac * rt1[3] * (rt2[3] - 1.0f);
+#endif
+}
+
 static void do_mul_effect_float(
     float facf0, float facf1, int x, int y, float *rect1, float *rect2, float *out)
 {
@@ -1480,11 +1440,7 @@ static void do_mul_effect_float(
   while (y--) {
     x = xo;
     while (x--) {
-      rt[0] = rt1[0] + fac1 * rt1[0] * (rt2[0] - 1.0f);
-      rt[1] = rt1[1] + fac1 * rt1[1] * (rt2[1] - 1.0f);
-      rt[2] = rt1[2] + fac1 * rt1[2] * (rt2[2] - 1.0f);
-      rt[3] = rt1[3] + fac1 * rt1[3] * (rt2[3] - 1.0f);
-
+      mul_pixel_float(fac1, rt1, rt2, rt);
       rt1 += 4;
       rt2 += 4;
       rt += 4;
@@ -1497,11 +1453,7 @@ static void do_mul_effect_float(
 
     x = xo;
     while (x--) {
-      rt[0] = rt1[0] + fac3 * rt1[0] * (rt2[0] - 1.0f);
-      rt[1] = rt1[1] + fac3 * rt1[1] * (rt2[1] - 1.0f);
-      rt[2] = rt1[2] + fac3 * rt1[2] * (rt2[2] - 1.0f);
-      rt[3] = rt1[3] + fac3 * rt1[3] * (rt2[3] - 1.0f);
-
+      mul_pixel_float(fac3, rt1, rt2, rt);
       rt1 += 4;
       rt2 += 4;
       rt += 4;
@@ -1556,17 +1508,17 @@ BLI_INLINE void apply_blend_function_byte(float facf0,
 {
   int xo;
   unsigned char *rt1, *rt2, *rt;
-  unsigned int achannel;
+  unsigned char src1[4];
   xo = x;
   rt1 = rect1;
   rt2 = rect2;
   rt = out;
   while (y--) {
     for (x = xo; x > 0; x--) {
-      achannel = rt1[3];
-      rt1[3] = (unsigned int)achannel * facf0;
-      blend_function(rt, rt1, rt2);
-      rt1[3] = achannel;
+      /* Input buffers can be shared with other threads, blend a copy. */
+      copy_v4_v4_uchar(src1, rt1);
+      src1[3] = (unsigned int)rt1[3] * facf0;
+      blend_function(rt, src1, rt2);
       rt[3] = rt1[3];
       rt1 += 4;
       rt2 += 4;
@@ -1577,10 +1529,10 @@ BLI_INLINE void apply_blend_function_byte(float facf0,
     }
     y--;
     for (x = xo; x > 0; x--) {
-      achannel = rt1[3];
-      rt1[3] = (unsigned int)achannel * facf1;
-      blend_function(rt, rt1, rt2);
-      rt1[3] = achannel;
+      /* Input buffers can be shared with other threads, blend a copy. */
+      copy_v4_v4_uchar(src1, rt1);
+      src1[3] = (unsigned int)rt1[3] * facf1;
+      blend_function(rt, src1, rt2);
       rt[3] = rt1[3];
       rt1 += 4;
       rt2 += 4;
@@ -1600,17 +1552,16 @@ BLI_INLINE void apply_blend_function_float(float facf0,
 {
   int xo;
   float *rt1, *rt2, *rt;
-  float achannel;
+  float src1[4];
   xo = x;
   rt1 = rect1;
   rt2 = rect2;
   rt = out;
   while (y--) {
     for (x = xo; x > 0; x--) {
-      achannel = rt1[3];
-      rt1[3] = achannel * facf0;
-      blend_function(rt, rt1, rt2);
-      rt1[3] = achannel;
+      copy_v4_v4(src1, rt1);
+      src1[3] = rt1[3] * facf0;
+      blend_function(rt, src1, rt2);
       rt[3] = rt1[3];
       rt1 += 4;
       rt2 += 4;
@@ -1621,10 +1572,9 @@ BLI_INLINE void apply_blend_function_float(float facf0,
     }
     y--;
     for (x = xo; x > 0; x--) {
-      achannel = rt1[3];
-      rt1[3] = achannel * facf1;
-      blend_function(rt, rt1, rt2);
-      rt1[3] = achannel;
+      copy_v4_v4(src1, rt1);
+      src1[3] = rt1[3] * facf1;
+      blend_function(rt, src1, rt2);
       rt[3] = rt1[3];
       rt1 += 4;
       rt2 += 4;
@@ -2171,71 +2121,56 @@ static void copy_wipe_effect(Sequence *dst, Sequence *src, const int UNUSED(flag
 static void do_wipe_effect_byte(Sequence *seq,
                                 float facf0,
                                 float UNUSED(facf1),
-                                int x,
-                                int y,
+                                int width,
+                                int height,
+                                int start_line,
+                                int total_lines,
                                 unsigned char *rect1,
                                 unsigned char *rect2,
                                 unsigned char *out)
 {
   WipeZone wipezone;
   WipeVars *wipe = (WipeVars *)seq->effectdata;
-  int xo, yo;
   unsigned char *cp1, *cp2, *rt;
 
-  precalc_wipe_zone(&wipezone, wipe, x, y);
+  precalc_wipe_zone(&wipezone, wipe, width, height);
 
   cp1 = rect1;
   cp2 = rect2;
   rt = out;
 
-  xo = x;
-  yo = y;
-  for (y = 0; y < yo; y++) {
-    for (x = 0; x < xo; x++) {
+  for (int y = start_line; y < start_line + total_lines; y++) {
+    for (int x = 0; x < width; x++) {
       float check = check_zone(&wipezone, x, y, seq, facf0);
       if (check) {
-        if (cp1) {
-          float rt1[4], rt2[4], tempc[4];
+#ifdef __SSE2__
+        const __m128 rt1 = straight_uchar_to_premul_float_sse2(cp1);
+        const __m128 rt2 = straight_uchar_to_premul_float_sse2(cp2);
+        premul_float_to_straight_uchar_sse2(
+            rt,
+            _mm_add_ps(_mm_mul_ps(rt1, _mm_set1_ps(check)),
+                       _mm_mul_ps(rt2, _mm_set1_ps(1 - check))));
+#else
+        float rt1[4], rt2[4], tempc[4];
+
+        straight_uchar_to_premul_float(rt1, cp1);
+        straight_uchar_to_premul_float(rt2, cp2);
+
+        tempc[0] = rt1[0] * check + rt2[0] * (1 - check);
+        tempc[1] = rt1[1] * check + rt2[1] * (1 - check);
+        tempc[2] = rt1[2] * check + rt2[2] * (1 - check);
+        tempc[3] = rt1[3] * check + rt2[3] * (1 - check);
 
-          straight_uchar_to_premul_float(rt1, cp1);
-          straight_uchar_to_premul_float(rt2, cp2);
-
-          tempc[0] = rt1[0] * check + rt2[0] * (1 - check);
-          tempc[1] = rt1[1] * check + rt2[1] * (1 - check);
-          tempc[2] = rt1[2] * check + rt2[2] * (1 - check);
-          tempc[3] = rt1[3] * check + rt2[3] * (1 - check);
-
-          premul_float_to_straight_uchar(rt, tempc);
-        }
-        else {
-          rt[0] = 0;
-          rt[1] = 0;
-          rt[2] = 0;
-          rt[3] = 255;
-        }
+        premul_float_to_straight_uchar(rt, tempc);
+#endif
       }
       else {
-        if (cp2) {
-          rt[0] = cp2[0];
-          rt[1] = cp2[1];
-          rt[2] = cp2[2];
-          rt[3] = cp2[3];
-        }
-        else {
-          rt[0] = 0;
-          rt[1] = 0;
-          rt[2] = 0;
-          rt[3] = 255;
-        }
+        *((unsigned int *)rt) = *((unsigned int *)cp2);
       }
 
       rt += 4;
-      if (cp1 != NULL) {
-        cp1 += 4;
-      }
-      if (cp2 != NULL) {
-        cp2 += 4;
-      }
+      cp1 += 4;
+      cp2 += 4;
     }
   }
 }
@@ -2243,101 +2178,96 @@ static void do_wipe_effect_byte(Sequence *seq,
 static void do_wipe_effect_float(Sequence *seq,
                                  float facf0,
                                  float UNUSED(facf1),
-                                 int x,
-                                 int y,
+                                 int width,
+                                 int height,
+                                 int start_line,
+                                 int total_lines,
                                  float *rect1,
                                  float *rect2,
                                  float *out)
 {
   WipeZone wipezone;
   WipeVars *wipe = (WipeVars *)seq->effectdata;
-  int xo, yo;
   float *rt1, *rt2, *rt;
 
-  precalc_wipe_zone(&wipezone, wipe, x, y);
+  precalc_wipe_zone(&wipezone, wipe, width, height);
 
   rt1 = rect1;
   rt2 = rect2;
   rt = out;
 
-  xo = x;
-  yo = y;
-  for (y = 0; y < yo; y++) {
-    for (x = 0; x < xo; x++) {
+  for (int y = start_line; y < start_line + total_lines; y++) {
+    for (int x = 0; x < width; x++) {
       float check = check_zone(&wipezone, x, y, seq, facf0);
       if (check) {
-        if (rt1) {
-          rt[0] = rt1[0] * check + rt2[0] * (1 - check);
-          rt[1] = rt1[1] * check + rt2[1] * (1 - check);
-          rt[2] = rt1[2] * check + rt2[2] * (1 - check);
-          rt[3] = rt1[3] * check + rt2[3] * (1 - check);
-        }
-        else {
-          rt[0] = 0;
-          rt[1] = 0;
-          rt[2] = 0;
-          rt[3] = 1.0;
-        }
+#ifdef __SSE2__
+        _mm_storeu_ps(rt,
+                      _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(rt1), _mm_set1_ps(check)),
+                                 _mm_mul_ps(_mm_loadu_ps(rt2), _mm_set1_ps(1 - check))));
+#else
+        rt[0] = rt1[0] * check + rt2[0] * (1 - check);
+        rt[1] = rt1[1] * check + rt2[1] * (1 - check);
+        rt[2] = rt1[2] * check + rt2[2] * (1 - check);
+        rt[3] = rt1[3] * check + rt2[3] * (1 - check);
+#endif
       }
       else {
-        if (rt2) {
-          rt[0] = rt2[0];
-          rt[1] = rt2[1];
-          rt[2] = rt2[2];
-          rt[3] = rt2[3];
-        }
-        else {
-          rt[0] = 0;
-          rt[1] = 0;
-          rt[2] = 0;
-          rt[3] = 1.0;
-        }
+        memcpy(rt, rt2, 4 * sizeof(float));
       }
 
       rt += 4;
-      if (rt1 != NULL) {
-        rt1 += 4;
-      }
-      if (rt2 != NULL) {
-        rt2 += 4;
-      }
+      rt1 += 4;
+      rt2 += 4;
     }
   }
 }
 
-static ImBuf *do_wipe_effect(const SeqRenderData *context,
-                             Sequence *seq,
-                             float UNUSED(cfra),
-                             float facf0,
-                             float facf1,
-                             ImBuf *ibuf1,
-                             ImBuf *ibuf2,
-                             ImBuf *ibuf3)
+static void do_wipe_effect(const SeqRenderData *context,
+                           Sequence *seq,
+                           float UNUSED(cfra),
+                           float facf0,
+                           float facf1,
+                           ImBuf *ibuf1,
+                           ImBuf *ibuf2,
+                           ImBuf *UNUSED(ibuf3),
+                           int start_line,
+                           int total_lines,
+                           ImBuf *out)
 {
-  ImBuf *out = prepare_effect_imbufs(context, ibuf1, ibuf2, ibuf3);
-
   if (out->rect_float) {
+    float *rect1 = NULL, *rect2 = NULL, *rect_out = NULL;
+
+    slice_get_float_buffers(
+        context, ibuf1, ibuf2, NULL, out, start_line, &rect1, &rect2, NULL, &rect_out);
+
     do_wipe_effect_float(seq,
                          facf0,
                          facf1,
                          context->rectx,
                          context->recty,
-                         ibuf1->rect_float,
-                         ibuf2->rect_float,
-                         out->rect_float);
+                         start_line,
+                         total_lines,
+                         rect1,
+                         rect2,
+                         rect_out);
   }
   else {
+    unsigned char *rect1 = NULL, *rect2 = NULL, *rect_out = NULL;
+
+    slice_get_byte_buffers(
+        context, ibuf1, ibuf2, NULL, out, start_line, &rect1, &rect2, NULL, &rect_out);
+
     do_wipe_effect_byte(seq,
                         facf0,
                         facf1,
                         context->rectx,
                         context->recty,
-                        (unsigned char *)ibuf1->rect,
-                        (unsigned char *)ibuf2->rect,
-                        (unsigned char *)out->rect);
+                        start_line,
+                        total_lines,
+                        rect1,
+                        rect2,
+                        rect_out);
   }
-
-  return out;
 }
 
 /*********************** Transform *************************/
@@ -2501,6 +2431,127 @@ static ImBuf *do_transform_effect(const SeqRenderData *context,
 
 /*********************** Glow *************************/
 
+typedef struct GlowBlurData {
+  const float *src;
+  float *dst;
+  const float *filter;
+  int width;
+  int height;
+  int halfWidth;
+} GlowBlurData;
+
+static void glow_blur_rows_cb(void *__restrict userdata,
+                              const int y,
+                              const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const GlowBlurData *data = userdata;
+  const float *map = data->src;
+  const float *filter = data->filter;
+  float *temp = data->dst;
+  const int width = data->width;
+  const int halfWidth = data->halfWidth;
+  int x, i, fx, index;
+  float curColor[4], curColor2[4];
+
+  /* Do the left & right strips */
+  for (x = 0; x < halfWidth; x++) {
+    fx = 0;
+    zero_v4(curColor);
+    zero_v4(curColor2);
+
+    for (i = x - halfWidth; i < x + halfWidth; i++) {
+      if ((i >= 0) && (i < width)) {
+        index = (i + y * width) * 4;
+        madd_v4_v4fl(curColor, map + index, filter[fx]);
+
+        index = (width - 1 - i + y * width) * 4;
+        madd_v4_v4fl(curColor2, map + index, filter[fx]);
+      }
+      fx++;
+    }
+    index = (x + y * width) * 4;
+    copy_v4_v4(temp + index, curColor);
+
+    index = (width - 1 - x + y * width) * 4;
+    copy_v4_v4(temp + index, curColor2);
+  }
+
+  /* Do the main body */
+  for (x = halfWidth; x < width - halfWidth; x++) {
+    index = (x - halfWidth + y * width) * 4;
+#ifdef __SSE2__
+    __m128 sum = _mm_setzero_ps();
+    for (fx = 0; fx < halfWidth * 2; fx++, index += 4) {
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(map + index), _mm_set1_ps(filter[fx])));
+    }
+    _mm_storeu_ps(temp + (x + y * width) * 4, sum);
+#else
+    zero_v4(curColor);
+    for (fx = 0; fx < halfWidth * 2; fx++, index += 4) {
+      madd_v4_v4fl(curColor, map + index, filter[fx]);
+    }
+    copy_v4_v4(temp + (x + y * width) * 4, curColor);
+#endif
+  }
+}
+
+static void glow_blur_columns_cb(void *__restrict userdata,
+                                 const int x,
+                                 const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const GlowBlurData *data = userdata;
+  const float *map = data->src;
+  const float *filter = data->filter;
+  float *temp = data->dst;
+  const int width = data->width;
+  const int height = data->height;
+  const int halfWidth = data->halfWidth;
+  int y, i, fy, index;
+  float curColor[4], curColor2[4];
+
+  /* Do the top & bottom strips */
+  for (y = 0; y < halfWidth; y++) {
+    fy = 0;
+    zero_v4(curColor);
+    zero_v4(curColor2);
+    for (i = y - halfWidth; i < y + halfWidth; i++) {
+      if ((i >= 0) && (i < height)) {
+        /* Bottom */
+        index = (x + i * width) * 4;
+        madd_v4_v4fl(curColor, map + index, filter[fy]);
+
+        /* Top */
+        index = (x + (height - 1 - i) * width) * 4;
+        madd_v4_v4fl(curColor2, map + index, filter[fy]);
+      }
+      fy++;
+    }
+    index = (x + y * width) * 4;
+    copy_v4_v4(temp + index, curColor);
+
+    index = (x + (height - 1 - y) * width) * 4;
+    copy_v4_v4(temp + index, curColor2);
+  }
+
+  /* Do the main body */
+  for (y = halfWidth; y < height - halfWidth; y++) {
+    index = (x + (y - halfWidth) * width) * 4;
+#ifdef __SSE2__
+    __m128 sum = _mm_setzero_ps();
+    for (fy = 0; fy < halfWidth * 2; fy++, index += width * 4) {
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(map + index), _mm_set1_ps(filter[fy])));
+    }
+    _mm_storeu_ps(temp + (x + y * width) * 4, sum);
+#else
+    zero_v4(curColor);
+    for (fy = 0; fy < halfWidth * 2; fy++, index += width * 4) {
+      madd_v4_v4fl(curColor, map + index, filter[fy]);
+    }
+    copy_v4_v4(temp + (x + y * width) * 4, curColor);
+#endif
+  }
+}
+
 static void RVBlurBitmap2_float(float *map, int width, int height, float blur, int quality)
 {
   /* Much better than the previous blur!
@@ -2510,11 +2561,10 @@ static void RVBlurBitmap2_float(float *map, int width, int height, float blur, i
    * Watch out though, it tends to misbehave with large blur values on
    * a small bitmap. Avoid avoid! */
 
-  float *temp = NULL, *swap;
+  float *temp = NULL;
   float *filter = NULL;
-  int x, y, i, fx, fy;
-  int index, ix, halfWidth;
-  float fval, k, curColor[4], curColor2[4], weight = 0;
+  int ix, halfWidth;
+  float fval, k, weight = 0;
 
   /* If we're not really blurring, bail out */
   if (blur <= 0) {
@@ -2559,110 +2609,103 @@ static void RVBlurBitmap2_float(float *map, int width, int height, float blur, i
     filter[ix] /= fval;
   }
 
-  /* Blur the rows */
-  for (y = 0; y < height; y++) {
-    /* Do the left & right strips */
-    for (x = 0; x < halfWidth; x++) {
-      fx = 0;
-      zero_v4(curColor);
-      zero_v4(curColor2);
-
-      for (i = x - halfWidth; i < x + halfWidth; i++) {
-        if ((i >= 0) && (i < width)) {
-          index = (i + y * width) * 4;
-          madd_v4_v4fl(curColor, map + index, filter[fx]);
-
-          index = (width - 1 - i + y * width) * 4;
-          madd_v4_v4fl(curColor2, map + index, filter[fx]);
-        }
-        fx++;
-      }
-      index = (x + y * width) * 4;
-      copy_v4_v4(temp + index, curColor);
-
-      index = (width - 1 - x + y * width) * 4;
-      copy_v4_v4(temp + index, curColor2);
-    }
-
-    /* Do the main body */
-    for (x = halfWidth; x < width - halfWidth; x++) {
-      fx = 0;
-      zero_v4(curColor);
-      for (i = x - halfWidth; i < x + halfWidth; i++) {
-        index = (i + y * width) * 4;
-        madd_v4_v4fl(curColor, map + index, filter[fx]);
-        fx++;
-      }
-      index = (x + y * width) * 4;
-      copy_v4_v4(temp + index, curColor);
-    }
-  }
-
-  /* Swap buffers */
-  swap = temp;
-  temp = map;
-  map = swap;
-
-  /* Blur the columns */
-  for (x = 0; x < width; x++) {
-    /* Do the top & bottom strips */
-    for (y = 0; y < halfWidth; y++) {
-      fy = 0;
-      zero_v4(curColor);
-      zero_v4(curColor2);
-      for (i = y - halfWidth; i < y + halfWidth; i++) {
-        if ((i >= 0) && (i < height)) {
-          /* Bottom */
-          index = (x + i * width) * 4;
-          madd_v4_v4fl(curColor, map + index, filter[fy]);
-
-          /* Top */
-          index = (x + (height - 1 - i) * width) * 4;
-          madd_v4_v4fl(curColor2, map + index, filter[fy]);
-        }
-        fy++;
-      }
-      index = (x + y * width) * 4;
-      copy_v4_v4(temp + index, curColor);
+  GlowBlurData data = {
+      .filter = filter,
+      .width = width,
+      .height = height,
+      .halfWidth = halfWidth,
+  };
 
-      index = (x + (height - 1 - y) * width) * 4;
-      copy_v4_v4(temp + index, curColor2);
-    }
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 8;
 
-    /* Do the main body */
-    for (y = halfWidth; y < height - halfWidth; y++) {
-      fy = 0;
-      zero_v4(curColor);
-      for (i = y - halfWidth; i < y + halfWidth; i++) {
-        index = (x + i * width) * 4;
-        madd_v4_v4fl(curColor, map + index, filter[fy]);
-        fy++;
-      }
-      index = (x + y * width) * 4;
-      copy_v4_v4(temp + index, curColor);
-    }
-  }
+  /* Blur the rows */
+  data.src = map;
+  data.dst = temp;
+  BLI_task_parallel_range(0, height, &data, glow_blur_rows_cb, &settings);
 
-  /* Swap buffers */
-  swap = temp;
-  temp = map; /* map = swap; */ /* UNUSED */
+  /* Blur the columns, back into map. */
+  data.src = temp;
+  data.dst = map;
+  BLI_task_parallel_range(0, width, &data, glow_blur_columns_cb, &settings);
 
   /* Tidy up   */
   MEM_freeN(filter);
   MEM_freeN(temp);
 }
 
+typedef struct GlowBitmapsData {
+  const float *a;
+  const float *b;
+  float *c;
+  int width;
+  float threshold, boost, clamp;
+} GlowBitmapsData;
+
+static void glow_add_bitmaps_cb(void *__restrict userdata,
+                                const int y,
+                                const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const GlowBitmapsData *data = userdata;
+  const float *a = data->a;
+  const float *b = data->b;
+  float *c = data->c;
+  int x, index;
+
+  for (x = 0; x < data->width; x++) {
+    index = (x + y * data->width) * 4;
+    c[index + GlowR] = min_ff(1.0f, a[index + GlowR] + b[index + GlowR]);
+    c[index + GlowG] = min_ff(1.0f, a[index + GlowG] + b[index + GlowG]);
+    c[index + GlowB] = min_ff(1.0f, a[index + GlowB] + b[index + GlowB]);
+    c[index + GlowA] = min_ff(1.0f, a[index + GlowA] + b[index + GlowA]);
+  }
+}
+
 static void RVAddBitmaps_float(float *a, float *b, float *c, int width, int height)
 {
-  int x, y, index;
+  GlowBitmapsData data = {
+      .a = a,
+      .b = b,
+      .c = c,
+      .width = width,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 32;
+  BLI_task_parallel_range(0, height, &data, glow_add_bitmaps_cb, &settings);
+}
+
+static void glow_isolate_highlights_cb(void *__restrict userdata,
+                                       const int y,
+                                       const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const GlowBitmapsData *data = userdata;
+  const float *in = data->a;
+  float *out = data->c;
+  const float threshold = data->threshold;
+  const float boost = data->boost;
+  const float clamp = data->clamp;
+  int x, index;
+  float intensity;
 
-  for (y = 0; y < height; y++) {
-    for (x = 0; x < width; x++) {
-      index = (x + y * width) * 4;
-      c[index + GlowR] = min_ff(1.0f, a[index + GlowR] + b[index + GlowR]);
-      c[index + GlowG] = min_ff(1.0f, a[index + GlowG] + b[index + GlowG]);
-      c[index + GlowB] = min_ff(1.0f, a[index + GlowB] + b[index + GlowB]);
-      c[index + GlowA] = min_ff(1.0f, a[index + GlowA] + b[index + GlowA]);
+  for (x = 0; x < data->width; x++) {
+    index = (x + y * data->width) * 4;
+
+    /* Isolate the intensity */
+    intensity = (in[index + GlowR] + in[index + GlowG] + in[index + GlowB] - threshold);
+    if (intensity > 0) {
+      out[index + GlowR] = min_ff(clamp, (in[index + GlowR] * boost * intensity));
+      out[index + GlowG] = min_ff(clamp, (in[index + GlowG] * boost * intensity));
+      out[index + GlowB] = min_ff(clamp, (in[index + GlowB] * boost * intensity));
+      out[index + GlowA] = min_ff(clamp, (in[index + GlowA] * boost * intensity));
+    }
+    else {
+      out[index + GlowR] = 0;
+      out[index + GlowG] = 0;
+      out[index + GlowB] = 0;
+      out[index + GlowA] = 0;
     }
   }
 }
@@ -2670,29 +2713,19 @@ static void RVAddBitmaps_float(float *a, float *b, float *c, int width, int heig
 static void RVIsolateHighlights_float(
     float *in, float *out, int width, int height, float threshold, float boost, float clamp)
 {
-  int x, y, index;
-  float intensity;
+  GlowBitmapsData data = {
+      .a = in,
+      .c = out,
+      .width = width,
+      .threshold = threshold,
+      .boost = boost,
+      .clamp = clamp,
+  };
 
-  for (y = 0; y < height; y++) {
-    for (x = 0; x < width; x++) {
-      index = (x + y * width) * 4;
-
-      /* Isolate the intensity */
-      intensity = (in[index + GlowR] + in[index + GlowG] + in[index + GlowB] - threshold);
-      if (intensity > 0) {
-        out[index + GlowR] = min_ff(clamp, (in[index + GlowR] * boost * intensity));
-        out[index + GlowG] = min_ff(clamp, (in[index + GlowG] * boost * intensity));
-        out[index + GlowB] = min_ff(clamp, (in[index + GlowB] * boost * intensity));
-        out[index + GlowA] = min_ff(clamp, (in[index + GlowA] * boost * intensity));
-      }
-      else {
-        out[index + GlowR] = 0;
-        out[index + GlowG] = 0;
-        out[index + GlowB] = 0;
-        out[index + GlowA] = 0;
-      }
-    }
-  }
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 32;
+  BLI_task_parallel_range(0, height, &data, glow_isolate_highlights_cb, &settings);
 }
 
 static void init_glow_effect(Sequence *seq)
@@ -3774,6 +3807,8 @@ static ImBuf *do_gaussian_blur_effect(const SeqRenderData *context,
 
 /*********************** text *************************/
 
+static ThreadMutex text_blf_mutex = BLI_MUTEX_INITIALIZER;
+
 static void init_text_effect(Sequence *seq)
 {
   TextVars *data;
@@ -3891,6 +3926,9 @@ static ImBuf *do_text_effect(const SeqRenderData *context,
   int y_ofs, x, y;
   double proxy_size_comp;
 
+  /* Font state is global, text strips of concurrently prefetched frames take turns. */
+  BLI_mutex_lock(&text_blf_mutex);
+
   if (data->text_blf_id == SEQ_FONT_NOT_LOADED) {
     data->text_blf_id = -1;
 
@@ -3978,6 +4016,8 @@ static ImBuf *do_text_effect(const SeqRenderData *context,
 
   BLF_disable(font, BLF_WORD_WRAP);
 
+  BLI_mutex_unlock(&text_blf_mutex);
+
   return out;
 }
 
@@ -4105,7 +4145,6 @@ static struct SeqEffectHandle get_sequence_effect_impl(int seq_type)
       rval.free = free_gammacross;
       rval.early_out = early_out_fade;
       rval.get_default_fac = get_default_fac_fade;
-      rval.init_execution = gammacross_init_execution;
       rval.execute_slice = do_gammacross_effect;
       break;
     case SEQ_TYPE_ADD:
@@ -4168,13 +4207,14 @@ static struct SeqEffectHandle get_sequence_effect_impl(int seq_type)
       rval.execute_slice = do_alphaunder_effect;
       break;
     case SEQ_TYPE_WIPE:
+      rval.multithreaded = true;
       rval.init = init_wipe_effect;
       rval.num_inputs = num_inputs_wipe;
       rval.free = free_wipe_effect;
       rval.copy = copy_wipe_effect;
       rval.early_out = early_out_fade;
       rval.get_default_fac = get_default_fac_fade;
-      rval.execute = do_wipe_effect;
+      rval.execute_slice = do_wipe_effect;
       break;
     case SEQ_TYPE_GLOW:
       rval.init = init_glow_effect;
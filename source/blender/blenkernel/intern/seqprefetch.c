@@ -31,9 +31,11 @@
 #include "DNA_scene_types.h"
 #include "DNA_screen_types.h"
 #include "DNA_sequence_types.h"
+#include "DNA_userdef_types.h"
 #include "DNA_windowmanager_types.h"
 
 #include "BLI_listbase.h"
+#include "BLI_math_base.h"
 #include "BLI_threads.h"
 
 #include "IMB_imbuf.h"
@@ -54,31 +56,53 @@
 #include "DEG_depsgraph_debug.h"
 #include "DEG_depsgraph_query.h"
 
+/* Frames are handed to workers in runs of consecutive frames, so the movie strips of each worker
+ * are read sequentially and can decode ahead, instead of seeking past other workers' frames. */
+#define SEQ_PREFETCH_RUN_LENGTH 8
+
+/* Each worker renders whole frames through its own evaluated copy of the scene. */
+typedef struct PrefetchWorker {
+  struct PrefetchJob *pfjob;
+
+  /* Claimed frames which this worker has not rendered yet, starting at run_cfra. */
+  float run_cfra;
+  int run_num_frames;
+
+  struct Main *bmain_eval;
+  struct Scene *scene_eval;
+  struct Depsgraph *depsgraph;
+  /* The scene changed since the depsgraph was built, the worker rebuilds it before rendering. */
+  bool depsgraph_outdated;
+
+  /* context */
+  struct SeqRenderData context;
+  struct SeqRenderData context_cpy;
+} PrefetchWorker;
+
 typedef struct PrefetchJob {
   struct PrefetchJob *next, *prev;
 
   struct Main *bmain;
-  struct Main *bmain_eval;
   struct Scene *scene;
-  struct Scene *scene_eval;
-  struct Depsgraph *depsgraph;
 
   ThreadMutex prefetch_suspend_mutex;
   ThreadCondition prefetch_suspend_cond;
 
   ListBase threads;
 
-  /* context */
-  struct SeqRenderData context;
-  struct SeqRenderData context_cpy;
-  struct ListBase *seqbasep;
-  struct ListBase *seqbasep_cpy;
+  /* Render settings which the workers take their contexts from. */
+  SeqRenderData context;
+
+  PrefetchWorker workers[SEQ_PREFETCH_WORKERS_MAX];
+  int num_workers;
 
-  /* prefetch area */
+  /* prefetch area, frames are handed to workers in playhead order */
   float cfra;
   int num_frames_prefetched;
 
   /* control */
+  int num_running;
+  int num_waiting;
   bool running;
   bool waiting;
   bool stop;
@@ -165,7 +189,7 @@ SeqRenderData *BKE_sequencer_prefetch_get_original_context(const SeqRenderData *
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(context->scene);
 
-  return &pfjob->context;
+  return &pfjob->workers[context->task_id - SEQ_TASK_PREFETCH_RENDER].context;
 }
 
 static bool seq_prefetch_is_cache_full(Scene *scene)
@@ -192,37 +216,56 @@ void BKE_sequencer_prefetch_get_time_range(Scene *scene, int *start, int *end)
   *end = seq_prefetch_cfra(pfjob);
 }
 
-static void seq_prefetch_free_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_free_depsgraph(PrefetchWorker *worker)
 {
-  if (pfjob->depsgraph != NULL) {
-    DEG_graph_free(pfjob->depsgraph);
+  if (worker->depsgraph != NULL) {
+    DEG_graph_free(worker->depsgraph);
   }
-  pfjob->depsgraph = NULL;
-  pfjob->scene_eval = NULL;
+  worker->depsgraph = NULL;
+  worker->scene_eval = NULL;
 }
 
-static void seq_prefetch_update_depsgraph(PrefetchJob *pfjob)
+static void seq_prefetch_update_depsgraph(PrefetchWorker *worker, float cfra)
 {
-  DEG_evaluate_on_framechange(pfjob->bmain_eval, pfjob->depsgraph, seq_prefetch_cfra(pfjob));
+  DEG_evaluate_on_framechange(worker->bmain_eval, worker->depsgraph, cfra);
 }
 
-static void seq_prefetch_init_depsgraph(PrefetchJob *pfjob)
+/* Depsgraphs are registered globally, so they are only created and freed on the main thread.
+ * Building them is left to the worker threads.
+ *
+ * An outdated depsgraph is created anew: it is registered under bmain_eval, so updates tagged on
+ * the original scene never reach it, and rebuilding it would keep its stale evaluated scene. */
+static void seq_prefetch_init_depsgraph(PrefetchWorker *worker)
 {
-  Main *bmain = pfjob->bmain_eval;
-  Scene *scene = pfjob->scene;
+  Main *bmain = worker->bmain_eval;
+  Scene *scene = worker->pfjob->scene;
   ViewLayer *view_layer = BKE_view_layer_default_render(scene);
 
-  pfjob->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
-  DEG_debug_name_set(pfjob->depsgraph, "SEQUENCER PREFETCH");
+  if (worker->depsgraph != NULL && !worker->depsgraph_outdated &&
+      DEG_get_input_view_layer(worker->depsgraph) == view_layer) {
+    return;
+  }
+
+  seq_prefetch_free_depsgraph(worker);
+  worker->depsgraph = DEG_graph_new(bmain, scene, view_layer, DAG_EVAL_RENDER);
+  DEG_debug_name_set(worker->depsgraph, "SEQUENCER PREFETCH");
+  worker->depsgraph_outdated = true;
+}
+
+static void seq_prefetch_build_depsgraph(PrefetchWorker *worker)
+{
+  Main *bmain = worker->bmain_eval;
+  Scene *scene = worker->pfjob->scene;
 
   /* Make sure there is a correct evaluated scene pointer. */
-  DEG_graph_build_for_render_pipeline(pfjob->depsgraph, bmain, scene, view_layer);
+  DEG_graph_build_for_render_pipeline(
+      worker->depsgraph, bmain, scene, DEG_get_input_view_layer(worker->depsgraph));
 
   /* Update immediately so we have proper evaluated scene. */
-  seq_prefetch_update_depsgraph(pfjob);
+  seq_prefetch_update_depsgraph(worker, seq_prefetch_cfra(worker->pfjob));
 
-  pfjob->scene_eval = DEG_get_evaluated_scene(pfjob->depsgraph);
-  pfjob->scene_eval->ed->cache_flag = 0;
+  worker->scene_eval = DEG_get_evaluated_scene(worker->depsgraph);
+  worker->scene_eval->ed->cache_flag = 0;
 }
 
 static void seq_prefetch_update_area(PrefetchJob *pfjob)
@@ -270,64 +313,87 @@ void BKE_sequencer_prefetch_stop(Scene *scene)
   pfjob->stop = true;
 
   while (pfjob->running) {
-    BLI_condition_notify_one(&pfjob->prefetch_suspend_cond);
+    BLI_condition_notify_all(&pfjob->prefetch_suspend_cond);
+  }
+
+  /* Depsgraphs are kept when prefetching restarts at another frame, stopping is what tells the
+   * scene changed and they have to be created anew. */
+  for (int i = 0; i < SEQ_PREFETCH_WORKERS_MAX; i++) {
+    pfjob->workers[i].depsgraph_outdated = true;
   }
 }
 
-static void seq_prefetch_update_context(const SeqRenderData *context)
+static void seq_prefetch_update_context(PrefetchWorker *worker)
 {
-  PrefetchJob *pfjob;
-  pfjob = seq_prefetch_job_get(context->scene);
+  PrefetchJob *pfjob = worker->pfjob;
+  const SeqRenderData *context = &pfjob->context;
+  const eSeqTaskId task_id = SEQ_TASK_PREFETCH_RENDER + (int)(worker - pfjob->workers);
 
-  BKE_sequencer_new_render_data(pfjob->bmain_eval,
-                                pfjob->depsgraph,
-                                pfjob->scene_eval,
+  BKE_sequencer_new_render_data(worker->bmain_eval,
+                                worker->depsgraph,
+                                worker->scene_eval,
                                 context->rectx,
                                 context->recty,
                                 context->preview_render_size,
                                 false,
-                                &pfjob->context_cpy);
-  pfjob->context_cpy.is_prefetch_render = true;
-  pfjob->context_cpy.task_id = SEQ_TASK_PREFETCH_RENDER;
+                                &worker->context_cpy);
+  worker->context_cpy.is_prefetch_render = true;
+  worker->context_cpy.task_id = task_id;
 
   BKE_sequencer_new_render_data(pfjob->bmain,
-                                pfjob->depsgraph,
+                                worker->depsgraph,
                                 pfjob->scene,
                                 context->rectx,
                                 context->recty,
                                 context->preview_render_size,
                                 false,
-                                &pfjob->context);
-  pfjob->context.is_prefetch_render = false;
+                                &worker->context);
+  worker->context.is_prefetch_render = false;
 
   /* Same ID as prefetch context, because context will be swapped, but we still
    * want to assign this ID to cache entries created in this thread.
-   * This is to allow "temp cache" work correctly for both threads.
+   * This is to allow "temp cache" work correctly for all threads.
    */
-  pfjob->context.task_id = SEQ_TASK_PREFETCH_RENDER;
+  worker->context.task_id = task_id;
 }
 
-static void seq_prefetch_update_scene(Scene *scene)
+/* Runs in the worker thread, so depsgraphs are not built and evaluated one after another on the
+ * main thread whenever prefetching starts. */
+static void seq_prefetch_update_scene(PrefetchWorker *worker)
 {
-  PrefetchJob *pfjob = seq_prefetch_job_get(scene);
-
-  if (!pfjob) {
-    return;
+  if (worker->depsgraph_outdated) {
+    seq_prefetch_build_depsgraph(worker);
+    worker->depsgraph_outdated = false;
   }
-
-  seq_prefetch_free_depsgraph(pfjob);
-  seq_prefetch_init_depsgraph(pfjob);
+  seq_prefetch_update_context(worker);
 }
 
 static void seq_prefetch_resume(Scene *scene)
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(scene);
 
-  if (pfjob && pfjob->waiting) {
-    BLI_condition_notify_one(&pfjob->prefetch_suspend_cond);
+  if (pfjob && pfjob->num_waiting) {
+    BLI_condition_notify_all(&pfjob->prefetch_suspend_cond);
   }
 }
 
+/* Every worker keeps the intermediate images of the frame it renders alive, so the number of
+ * workers is bounded by a quarter of the cache budget as well as by the available cores. */
+static int seq_prefetch_num_workers_get(const SeqRenderData *context)
+{
+  const size_t frame_size = (size_t)context->rectx * context->recty * 4 * sizeof(float);
+  const size_t budget = (size_t)U.memcachelimit * 1024 * 1024 / 4;
+  const int max_workers = min_ii(SEQ_PREFETCH_WORKERS_MAX, BLI_system_thread_count() - 1);
+  int num_workers = max_workers;
+
+  if (frame_size > 0) {
+    const size_t num_fit = budget / (frame_size * 4);
+    num_workers = (num_fit < (size_t)max_workers) ? (int)num_fit : max_workers;
+  }
+
+  return max_ii(num_workers, 1);
+}
+
 void BKE_sequencer_prefetch_free(Scene *scene)
 {
   PrefetchJob *pfjob = seq_prefetch_job_get(scene);
@@ -337,24 +403,26 @@ void BKE_sequencer_prefetch_free(Scene *scene)
 
   BKE_sequencer_prefetch_stop(scene);
 
-  BLI_threadpool_remove(&pfjob->threads, pfjob);
+  for (int i = 0; i < SEQ_PREFETCH_WORKERS_MAX; i++) {
+    BLI_threadpool_remove(&pfjob->threads, &pfjob->workers[i]);
+  }
   BLI_threadpool_end(&pfjob->threads);
   BLI_mutex_end(&pfjob->prefetch_suspend_mutex);
   BLI_condition_end(&pfjob->prefetch_suspend_cond);
-  seq_prefetch_free_depsgraph(pfjob);
-  BKE_main_free(pfjob->bmain_eval);
+  for (int i = 0; i < SEQ_PREFETCH_WORKERS_MAX; i++) {
+    seq_prefetch_free_depsgraph(&pfjob->workers[i]);
+    BKE_main_free(pfjob->workers[i].bmain_eval);
+  }
   MEM_freeN(pfjob);
   scene->ed->prefetch_job = NULL;
 }
 
-static bool seq_prefetch_do_skip_frame(Scene *scene)
+static bool seq_prefetch_do_skip_frame(PrefetchWorker *worker, float cfra)
 {
-  Editing *ed = scene->ed;
-  PrefetchJob *pfjob = seq_prefetch_job_get(scene);
-  float cfra = seq_prefetch_cfra(pfjob);
+  Editing *ed = worker->pfjob->scene->ed;
   Sequence *seq_arr[MAXSEQ + 1];
   int count = BKE_sequencer_get_shown_sequences(ed->seqbasep, cfra, 0, seq_arr);
-  SeqRenderData *ctx = &pfjob->context_cpy;
+  SeqRenderData *ctx = &worker->context_cpy;
   ImBuf *ibuf = NULL;
 
   /* Disable prefetching 3D scene strips, but check for disk cache. */
@@ -418,28 +486,67 @@ static void seq_prefetch_do_suspend(PrefetchJob *pfjob)
   BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
   while (seq_prefetch_need_suspend(pfjob) &&
          (pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) && !pfjob->stop) {
-    pfjob->waiting = true;
+    pfjob->num_waiting++;
+    pfjob->waiting = (pfjob->num_waiting == pfjob->num_running);
     BLI_condition_wait(&pfjob->prefetch_suspend_cond, &pfjob->prefetch_suspend_mutex);
+    pfjob->num_waiting--;
+    pfjob->waiting = false;
     seq_prefetch_update_area(pfjob);
   }
-  pfjob->waiting = false;
   BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
 }
 
-static void *seq_prefetch_frames(void *job)
+/* Hand out the next frame of the worker's run, claiming a new run after the last frame which no
+ * worker has taken yet when the previous one is done. */
+static bool seq_prefetch_claim_frame(PrefetchWorker *worker, float *r_cfra)
+{
+  PrefetchJob *pfjob = worker->pfjob;
+  bool claimed = false;
+
+  BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
+  seq_prefetch_update_area(pfjob);
+
+  /* Drop the rest of the run when the playhead passed it or jumped back before it. */
+  if (worker->run_num_frames > 0 &&
+      (worker->run_cfra < pfjob->cfra || worker->run_cfra >= seq_prefetch_cfra(pfjob))) {
+    worker->run_num_frames = 0;
+  }
+
+  if ((pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) && !pfjob->stop) {
+    if (worker->run_num_frames == 0 && seq_prefetch_cfra(pfjob) <= pfjob->scene->r.efra) {
+      worker->run_cfra = seq_prefetch_cfra(pfjob);
+      worker->run_num_frames = min_ii(SEQ_PREFETCH_RUN_LENGTH,
+                                      pfjob->scene->r.efra - (int)worker->run_cfra + 1);
+      pfjob->num_frames_prefetched += worker->run_num_frames;
+    }
+
+    if (worker->run_num_frames > 0) {
+      *r_cfra = worker->run_cfra;
+      worker->run_cfra += 1.0f;
+      worker->run_num_frames--;
+      claimed = true;
+    }
+  }
+  BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
+
+  return claimed;
+}
+
+static void *seq_prefetch_frames(void *worker_v)
 {
-  PrefetchJob *pfjob = (PrefetchJob *)job;
+  PrefetchWorker *worker = (PrefetchWorker *)worker_v;
+  PrefetchJob *pfjob = worker->pfjob;
+  float cfra;
+
+  seq_prefetch_update_scene(worker);
 
-  while (seq_prefetch_cfra(pfjob) <= pfjob->scene->r.efra) {
-    pfjob->scene_eval->ed->prefetch_job = NULL;
+  while (seq_prefetch_claim_frame(worker, &cfra)) {
+    worker->scene_eval->ed->prefetch_job = NULL;
 
-    seq_prefetch_update_depsgraph(pfjob);
-    AnimData *adt = BKE_animdata_from_id(&pfjob->context_cpy.scene->id);
-    BKE_animsys_evaluate_animdata(&pfjob->context_cpy.scene->id,
-                                  adt,
-                                  seq_prefetch_cfra(pfjob),
-                                  ADT_RECALC_ALL,
-                                  false);
+    seq_prefetch_update_depsgraph(worker, cfra);
+    AnimData *adt = BKE_animdata_from_id(&worker->context_cpy.scene->id);
+    BKE_animsys_evaluate_animdata(
+        &worker->context_cpy.scene->id, adt, cfra, ADT_RECALC_ALL, false);
 
     /* This is quite hacky solution:
      * We need cross-reference original scene with copy for cache.
@@ -447,16 +554,14 @@ static void *seq_prefetch_frames(void *job)
      * Scene copy don't reference original scene. Perhaps, this could be done by depsgraph.
      * Set to NULL before return!
      */
-    pfjob->scene_eval->ed->prefetch_job = pfjob;
+    worker->scene_eval->ed->prefetch_job = pfjob;
 
-    if (seq_prefetch_do_skip_frame(pfjob->scene)) {
-      pfjob->num_frames_prefetched++;
+    if (seq_prefetch_do_skip_frame(worker, cfra)) {
       continue;
     }
 
-    ImBuf *ibuf = BKE_sequencer_give_ibuf(&pfjob->context_cpy, seq_prefetch_cfra(pfjob), 0);
-    BKE_sequencer_cache_free_temp_cache(
-        pfjob->scene, pfjob->context.task_id, seq_prefetch_cfra(pfjob));
+    ImBuf *ibuf = BKE_sequencer_give_ibuf(&worker->context_cpy, cfra, 0);
+    BKE_sequencer_cache_free_temp_cache(pfjob->scene, worker->context.task_id, cfra);
     IMB_freeImBuf(ibuf);
 
     /* Suspend thread if there is nothing to be prefetched. */
@@ -467,19 +572,16 @@ static void *seq_prefetch_frames(void *job)
         (seq_prefetch_cfra(pfjob) - pfjob->scene->r.cfra) < 2) {
       break;
     }
-
-    if (!(pfjob->scene->ed->cache_flag & SEQ_CACHE_PREFETCH_ENABLE) || pfjob->stop) {
-      break;
-    }
-
-    seq_prefetch_update_area(pfjob);
-    pfjob->num_frames_prefetched++;
   }
 
   BKE_sequencer_cache_free_temp_cache(
-      pfjob->scene, pfjob->context.task_id, seq_prefetch_cfra(pfjob));
-  pfjob->running = false;
-  pfjob->scene_eval->ed->prefetch_job = NULL;
+      pfjob->scene, worker->context.task_id, seq_prefetch_cfra(pfjob));
+  worker->scene_eval->ed->prefetch_job = NULL;
+
+  BLI_mutex_lock(&pfjob->prefetch_suspend_mutex);
+  pfjob->num_running--;
+  pfjob->running = (pfjob->num_running > 0);
+  BLI_mutex_unlock(&pfjob->prefetch_suspend_mutex);
 
   return 0;
 }
@@ -493,29 +595,50 @@ static PrefetchJob *seq_prefetch_start(const SeqRenderData *context, float cfra)
       pfjob = (PrefetchJob *)MEM_callocN(sizeof(PrefetchJob), "PrefetchJob");
       context->scene->ed->prefetch_job = pfjob;
 
-      BLI_threadpool_init(&pfjob->threads, seq_prefetch_frames, 1);
+      BLI_threadpool_init(&pfjob->threads, seq_prefetch_frames, SEQ_PREFETCH_WORKERS_MAX);
       BLI_mutex_init(&pfjob->prefetch_suspend_mutex);
       BLI_condition_init(&pfjob->prefetch_suspend_cond);
 
       pfjob->bmain = context->bmain;
-      pfjob->bmain_eval = BKE_main_new();
-
       pfjob->scene = context->scene;
-      seq_prefetch_init_depsgraph(pfjob);
+
+      for (int i = 0; i < SEQ_PREFETCH_WORKERS_MAX; i++) {
+        pfjob->workers[i].pfjob = pfjob;
+        pfjob->workers[i].bmain_eval = BKE_main_new();
+      }
     }
   }
-  seq_prefetch_update_scene(context->scene);
-  seq_prefetch_update_context(context);
+
+  for (int i = 0; i < SEQ_PREFETCH_WORKERS_MAX; i++) {
+    BLI_threadpool_remove(&pfjob->threads, &pfjob->workers[i]);
+  }
 
   pfjob->cfra = cfra;
   pfjob->num_frames_prefetched = 1;
+  pfjob->num_workers = seq_prefetch_num_workers_get(context);
+  pfjob->context = *context;
 
+  for (int i = 0; i < SEQ_PREFETCH_WORKERS_MAX; i++) {
+    PrefetchWorker *worker = &pfjob->workers[i];
+    worker->run_num_frames = 0;
+
+    if (i < pfjob->num_workers) {
+      seq_prefetch_init_depsgraph(worker);
+    }
+    else {
+      seq_prefetch_free_depsgraph(worker);
+    }
+  }
+
+  pfjob->num_waiting = 0;
+  pfjob->num_running = pfjob->num_workers;
   pfjob->waiting = false;
   pfjob->stop = false;
   pfjob->running = true;
 
-  BLI_threadpool_remove(&pfjob->threads, pfjob);
-  BLI_threadpool_insert(&pfjob->threads, pfjob);
+  for (int i = 0; i < pfjob->num_workers; i++) {
+    BLI_threadpool_insert(&pfjob->threads, &pfjob->workers[i]);
+  }
 
   return pfjob;
 }
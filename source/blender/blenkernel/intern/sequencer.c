@@ -48,6 +48,7 @@
 #include "BLI_path_util.h"
 #include "BLI_string.h"
 #include "BLI_string_utf8.h"
+#include "BLI_task.h"
 #include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
@@ -94,6 +95,10 @@
 
 #include "RE_engine.h"
 
+#include "PIL_time.h"
+
+#include "atomic_ops.h"
+
 #ifdef WITH_AUDASPACE
 #  include <AUD_Special.h>
 #endif
@@ -125,7 +130,11 @@ static ImBuf *seq_render_mask(const SeqRenderData *context, Mask *mask, float nr
 static int seq_num_files(Scene *scene, char views_format, const bool is_multiview);
 static void seq_anim_add_suffix(Scene *scene, struct anim *anim, const int view_id);
 
-static ThreadMutex seq_render_mutex = BLI_MUTEX_INITIALIZER;
+/* Main renders are exclusive, prefetch workers render their own scene copies side by side.
+ * Every render passes the gate before locking, and a main render keeps it until it gets the lock,
+ * so workers can't keep a waiting main render out by taking turns on the read lock. */
+static ThreadRWMutex seq_render_mutex = BLI_RWLOCK_INITIALIZER;
+static ThreadMutex seq_render_gate_mutex = BLI_MUTEX_INITIALIZER;
 
 /* **** XXX ******** */
 #define SELECT 1
@@ -1999,7 +2008,7 @@ static void seq_proxy_build_frame(const SeqRenderData *context,
     ibuf = IMB_dupImBuf(ibuf_tmp);
     IMB_metadata_copy(ibuf, ibuf_tmp);
     IMB_freeImBuf(ibuf_tmp);
-    IMB_scalefastImBuf(ibuf, (short)rectx, (short)recty);
+    IMB_scaleImBuf_filtered(ibuf, (short)rectx, (short)recty, IMB_SCALE_FILTER_BILINEAR);
   }
   else {
     ibuf = ibuf_tmp;
@@ -2246,6 +2255,82 @@ void BKE_sequencer_proxy_rebuild(SeqIndexBuildContext *context,
   }
 }
 
+typedef struct SeqProxyBuildQueue {
+  short *stop;
+  unsigned int num_done;
+} SeqProxyBuildQueue;
+
+typedef struct SeqProxyBuildTask {
+  SeqIndexBuildContext *context;
+  short do_update;
+  float progress;
+} SeqProxyBuildTask;
+
+static void seq_proxy_rebuild_task(TaskPool *__restrict pool, void *taskdata)
+{
+  SeqProxyBuildQueue *queue = BLI_task_pool_user_data(pool);
+  SeqProxyBuildTask *task = taskdata;
+
+  if (!*queue->stop && !G.is_break) {
+    BKE_sequencer_proxy_rebuild(task->context, queue->stop, &task->do_update, &task->progress);
+  }
+
+  task->progress = 1.0f;
+  atomic_add_and_fetch_u(&queue->num_done, 1);
+}
+
+/* Rebuild every context of the queue. Movie strips decode through their own anim handles and
+ * are built concurrently, bounded by the task scheduler threads. Other strips render through
+ * the sequencer and are built one after another. */
+void BKE_sequencer_proxy_rebuild_queue(ListBase *queue,
+                                       short *stop,
+                                       short *do_update,
+                                       float *progress)
+{
+  const int num_contexts = BLI_listbase_count(queue);
+  SeqProxyBuildQueue build_queue = {stop, 0};
+  SeqProxyBuildTask *tasks;
+  TaskPool *movie_pool, *render_pool;
+  int i = 0;
+
+  if (num_contexts == 0) {
+    return;
+  }
+
+  tasks = MEM_calloc_arrayN(num_contexts, sizeof(*tasks), "seq proxy build tasks");
+  movie_pool = BLI_task_pool_create_background(&build_queue, TASK_PRIORITY_LOW);
+  render_pool = BLI_task_pool_create_background_serial(&build_queue, TASK_PRIORITY_LOW);
+
+  LISTBASE_FOREACH (LinkData *, link, queue) {
+    SeqIndexBuildContext *context = link->data;
+    TaskPool *pool = (context->seq->type == SEQ_TYPE_MOVIE) ? movie_pool : render_pool;
+
+    tasks[i].context = context;
+    BLI_task_pool_push(pool, seq_proxy_rebuild_task, &tasks[i], false, NULL);
+    i++;
+  }
+
+  while (atomic_add_and_fetch_u(&build_queue.num_done, 0) < (unsigned int)num_contexts) {
+    float total_progress = 0.0f;
+
+    for (i = 0; i < num_contexts; i++) {
+      total_progress += tasks[i].progress;
+    }
+
+    *progress = total_progress / num_contexts;
+    *do_update = true;
+
+    PIL_sleep_ms(50);
+  }
+
+  BLI_task_pool_work_and_wait(movie_pool);
+  BLI_task_pool_work_and_wait(render_pool);
+  BLI_task_pool_free(movie_pool);
+  BLI_task_pool_free(render_pool);
+
+  MEM_freeN(tasks);
+}
+
 void BKE_sequencer_proxy_rebuild_finish(SeqIndexBuildContext *context, bool stop)
 {
   if (context->index_context) {
@@ -2809,7 +2894,8 @@ static ImBuf *input_preprocess(const SeqRenderData *context,
 
   if (ibuf->x != context->rectx || ibuf->y != context->recty) {
     if (context->for_render) {
-      IMB_scaleImBuf(ibuf, (short)context->rectx, (short)context->recty);
+      IMB_scaleImBuf_filtered(
+          ibuf, (short)context->rectx, (short)context->recty, IMB_SCALE_FILTER_BILINEAR);
     }
     else {
       IMB_scalefastImBuf(ibuf, (short)context->rectx, (short)context->recty);
@@ -4089,7 +4175,10 @@ ImBuf *BKE_sequencer_give_ibuf(const SeqRenderData *context, float cfra, int cha
   float cost = 0;
 
   if (count && !out) {
-    BLI_mutex_lock(&seq_render_mutex);
+    BLI_mutex_lock(&seq_render_gate_mutex);
+    BLI_rw_mutex_lock(&seq_render_mutex,
+                      context->is_prefetch_render ? THREAD_LOCK_READ : THREAD_LOCK_WRITE);
+    BLI_mutex_unlock(&seq_render_gate_mutex);
     out = seq_render_strip_stack(context, &state, seqbasep, cfra, chanshown);
     cost = seq_estimate_render_cost_end(context->scene, begin);
 
@@ -4101,7 +4190,7 @@ ImBuf *BKE_sequencer_give_ibuf(const SeqRenderData *context, float cfra, int cha
       BKE_sequencer_cache_put_if_possible(
           context, seq_arr[count - 1], cfra, SEQ_CACHE_STORE_FINAL_OUT, out, cost, false);
     }
-    BLI_mutex_unlock(&seq_render_mutex);
+    BLI_rw_mutex_unlock(&seq_render_mutex);
   }
 
   BKE_sequencer_prefetch_start(context, cfra, cost);
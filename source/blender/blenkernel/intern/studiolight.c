@@ -410,10 +410,36 @@ static void studiolight_multilayer_addpass(void *base,
   }
 }
 
+typedef struct MultilayerReadFilterData {
+  bool has_diffuse_pass;
+  bool has_specular_pass;
+} MultilayerReadFilterData;
+
+/* Only read the first diffuse and specular passes, the other ones are never used. */
+static bool studiolight_multilayer_read_filter(void *userdata,
+                                               const char *UNUSED(layname),
+                                               const char *pass_name,
+                                               const char *UNUSED(chan_id))
+{
+  MultilayerReadFilterData *data = userdata;
+  if (!data->has_diffuse_pass && STREQ(pass_name, STUDIOLIGHT_PASSNAME_DIFFUSE)) {
+    data->has_diffuse_pass = true;
+    return true;
+  }
+  if (!data->has_specular_pass && STREQ(pass_name, STUDIOLIGHT_PASSNAME_SPECULAR)) {
+    data->has_specular_pass = true;
+    return true;
+  }
+  return false;
+}
+
 static void studiolight_load_equirect_image(StudioLight *sl)
 {
   if (sl->flag & STUDIOLIGHT_EXTERNAL_FILE) {
+    MultilayerReadFilterData filter_data = {false, false};
+    IMB_exr_read_filter(studiolight_multilayer_read_filter, &filter_data);
     ImBuf *ibuf = IMB_loadiffname(sl->path, IB_multilayer, NULL);
+    IMB_exr_read_filter(NULL, NULL);
     ImBuf *specular_ibuf = NULL;
     ImBuf *diffuse_ibuf = NULL;
     const bool failed = (ibuf == NULL);
@@ -27,8 +27,13 @@
 #include "DNA_meshdata_types.h"
 #include "DNA_modifier_types.h"
 
+#include "BLI_hash_mm2a.h"
+#include "BLI_listbase.h"
+#include "BLI_math_base.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
+#include "MEM_CacheLimiterC-Api.h"
 #include "MEM_guardedalloc.h"
 
 #include "subdiv_converter.h"
@@ -40,13 +45,18 @@
 
 /* =================----====--===== MODULE ==========================------== */
 
+static void subdiv_topology_cache_enable(const bool is_enabled);
+
 void BKE_subdiv_init()
 {
   openSubdiv_init();
+  subdiv_topology_cache_enable(true);
 }
 
 void BKE_subdiv_exit()
 {
+  subdiv_topology_cache_enable(false);
+  BKE_subdiv_topology_cache_clear();
   openSubdiv_cleanup();
 }
 
@@ -104,6 +114,250 @@ bool BKE_subdiv_settings_equal(const SubdivSettings *settings_a, const SubdivSet
           settings_a->fvar_linear_interpolation == settings_b->fvar_linear_interpolation);
 }
 
+/* ============================= TOPOLOGY CACHE ============================= */
+
+/* Descriptors freed by their owner are kept here so that a later update with the same topology
+ * re-uses their topology refiner and evaluator (including stencil and patch tables). Typical
+ * cases are modifier runtime data being re-created, and objects sharing the same topology which
+ * are evaluated one after another. A cached descriptor is used by one owner at a time, since the
+ * evaluator holds the coarse positions of its owner. */
+
+/* Memory budget of the descriptors which are not used by anyone, at most this much and a quarter
+ * of the memory cache limit preference. */
+#define SUBDIV_TOPOLOGY_CACHE_MEMORY_LIMIT ((size_t)256 * 1024 * 1024)
+/* Rough estimate of memory used by the base level of topology refiner per component, when the
+ * topology is not refined by an evaluator yet. */
+#define SUBDIV_TOPOLOGY_CACHE_BYTES_PER_BASE_ELEMENT 32
+
+typedef struct SubdivTopologyCacheEntry {
+  struct SubdivTopologyCacheEntry *next, *prev;
+  Subdiv *subdiv;
+  size_t memory;
+} SubdivTopologyCacheEntry;
+
+static struct {
+  /* Most recently freed descriptors first. */
+  ListBase entries;
+  size_t memory;
+  /* Only enabled between module initialization and exit. */
+  bool is_enabled;
+} topology_cache = {{NULL}};
+static ThreadMutex topology_cache_lock = BLI_MUTEX_INITIALIZER;
+
+static void subdiv_free_data(Subdiv *subdiv);
+
+static uint32_t subdiv_converter_topology_hash(OpenSubdiv_Converter *converter)
+{
+  BLI_HashMurmur2A mm2;
+  BLI_hash_mm2a_init(&mm2, 0);
+  BLI_hash_mm2a_add_int(&mm2, converter->getSchemeType(converter));
+  BLI_hash_mm2a_add_int(&mm2, converter->getVtxBoundaryInterpolation(converter));
+  BLI_hash_mm2a_add_int(&mm2, converter->getFVarLinearInterpolation(converter));
+  const int num_faces = converter->getNumFaces(converter);
+  const int num_edges = converter->getNumEdges(converter);
+  const int num_vertices = converter->getNumVertices(converter);
+  BLI_hash_mm2a_add_int(&mm2, num_faces);
+  BLI_hash_mm2a_add_int(&mm2, num_edges);
+  BLI_hash_mm2a_add_int(&mm2, num_vertices);
+  /* Faces. */
+  int *face_vertices = NULL;
+  int face_vertices_len = 0;
+  for (int face_index = 0; face_index < num_faces; face_index++) {
+    const int num_face_vertices = converter->getNumFaceVertices(converter, face_index);
+    if (num_face_vertices > face_vertices_len) {
+      face_vertices_len = num_face_vertices;
+      face_vertices = MEM_reallocN(face_vertices, sizeof(int) * face_vertices_len);
+    }
+    converter->getFaceVertices(converter, face_index, face_vertices);
+    BLI_hash_mm2a_add_int(&mm2, num_face_vertices);
+    BLI_hash_mm2a_add(
+        &mm2, (const unsigned char *)face_vertices, sizeof(int) * (size_t)num_face_vertices);
+  }
+  MEM_SAFE_FREE(face_vertices);
+  /* Edges and creases. */
+  for (int edge_index = 0; edge_index < num_edges; edge_index++) {
+    int edge_vertices[2];
+    converter->getEdgeVertices(converter, edge_index, edge_vertices);
+    const float sharpness = converter->getEdgeSharpness(converter, edge_index);
+    BLI_hash_mm2a_add(&mm2, (const unsigned char *)edge_vertices, sizeof(edge_vertices));
+    BLI_hash_mm2a_add(&mm2, (const unsigned char *)&sharpness, sizeof(sharpness));
+  }
+  for (int vertex_index = 0; vertex_index < num_vertices; vertex_index++) {
+    const float sharpness = converter->isInfiniteSharpVertex(converter, vertex_index) ?
+                                -1.0f :
+                                converter->getVertexSharpness(converter, vertex_index);
+    BLI_hash_mm2a_add(&mm2, (const unsigned char *)&sharpness, sizeof(sharpness));
+  }
+  /* Face-varying topology is not hashed: gathering it requires the UV layers to be
+   * pre-calculated, which is as expensive as creating the topology refiner. Descriptors which
+   * only differ in UV topology are told apart by the full comparison. */
+  BLI_hash_mm2a_add_int(&mm2, converter->getNumUVLayers(converter));
+  return BLI_hash_mm2a_end(&mm2);
+}
+
+static size_t subdiv_topology_cache_memory_estimate(const Subdiv *subdiv)
+{
+  /* The evaluator refines the topology (adaptively, unless disabled in the settings), its size
+   * is measured from the actual refined levels and patch tables. */
+  OpenSubdiv_Evaluator *evaluator = subdiv->evaluator;
+  if (evaluator != NULL) {
+    return evaluator->getMemoryUsage(evaluator);
+  }
+  OpenSubdiv_TopologyRefiner *topology_refiner = subdiv->topology_refiner;
+  const size_t num_base_elements = (size_t)topology_refiner->getNumVertices(topology_refiner) +
+                                   (size_t)topology_refiner->getNumEdges(topology_refiner) +
+                                   (size_t)topology_refiner->getNumFaces(topology_refiner);
+  return num_base_elements * SUBDIV_TOPOLOGY_CACHE_BYTES_PER_BASE_ELEMENT;
+}
+
+static size_t subdiv_topology_cache_memory_limit(void)
+{
+  /* Like the cache limiter, zero means the preference doesn't limit the memory. */
+  const size_t memcache_limit = MEM_CacheLimiter_get_maximum();
+  if (memcache_limit == 0) {
+    return SUBDIV_TOPOLOGY_CACHE_MEMORY_LIMIT;
+  }
+  return min_zz(SUBDIV_TOPOLOGY_CACHE_MEMORY_LIMIT, memcache_limit / 4);
+}
+
+/* Free least recently cached descriptors until the cache fits its memory budget.
+ * Must be called with the cache locked. */
+static void subdiv_topology_cache_trim_locked(ListBase *r_freed)
+{
+  const size_t memory_limit = subdiv_topology_cache_memory_limit();
+  while (topology_cache.memory > memory_limit) {
+    SubdivTopologyCacheEntry *entry = topology_cache.entries.last;
+    BLI_remlink(&topology_cache.entries, entry);
+    topology_cache.memory -= entry->memory;
+    BLI_addtail(r_freed, entry);
+  }
+}
+
+static void subdiv_topology_cache_entries_free(ListBase *entries)
+{
+  LISTBASE_FOREACH_MUTABLE (SubdivTopologyCacheEntry *, entry, entries) {
+    subdiv_free_data(entry->subdiv);
+    MEM_freeN(entry);
+  }
+  BLI_listbase_clear(entries);
+}
+
+/* Returns true when the descriptor is now owned by the cache. */
+static bool subdiv_topology_cache_add(Subdiv *subdiv)
+{
+  if (!subdiv->use_topology_cache || subdiv->topology_refiner == NULL) {
+    return false;
+  }
+  const size_t memory = subdiv_topology_cache_memory_estimate(subdiv);
+  if (memory > subdiv_topology_cache_memory_limit()) {
+    return false;
+  }
+  ListBase freed = {NULL, NULL};
+  BLI_mutex_lock(&topology_cache_lock);
+  if (!topology_cache.is_enabled) {
+    BLI_mutex_unlock(&topology_cache_lock);
+    return false;
+  }
+  /* Displacement belongs to the owner, not to the topology. */
+  BKE_subdiv_displacement_detach(subdiv);
+  SubdivTopologyCacheEntry *entry = MEM_mallocN(sizeof(*entry), __func__);
+  entry->subdiv = subdiv;
+  entry->memory = memory;
+  BLI_addhead(&topology_cache.entries, entry);
+  topology_cache.memory += memory;
+  subdiv_topology_cache_trim_locked(&freed);
+  BLI_mutex_unlock(&topology_cache_lock);
+  /* Freeing OpenSubdiv data is not cheap, do it outside of the lock. */
+  subdiv_topology_cache_entries_free(&freed);
+  return true;
+}
+
+/* Take descriptor with the given settings and topology out of the cache.
+ * Returns NULL if there is none. */
+static Subdiv *subdiv_topology_cache_take(const SubdivSettings *settings,
+                                          OpenSubdiv_Converter *converter,
+                                          const uint32_t topology_hash)
+{
+  /* Take all candidates out of the cache first, so the full topology comparison (which is as
+   * expensive as the mesh is large) doesn't block other threads using the cache. */
+  ListBase candidates = {NULL, NULL};
+  BLI_mutex_lock(&topology_cache_lock);
+  LISTBASE_FOREACH_MUTABLE (SubdivTopologyCacheEntry *, entry, &topology_cache.entries) {
+    Subdiv *subdiv_iter = entry->subdiv;
+    if (subdiv_iter->topology_hash == topology_hash &&
+        BKE_subdiv_settings_equal(&subdiv_iter->settings, settings)) {
+      BLI_remlink(&topology_cache.entries, entry);
+      topology_cache.memory -= entry->memory;
+      BLI_addtail(&candidates, entry);
+    }
+  }
+  BLI_mutex_unlock(&topology_cache_lock);
+
+  if (BLI_listbase_is_empty(&candidates)) {
+    return NULL;
+  }
+
+  /* Hash collisions are possible (and descriptors which only differ in UV topology have the
+   * same hash), verify the actual topology. */
+  Subdiv *subdiv = NULL;
+  LISTBASE_FOREACH (SubdivTopologyCacheEntry *, entry, &candidates) {
+    Subdiv *subdiv_iter = entry->subdiv;
+    BKE_subdiv_stats_begin(&subdiv_iter->stats, SUBDIV_STATS_TOPOLOGY_COMPARE);
+    const bool is_topology_equal = openSubdiv_topologyRefinerCompareWithConverter(
+        subdiv_iter->topology_refiner, converter);
+    BKE_subdiv_stats_end(&subdiv_iter->stats, SUBDIV_STATS_TOPOLOGY_COMPARE);
+    if (is_topology_equal) {
+      BLI_remlink(&candidates, entry);
+      MEM_freeN(entry);
+      subdiv = subdiv_iter;
+      break;
+    }
+  }
+
+  /* Put the other candidates back, keeping their order. */
+  ListBase freed = {NULL, NULL};
+  BLI_mutex_lock(&topology_cache_lock);
+  if (topology_cache.is_enabled) {
+    LISTBASE_FOREACH_BACKWARD_MUTABLE (SubdivTopologyCacheEntry *, entry, &candidates) {
+      BLI_remlink(&candidates, entry);
+      BLI_addhead(&topology_cache.entries, entry);
+      topology_cache.memory += entry->memory;
+    }
+    subdiv_topology_cache_trim_locked(&freed);
+  }
+  BLI_mutex_unlock(&topology_cache_lock);
+  /* Candidates left when the cache got disabled meanwhile are freed too. */
+  BLI_movelisttolist(&freed, &candidates);
+  subdiv_topology_cache_entries_free(&freed);
+  return subdiv;
+}
+
+static void subdiv_topology_cache_enable(const bool is_enabled)
+{
+  BLI_mutex_lock(&topology_cache_lock);
+  topology_cache.is_enabled = is_enabled;
+  BLI_mutex_unlock(&topology_cache_lock);
+}
+
+void BKE_subdiv_topology_cache_trim(void)
+{
+  ListBase freed = {NULL, NULL};
+  BLI_mutex_lock(&topology_cache_lock);
+  subdiv_topology_cache_trim_locked(&freed);
+  BLI_mutex_unlock(&topology_cache_lock);
+  subdiv_topology_cache_entries_free(&freed);
+}
+
+void BKE_subdiv_topology_cache_clear(void)
+{
+  BLI_mutex_lock(&topology_cache_lock);
+  ListBase entries = topology_cache.entries;
+  BLI_listbase_clear(&topology_cache.entries);
+  topology_cache.memory = 0;
+  BLI_mutex_unlock(&topology_cache_lock);
+  subdiv_topology_cache_entries_free(&entries);
+}
+
 /* ============================== CONSTRUCTION ============================== */
 
 /* Creation from scratch. */
@@ -178,7 +432,14 @@ Subdiv *BKE_subdiv_update_from_converter(Subdiv *subdiv,
   if (subdiv != NULL) {
     BKE_subdiv_free(subdiv);
   }
-  return BKE_subdiv_new_from_converter(settings, converter);
+  const uint32_t topology_hash = subdiv_converter_topology_hash(converter);
+  subdiv = subdiv_topology_cache_take(settings, converter, topology_hash);
+  if (subdiv == NULL) {
+    subdiv = BKE_subdiv_new_from_converter(settings, converter);
+  }
+  subdiv->topology_hash = topology_hash;
+  subdiv->use_topology_cache = true;
+  return subdiv;
 }
 
 Subdiv *BKE_subdiv_update_from_mesh(Subdiv *subdiv,
@@ -194,7 +455,7 @@ Subdiv *BKE_subdiv_update_from_mesh(Subdiv *subdiv,
 
 /* Memory release. */
 
-void BKE_subdiv_free(Subdiv *subdiv)
+static void subdiv_free_data(Subdiv *subdiv)
 {
   if (subdiv->evaluator != NULL) {
     openSubdiv_deleteEvaluator(subdiv->evaluator);
@@ -209,6 +470,14 @@ void BKE_subdiv_free(Subdiv *subdiv)
   MEM_freeN(subdiv);
 }
 
+void BKE_subdiv_free(Subdiv *subdiv)
+{
+  if (subdiv_topology_cache_add(subdiv)) {
+    return;
+  }
+  subdiv_free_data(subdiv);
+}
+
 /* =========================== PTEX FACES AND GRIDS ========================= */
 
 int *BKE_subdiv_face_ptex_offset_get(Subdiv *subdiv)
@@ -28,6 +28,7 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_bitmap.h"
 #include "BLI_math_bits.h"
 #include "BLI_math_vector.h"
 #include "BLI_task.h"
@@ -44,7 +45,10 @@
 /** \name Various forward declarations
  * \{ */
 
-static void subdiv_ccg_average_all_boundaries_and_corners(SubdivCCG *subdiv_ccg, CCGKey *key);
+static void subdiv_ccg_average_faces_boundaries_and_corners(SubdivCCG *subdiv_ccg,
+                                                            CCGKey *key,
+                                                            struct CCGFace **effected_faces,
+                                                            int num_effected_faces);
 
 static void subdiv_ccg_average_inner_face_grids(SubdivCCG *subdiv_ccg,
                                                 CCGKey *key,
@@ -168,6 +172,9 @@ static void subdiv_ccg_alloc_elements(SubdivCCG *subdiv_ccg, Subdiv *subdiv)
 /** \name Grids evaluation
  * \{ */
 
+/* Number of grid elements evaluated at once. */
+#define SUBDIV_CCG_EVAL_CHUNK_SIZE 256
+
 typedef struct CCGEvalGridsData {
   SubdivCCG *subdiv_ccg;
   Subdiv *subdiv;
@@ -176,30 +183,6 @@ typedef struct CCGEvalGridsData {
   SubdivCCGMaterialFlagsEvaluator *material_flags_evaluator;
 } CCGEvalGridsData;
 
-static void subdiv_ccg_eval_grid_element_limit(CCGEvalGridsData *data,
-                                               const int ptex_face_index,
-                                               const float u,
-                                               const float v,
-                                               unsigned char *element)
-{
-  Subdiv *subdiv = data->subdiv;
-  SubdivCCG *subdiv_ccg = data->subdiv_ccg;
-  if (subdiv->displacement_evaluator != NULL) {
-    BKE_subdiv_eval_final_point(subdiv, ptex_face_index, u, v, (float *)element);
-  }
-  else if (subdiv_ccg->has_normal) {
-    BKE_subdiv_eval_limit_point_and_normal(subdiv,
-                                           ptex_face_index,
-                                           u,
-                                           v,
-                                           (float *)element,
-                                           (float *)(element + subdiv_ccg->normal_offset));
-  }
-  else {
-    BKE_subdiv_eval_limit_point(subdiv, ptex_face_index, u, v, (float *)element);
-  }
-}
-
 static void subdiv_ccg_eval_grid_element_mask(CCGEvalGridsData *data,
                                               const int ptex_face_index,
                                               const float u,
@@ -219,14 +202,39 @@ static void subdiv_ccg_eval_grid_element_mask(CCGEvalGridsData *data,
   }
 }
 
-static void subdiv_ccg_eval_grid_element(CCGEvalGridsData *data,
-                                         const int ptex_face_index,
-                                         const float u,
-                                         const float v,
-                                         unsigned char *element)
+/* Evaluate a number of consecutive grid elements of the same ptex face, so that the limit
+ * surface is evaluated with a single call to the evaluator. */
+static void subdiv_ccg_eval_grid_elements(CCGEvalGridsData *data,
+                                          const int ptex_face_index,
+                                          const float (*uvs)[2],
+                                          const int num_elements,
+                                          unsigned char *elements)
 {
-  subdiv_ccg_eval_grid_element_limit(data, ptex_face_index, u, v, element);
-  subdiv_ccg_eval_grid_element_mask(data, ptex_face_index, u, v, element);
+  Subdiv *subdiv = data->subdiv;
+  SubdivCCG *subdiv_ccg = data->subdiv_ccg;
+  const int element_size = element_size_bytes_get(subdiv_ccg);
+  float P[SUBDIV_CCG_EVAL_CHUNK_SIZE][3];
+  float dPdu[SUBDIV_CCG_EVAL_CHUNK_SIZE][3], dPdv[SUBDIV_CCG_EVAL_CHUNK_SIZE][3];
+  const bool use_normals = (subdiv->displacement_evaluator == NULL && subdiv_ccg->has_normal);
+  if (subdiv->displacement_evaluator != NULL) {
+    BKE_subdiv_eval_final_points(subdiv, ptex_face_index, uvs, num_elements, P);
+  }
+  else if (use_normals) {
+    BKE_subdiv_eval_limit_points(subdiv, ptex_face_index, uvs, num_elements, P, dPdu, dPdv);
+  }
+  else {
+    BKE_subdiv_eval_limit_points(subdiv, ptex_face_index, uvs, num_elements, P, NULL, NULL);
+  }
+  for (int i = 0; i < num_elements; i++) {
+    unsigned char *element = elements + (size_t)i * element_size;
+    copy_v3_v3((float *)element, P[i]);
+    if (use_normals) {
+      float *normal = (float *)(element + subdiv_ccg->normal_offset);
+      cross_v3_v3v3(normal, dPdu[i], dPdv[i]);
+      normalize_v3(normal);
+    }
+    subdiv_ccg_eval_grid_element_mask(data, ptex_face_index, uvs[i][0], uvs[i][1], element);
+  }
 }
 
 static void subdiv_ccg_eval_regular_grid(CCGEvalGridsData *data, const int face_index)
@@ -234,6 +242,7 @@ static void subdiv_ccg_eval_regular_grid(CCGEvalGridsData *data, const int face_
   SubdivCCG *subdiv_ccg = data->subdiv_ccg;
   const int ptex_face_index = data->face_ptex_offset[face_index];
   const int grid_size = subdiv_ccg->grid_size;
+  const int grid_area = grid_size * grid_size;
   const float grid_size_1_inv = 1.0f / (float)(grid_size - 1);
   const int element_size = element_size_bytes_get(subdiv_ccg);
   SubdivCCGFace *faces = subdiv_ccg->faces;
@@ -242,16 +251,21 @@ static void subdiv_ccg_eval_regular_grid(CCGEvalGridsData *data, const int face_
   for (int corner = 0; corner < face->num_grids; corner++) {
     const int grid_index = face->start_grid_index + corner;
     unsigned char *grid = (unsigned char *)subdiv_ccg->grids[grid_index];
-    for (int y = 0; y < grid_size; y++) {
-      const float grid_v = (float)y * grid_size_1_inv;
-      for (int x = 0; x < grid_size; x++) {
+    for (int start = 0; start < grid_area; start += SUBDIV_CCG_EVAL_CHUNK_SIZE) {
+      const int num_elements = min_ii(grid_area - start, SUBDIV_CCG_EVAL_CHUNK_SIZE);
+      float uvs[SUBDIV_CCG_EVAL_CHUNK_SIZE][2];
+      for (int i = 0; i < num_elements; i++) {
+        const int x = (start + i) % grid_size;
+        const int y = (start + i) / grid_size;
         const float grid_u = (float)x * grid_size_1_inv;
-        float u, v;
-        BKE_subdiv_rotate_grid_to_quad(corner, grid_u, grid_v, &u, &v);
-        const size_t grid_element_index = (size_t)y * grid_size + x;
-        const size_t grid_element_offset = grid_element_index * element_size;
-        subdiv_ccg_eval_grid_element(data, ptex_face_index, u, v, &grid[grid_element_offset]);
+        const float grid_v = (float)y * grid_size_1_inv;
+        BKE_subdiv_rotate_grid_to_quad(corner, grid_u, grid_v, &uvs[i][0], &uvs[i][1]);
       }
+      subdiv_ccg_eval_grid_elements(data,
+                                    ptex_face_index,
+                                    (const float(*)[2])uvs,
+                                    num_elements,
+                                    &grid[(size_t)start * element_size]);
     }
     /* Assign grid's face. */
     grid_faces[grid_index] = &faces[face_index];
@@ -265,6 +279,7 @@ static void subdiv_ccg_eval_special_grid(CCGEvalGridsData *data, const int face_
 {
   SubdivCCG *subdiv_ccg = data->subdiv_ccg;
   const int grid_size = subdiv_ccg->grid_size;
+  const int grid_area = grid_size * grid_size;
   const float grid_size_1_inv = 1.0f / (float)(grid_size - 1);
   const int element_size = element_size_bytes_get(subdiv_ccg);
   SubdivCCGFace *faces = subdiv_ccg->faces;
@@ -274,14 +289,20 @@ static void subdiv_ccg_eval_special_grid(CCGEvalGridsData *data, const int face_
     const int grid_index = face->start_grid_index + corner;
     const int ptex_face_index = data->face_ptex_offset[face_index] + corner;
     unsigned char *grid = (unsigned char *)subdiv_ccg->grids[grid_index];
-    for (int y = 0; y < grid_size; y++) {
-      const float u = 1.0f - ((float)y * grid_size_1_inv);
-      for (int x = 0; x < grid_size; x++) {
-        const float v = 1.0f - ((float)x * grid_size_1_inv);
-        const size_t grid_element_index = (size_t)y * grid_size + x;
-        const size_t grid_element_offset = grid_element_index * element_size;
-        subdiv_ccg_eval_grid_element(data, ptex_face_index, u, v, &grid[grid_element_offset]);
+    for (int start = 0; start < grid_area; start += SUBDIV_CCG_EVAL_CHUNK_SIZE) {
+      const int num_elements = min_ii(grid_area - start, SUBDIV_CCG_EVAL_CHUNK_SIZE);
+      float uvs[SUBDIV_CCG_EVAL_CHUNK_SIZE][2];
+      for (int i = 0; i < num_elements; i++) {
+        const int x = (start + i) % grid_size;
+        const int y = (start + i) / grid_size;
+        uvs[i][0] = 1.0f - ((float)y * grid_size_1_inv);
+        uvs[i][1] = 1.0f - ((float)x * grid_size_1_inv);
       }
+      subdiv_ccg_eval_grid_elements(data,
+                                    ptex_face_index,
+                                    (const float(*)[2])uvs,
+                                    num_elements,
+                                    &grid[(size_t)start * element_size]);
     }
     /* Assign grid's face. */
     grid_faces[grid_index] = &faces[face_index];
@@ -888,11 +909,10 @@ void BKE_subdiv_ccg_update_normals(SubdivCCG *subdiv_ccg,
     return;
   }
   subdiv_ccg_recalc_modified_inner_grid_normals(subdiv_ccg, effected_faces, num_effected_faces);
-  /* TODO(sergey): Only average elements which are adjacent to modified
-   * faces. */
   CCGKey key;
   BKE_subdiv_ccg_key_top_level(&key, subdiv_ccg);
-  subdiv_ccg_average_all_boundaries_and_corners(subdiv_ccg, &key);
+  subdiv_ccg_average_faces_boundaries_and_corners(
+      subdiv_ccg, &key, effected_faces, num_effected_faces);
 }
 
 /** \} */
@@ -1031,6 +1051,9 @@ static void subdiv_ccg_average_inner_grids_task(void *__restrict userdata_v,
 typedef struct AverageGridsBoundariesData {
   SubdivCCG *subdiv_ccg;
   CCGKey *key;
+
+  /* Optional lookup table. Maps task index to index in `subdiv_ccg->adjacent_edges`. */
+  const int *adjacent_edge_index_map;
 } AverageGridsBoundariesData;
 
 typedef struct AverageGridsBoundariesTLSData {
@@ -1078,13 +1101,16 @@ static void subdiv_ccg_average_grids_boundary(SubdivCCG *subdiv_ccg,
 }
 
 static void subdiv_ccg_average_grids_boundaries_task(void *__restrict userdata_v,
-                                                     const int adjacent_edge_index,
+                                                     const int n,
                                                      const TaskParallelTLS *__restrict tls_v)
 {
   AverageGridsBoundariesData *data = userdata_v;
   AverageGridsBoundariesTLSData *tls = tls_v->userdata_chunk;
   SubdivCCG *subdiv_ccg = data->subdiv_ccg;
   CCGKey *key = data->key;
+  const int adjacent_edge_index = data->adjacent_edge_index_map ?
+                                      data->adjacent_edge_index_map[n] :
+                                      n;
   SubdivCCGAdjacentEdge *adjacent_edge = &subdiv_ccg->adjacent_edges[adjacent_edge_index];
   subdiv_ccg_average_grids_boundary(subdiv_ccg, key, adjacent_edge, tls);
 }
@@ -1099,6 +1125,9 @@ static void subdiv_ccg_average_grids_boundaries_free(const void *__restrict UNUS
 typedef struct AverageGridsCornerData {
   SubdivCCG *subdiv_ccg;
   CCGKey *key;
+
+  /* Optional lookup table. Maps task index to index in `subdiv_ccg->adjacent_vertices`. */
+  const int *adjacent_vertex_index_map;
 } AverageGridsCornerData;
 
 static void subdiv_ccg_average_grids_corners(SubdivCCG *subdiv_ccg,
@@ -1127,56 +1156,164 @@ static void subdiv_ccg_average_grids_corners(SubdivCCG *subdiv_ccg,
 }
 
 static void subdiv_ccg_average_grids_corners_task(void *__restrict userdata_v,
-                                                  const int adjacent_vertex_index,
+                                                  const int n,
                                                   const TaskParallelTLS *__restrict UNUSED(tls_v))
 {
   AverageGridsCornerData *data = userdata_v;
   SubdivCCG *subdiv_ccg = data->subdiv_ccg;
   CCGKey *key = data->key;
+  const int adjacent_vertex_index = data->adjacent_vertex_index_map ?
+                                        data->adjacent_vertex_index_map[n] :
+                                        n;
   SubdivCCGAdjacentVertex *adjacent_vertex = &subdiv_ccg->adjacent_vertices[adjacent_vertex_index];
   subdiv_ccg_average_grids_corners(subdiv_ccg, key, adjacent_vertex);
 }
 
-static void subdiv_ccg_average_all_boundaries(SubdivCCG *subdiv_ccg, CCGKey *key)
+static void subdiv_ccg_average_boundaries(SubdivCCG *subdiv_ccg,
+                                          CCGKey *key,
+                                          const int *adjacent_edge_index_map,
+                                          int num_adjacent_edges)
 {
   TaskParallelSettings parallel_range_settings;
   BLI_parallel_range_settings_defaults(&parallel_range_settings);
   AverageGridsBoundariesData boundaries_data = {
       .subdiv_ccg = subdiv_ccg,
       .key = key,
+      .adjacent_edge_index_map = adjacent_edge_index_map,
   };
   AverageGridsBoundariesTLSData tls_data = {NULL};
   parallel_range_settings.userdata_chunk = &tls_data;
   parallel_range_settings.userdata_chunk_size = sizeof(tls_data);
   parallel_range_settings.func_free = subdiv_ccg_average_grids_boundaries_free;
   BLI_task_parallel_range(0,
-                          subdiv_ccg->num_adjacent_edges,
+                          num_adjacent_edges,
                           &boundaries_data,
                           subdiv_ccg_average_grids_boundaries_task,
                           &parallel_range_settings);
 }
 
-static void subdiv_ccg_average_all_corners(SubdivCCG *subdiv_ccg, CCGKey *key)
+static void subdiv_ccg_average_all_boundaries(SubdivCCG *subdiv_ccg, CCGKey *key)
+{
+  subdiv_ccg_average_boundaries(subdiv_ccg, key, NULL, subdiv_ccg->num_adjacent_edges);
+}
+
+static void subdiv_ccg_average_corners(SubdivCCG *subdiv_ccg,
+                                       CCGKey *key,
+                                       const int *adjacent_vertex_index_map,
+                                       int num_adjacent_vertices)
 {
   TaskParallelSettings parallel_range_settings;
   BLI_parallel_range_settings_defaults(&parallel_range_settings);
   AverageGridsCornerData corner_data = {
       .subdiv_ccg = subdiv_ccg,
       .key = key,
+      .adjacent_vertex_index_map = adjacent_vertex_index_map,
   };
   BLI_task_parallel_range(0,
-                          subdiv_ccg->num_adjacent_vertices,
+                          num_adjacent_vertices,
                           &corner_data,
                           subdiv_ccg_average_grids_corners_task,
                           &parallel_range_settings);
 }
 
+static void subdiv_ccg_average_all_corners(SubdivCCG *subdiv_ccg, CCGKey *key)
+{
+  subdiv_ccg_average_corners(subdiv_ccg, key, NULL, subdiv_ccg->num_adjacent_vertices);
+}
+
 static void subdiv_ccg_average_all_boundaries_and_corners(SubdivCCG *subdiv_ccg, CCGKey *key)
 {
   subdiv_ccg_average_all_boundaries(subdiv_ccg, key);
   subdiv_ccg_average_all_corners(subdiv_ccg, key);
 }
 
+/* Gather indices of base mesh edges and vertices adjacent to the given faces.
+ * Every index is only stored once. */
+static void subdiv_ccg_affected_face_adjacency(SubdivCCG *subdiv_ccg,
+                                               struct CCGFace **effected_faces,
+                                               int num_effected_faces,
+                                               int **r_adjacent_edge_indices,
+                                               int *r_num_adjacent_edges,
+                                               int **r_adjacent_vertex_indices,
+                                               int *r_num_adjacent_vertices)
+{
+  Subdiv *subdiv = subdiv_ccg->subdiv;
+  OpenSubdiv_TopologyRefiner *topology_refiner = subdiv->topology_refiner;
+  BLI_bitmap *edge_tagged = BLI_BITMAP_NEW(subdiv_ccg->num_adjacent_edges, __func__);
+  BLI_bitmap *vertex_tagged = BLI_BITMAP_NEW(subdiv_ccg->num_adjacent_vertices, __func__);
+  /* Every face corner has one edge and one vertex, so the number of grids is an upper bound. */
+  int num_face_corners = 0;
+  for (int i = 0; i < num_effected_faces; i++) {
+    num_face_corners += ((SubdivCCGFace *)effected_faces[i])->num_grids;
+  }
+  int *adjacent_edge_indices = MEM_malloc_arrayN(
+      num_face_corners, sizeof(int), "ccg affected adjacent edges");
+  int *adjacent_vertex_indices = MEM_malloc_arrayN(
+      num_face_corners, sizeof(int), "ccg affected adjacent vertices");
+  int num_adjacent_edges = 0;
+  int num_adjacent_vertices = 0;
+  /* Initialize storage. */
+  StaticOrHeapIntStorage face_vertices_storage;
+  StaticOrHeapIntStorage face_edges_storage;
+  static_or_heap_storage_init(&face_vertices_storage);
+  static_or_heap_storage_init(&face_edges_storage);
+  for (int i = 0; i < num_effected_faces; i++) {
+    SubdivCCGFace *face = (SubdivCCGFace *)effected_faces[i];
+    const int face_index = face - subdiv_ccg->faces;
+    const int num_face_edges = face->num_grids;
+    int *face_vertices = static_or_heap_storage_get(&face_vertices_storage, num_face_edges);
+    topology_refiner->getFaceVertices(topology_refiner, face_index, face_vertices);
+    int *face_edges = static_or_heap_storage_get(&face_edges_storage, num_face_edges);
+    topology_refiner->getFaceEdges(topology_refiner, face_index, face_edges);
+    for (int corner = 0; corner < num_face_edges; corner++) {
+      const int edge_index = face_edges[corner];
+      const int vertex_index = face_vertices[corner];
+      if (!BLI_BITMAP_TEST(edge_tagged, edge_index)) {
+        BLI_BITMAP_ENABLE(edge_tagged, edge_index);
+        adjacent_edge_indices[num_adjacent_edges++] = edge_index;
+      }
+      if (!BLI_BITMAP_TEST(vertex_tagged, vertex_index)) {
+        BLI_BITMAP_ENABLE(vertex_tagged, vertex_index);
+        adjacent_vertex_indices[num_adjacent_vertices++] = vertex_index;
+      }
+    }
+  }
+  /* Free possibly heap-allocated storage. */
+  static_or_heap_storage_free(&face_vertices_storage);
+  static_or_heap_storage_free(&face_edges_storage);
+  MEM_freeN(edge_tagged);
+  MEM_freeN(vertex_tagged);
+  *r_adjacent_edge_indices = adjacent_edge_indices;
+  *r_num_adjacent_edges = num_adjacent_edges;
+  *r_adjacent_vertex_indices = adjacent_vertex_indices;
+  *r_num_adjacent_vertices = num_adjacent_vertices;
+}
+
+/* Average boundaries and corners of grids of the given faces with their neighbors.
+ * Elements which are not adjacent to any of the faces are left untouched. */
+static void subdiv_ccg_average_faces_boundaries_and_corners(SubdivCCG *subdiv_ccg,
+                                                            CCGKey *key,
+                                                            struct CCGFace **effected_faces,
+                                                            int num_effected_faces)
+{
+  if (num_effected_faces == 0) {
+    return;
+  }
+  int *adjacent_edge_indices, *adjacent_vertex_indices;
+  int num_adjacent_edges, num_adjacent_vertices;
+  subdiv_ccg_affected_face_adjacency(subdiv_ccg,
+                                     effected_faces,
+                                     num_effected_faces,
+                                     &adjacent_edge_indices,
+                                     &num_adjacent_edges,
+                                     &adjacent_vertex_indices,
+                                     &num_adjacent_vertices);
+  subdiv_ccg_average_boundaries(subdiv_ccg, key, adjacent_edge_indices, num_adjacent_edges);
+  subdiv_ccg_average_corners(subdiv_ccg, key, adjacent_vertex_indices, num_adjacent_vertices);
+  MEM_freeN(adjacent_edge_indices);
+  MEM_freeN(adjacent_vertex_indices);
+}
+
 void BKE_subdiv_ccg_average_grids(SubdivCCG *subdiv_ccg)
 {
   CCGKey key;
@@ -1235,9 +1372,8 @@ void BKE_subdiv_ccg_average_stitch_faces(SubdivCCG *subdiv_ccg,
                           &data,
                           subdiv_ccg_stitch_face_inner_grids_task,
                           &parallel_range_settings);
-  /* TODO(sergey): Only average elements which are adjacent to modified
-   * faces. */
-  subdiv_ccg_average_all_boundaries_and_corners(subdiv_ccg, &key);
+  subdiv_ccg_average_faces_boundaries_and_corners(
+      subdiv_ccg, &key, effected_faces, num_effected_faces);
 }
 
 void BKE_subdiv_ccg_topology_counters(const SubdivCCG *subdiv_ccg,
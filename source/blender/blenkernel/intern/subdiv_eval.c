@@ -273,6 +273,94 @@ void BKE_subdiv_eval_final_point(
   }
 }
 
+/* ============================ Batched queries ============================= */
+
+/* Maximum number of points passed to the evaluator at once, keeps temporary arrays on stack. */
+#define SUBDIV_EVAL_BATCH_SIZE 256
+
+static void subdiv_eval_limit_points_batch(Subdiv *subdiv,
+                                           const int ptex_face_index,
+                                           const float (*uvs)[2],
+                                           const int num_points,
+                                           float (*r_P)[3],
+                                           float (*r_dPdu)[3],
+                                           float (*r_dPdv)[3])
+{
+  BLI_assert(num_points <= SUBDIV_EVAL_BATCH_SIZE);
+  if (num_points <= 0) {
+    return;
+  }
+  OpenSubdiv_PatchCoord patch_coords[SUBDIV_EVAL_BATCH_SIZE];
+  for (int i = 0; i < num_points; i++) {
+    patch_coords[i].ptex_face = ptex_face_index;
+    patch_coords[i].u = uvs[i][0];
+    patch_coords[i].v = uvs[i][1];
+  }
+  const bool use_derivatives = (r_dPdu != NULL && r_dPdv != NULL);
+  subdiv->evaluator->evaluatePatchesLimit(subdiv->evaluator,
+                                          patch_coords,
+                                          num_points,
+                                          r_P[0],
+                                          use_derivatives ? r_dPdu[0] : NULL,
+                                          use_derivatives ? r_dPdv[0] : NULL);
+  if (!use_derivatives) {
+    return;
+  }
+  /* Same workaround for zero derivatives as in the single point evaluation, which is used for
+   * such (rare) points. */
+  for (int i = 0; i < num_points; i++) {
+    if (is_zero_v3(r_dPdu[i]) || is_zero_v3(r_dPdv[i])) {
+      BKE_subdiv_eval_limit_point_and_derivatives(
+          subdiv, ptex_face_index, uvs[i][0], uvs[i][1], r_P[i], r_dPdu[i], r_dPdv[i]);
+    }
+  }
+}
+
+void BKE_subdiv_eval_limit_points(Subdiv *subdiv,
+                                  const int ptex_face_index,
+                                  const float (*uvs)[2],
+                                  const int num_points,
+                                  float (*r_P)[3],
+                                  float (*r_dPdu)[3],
+                                  float (*r_dPdv)[3])
+{
+  const bool use_derivatives = (r_dPdu != NULL && r_dPdv != NULL);
+  for (int start = 0; start < num_points; start += SUBDIV_EVAL_BATCH_SIZE) {
+    const int num_batch_points = min_ii(num_points - start, SUBDIV_EVAL_BATCH_SIZE);
+    subdiv_eval_limit_points_batch(subdiv,
+                                   ptex_face_index,
+                                   &uvs[start],
+                                   num_batch_points,
+                                   &r_P[start],
+                                   use_derivatives ? &r_dPdu[start] : NULL,
+                                   use_derivatives ? &r_dPdv[start] : NULL);
+  }
+}
+
+void BKE_subdiv_eval_final_points(Subdiv *subdiv,
+                                  const int ptex_face_index,
+                                  const float (*uvs)[2],
+                                  const int num_points,
+                                  float (*r_P)[3])
+{
+  if (subdiv->displacement_evaluator == NULL) {
+    BKE_subdiv_eval_limit_points(subdiv, ptex_face_index, uvs, num_points, r_P, NULL, NULL);
+    return;
+  }
+  float dPdu[SUBDIV_EVAL_BATCH_SIZE][3], dPdv[SUBDIV_EVAL_BATCH_SIZE][3];
+  for (int start = 0; start < num_points; start += SUBDIV_EVAL_BATCH_SIZE) {
+    const int num_batch_points = min_ii(num_points - start, SUBDIV_EVAL_BATCH_SIZE);
+    subdiv_eval_limit_points_batch(
+        subdiv, ptex_face_index, &uvs[start], num_batch_points, &r_P[start], dPdu, dPdv);
+    for (int i = 0; i < num_batch_points; i++) {
+      const float *uv = uvs[start + i];
+      float D[3];
+      BKE_subdiv_eval_displacement(subdiv, ptex_face_index, uv[0], uv[1], dPdu[i], dPdv[i], D);
+      add_v3_v3(r_P[start + i], D);
+    }
+  }
+}
+
 /* ===================  Patch queries at given resolution =================== */
 
 /* Move buffer forward by a given number of bytes. */
@@ -293,6 +381,29 @@ static void buffer_write_short_value(void **buffer, const short *values_buffer,
   memcpy(*buffer, values_buffer, sizeof(short) * num_values);
 }
 
+/* Evaluate a batch of points of the patch grid, starting from the given point index.
+ * Returns the number of evaluated points. */
+static int patch_resolution_batch_eval(Subdiv *subdiv,
+                                       const int ptex_face_index,
+                                       const int resolution,
+                                       const int start,
+                                       float (*r_P)[3],
+                                       float (*r_dPdu)[3],
+                                       float (*r_dPdv)[3])
+{
+  const int num_points = min_ii(resolution * resolution - start, SUBDIV_EVAL_BATCH_SIZE);
+  const float inv_resolution_1 = 1.0f / (float)(resolution - 1);
+  float uvs[SUBDIV_EVAL_BATCH_SIZE][2];
+  for (int i = 0; i < num_points; i++) {
+    const int point_index = start + i;
+    uvs[i][0] = (point_index % resolution) * inv_resolution_1;
+    uvs[i][1] = (point_index / resolution) * inv_resolution_1;
+  }
+  subdiv_eval_limit_points_batch(
+      subdiv, ptex_face_index, (const float(*)[2])uvs, num_points, r_P, r_dPdu, r_dPdv);
+  return num_points;
+}
+
 void BKE_subdiv_eval_limit_patch_resolution_point(Subdiv *subdiv,
                                                   const int ptex_face_index,
                                                   const int resolution,
@@ -301,14 +412,16 @@ void BKE_subdiv_eval_limit_patch_resolution_point(Subdiv *subdiv,
                                                   const int stride)
 {
   buffer_apply_offset(&buffer, offset);
-  const float inv_resolution_1 = 1.0f / (float)(resolution - 1);
-  for (int y = 0; y < resolution; y++) {
-    const float v = y * inv_resolution_1;
-    for (int x = 0; x < resolution; x++) {
-      const float u = x * inv_resolution_1;
-      BKE_subdiv_eval_limit_point(subdiv, ptex_face_index, u, v, buffer);
+  const int num_points = resolution * resolution;
+  float P[SUBDIV_EVAL_BATCH_SIZE][3];
+  for (int start = 0; start < num_points;) {
+    const int num_batch_points = patch_resolution_batch_eval(
+        subdiv, ptex_face_index, resolution, start, P, NULL, NULL);
+    for (int i = 0; i < num_batch_points; i++) {
+      buffer_write_float_value(&buffer, P[i], 3);
       buffer_apply_offset(&buffer, stride);
     }
+    start += num_batch_points;
   }
 }
 
@@ -328,17 +441,21 @@ void BKE_subdiv_eval_limit_patch_resolution_point_and_derivatives(Subdiv *subdiv
   buffer_apply_offset(&point_buffer, point_offset);
   buffer_apply_offset(&du_buffer, du_offset);
   buffer_apply_offset(&dv_buffer, dv_offset);
-  const float inv_resolution_1 = 1.0f / (float)(resolution - 1);
-  for (int y = 0; y < resolution; y++) {
-    const float v = y * inv_resolution_1;
-    for (int x = 0; x < resolution; x++) {
-      const float u = x * inv_resolution_1;
-      BKE_subdiv_eval_limit_point_and_derivatives(
-          subdiv, ptex_face_index, u, v, point_buffer, du_buffer, dv_buffer);
+  const int num_points = resolution * resolution;
+  float P[SUBDIV_EVAL_BATCH_SIZE][3];
+  float dPdu[SUBDIV_EVAL_BATCH_SIZE][3], dPdv[SUBDIV_EVAL_BATCH_SIZE][3];
+  for (int start = 0; start < num_points;) {
+    const int num_batch_points = patch_resolution_batch_eval(
+        subdiv, ptex_face_index, resolution, start, P, dPdu, dPdv);
+    for (int i = 0; i < num_batch_points; i++) {
+      buffer_write_float_value(&point_buffer, P[i], 3);
+      buffer_write_float_value(&du_buffer, dPdu[i], 3);
+      buffer_write_float_value(&dv_buffer, dPdv[i], 3);
       buffer_apply_offset(&point_buffer, point_stride);
       buffer_apply_offset(&du_buffer, du_stride);
       buffer_apply_offset(&dv_buffer, dv_stride);
     }
+    start += num_batch_points;
   }
 }
 
@@ -354,17 +471,22 @@ void BKE_subdiv_eval_limit_patch_resolution_point_and_normal(Subdiv *subdiv,
 {
   buffer_apply_offset(&point_buffer, point_offset);
   buffer_apply_offset(&normal_buffer, normal_offset);
-  const float inv_resolution_1 = 1.0f / (float)(resolution - 1);
-  for (int y = 0; y < resolution; y++) {
-    const float v = y * inv_resolution_1;
-    for (int x = 0; x < resolution; x++) {
-      const float u = x * inv_resolution_1;
+  const int num_points = resolution * resolution;
+  float P[SUBDIV_EVAL_BATCH_SIZE][3];
+  float dPdu[SUBDIV_EVAL_BATCH_SIZE][3], dPdv[SUBDIV_EVAL_BATCH_SIZE][3];
+  for (int start = 0; start < num_points;) {
+    const int num_batch_points = patch_resolution_batch_eval(
+        subdiv, ptex_face_index, resolution, start, P, dPdu, dPdv);
+    for (int i = 0; i < num_batch_points; i++) {
       float normal[3];
-      BKE_subdiv_eval_limit_point_and_normal(subdiv, ptex_face_index, u, v, point_buffer, normal);
+      cross_v3_v3v3(normal, dPdu[i], dPdv[i]);
+      normalize_v3(normal);
+      buffer_write_float_value(&point_buffer, P[i], 3);
       buffer_write_float_value(&normal_buffer, normal, 3);
       buffer_apply_offset(&point_buffer, point_stride);
       buffer_apply_offset(&normal_buffer, normal_stride);
     }
+    start += num_batch_points;
   }
 }
 
@@ -380,17 +502,23 @@ void BKE_subdiv_eval_limit_patch_resolution_point_and_short_normal(Subdiv *subdi
 {
   buffer_apply_offset(&point_buffer, point_offset);
   buffer_apply_offset(&normal_buffer, normal_offset);
-  const float inv_resolution_1 = 1.0f / (float)(resolution - 1);
-  for (int y = 0; y < resolution; y++) {
-    const float v = y * inv_resolution_1;
-    for (int x = 0; x < resolution; x++) {
-      const float u = x * inv_resolution_1;
-      short normal[3];
-      BKE_subdiv_eval_limit_point_and_short_normal(
-          subdiv, ptex_face_index, u, v, point_buffer, normal);
-      buffer_write_short_value(&normal_buffer, normal, 3);
+  const int num_points = resolution * resolution;
+  float P[SUBDIV_EVAL_BATCH_SIZE][3];
+  float dPdu[SUBDIV_EVAL_BATCH_SIZE][3], dPdv[SUBDIV_EVAL_BATCH_SIZE][3];
+  for (int start = 0; start < num_points;) {
+    const int num_batch_points = patch_resolution_batch_eval(
+        subdiv, ptex_face_index, resolution, start, P, dPdu, dPdv);
+    for (int i = 0; i < num_batch_points; i++) {
+      float normal[3];
+      short short_normal[3];
+      cross_v3_v3v3(normal, dPdu[i], dPdv[i]);
+      normalize_v3(normal);
+      normal_float_to_short_v3(short_normal, normal);
+      buffer_write_float_value(&point_buffer, P[i], 3);
+      buffer_write_short_value(&normal_buffer, short_normal, 3);
       buffer_apply_offset(&point_buffer, point_stride);
       buffer_apply_offset(&normal_buffer, normal_stride);
     }
+    start += num_batch_points;
   }
 }
@@ -625,8 +625,77 @@ static void subdiv_foreach_every_edge_vertices(SubdivForeachTaskContext *ctx, vo
 
 /* Traversal of inner vertices, they are coming from ptex patches. */
 
+/* Inner vertices gathered for a single SubdivForeachContext::vertices_inner() call. */
+typedef struct InnerVerticesBatch {
+  int ptex_face_index;
+  int coarse_poly_index;
+  int coarse_corner;
+  int start_subdiv_vertex_index;
+  int num_vertices;
+  float uvs[SUBDIV_FOREACH_VERTICES_INNER_BATCH_SIZE][2];
+} InnerVerticesBatch;
+
+static void subdiv_foreach_inner_vertices_batch_flush(SubdivForeachTaskContext *ctx,
+                                                      void *tls,
+                                                      InnerVerticesBatch *batch)
+{
+  if (batch->num_vertices == 0) {
+    return;
+  }
+  ctx->foreach_context->vertices_inner(ctx->foreach_context,
+                                       tls,
+                                       batch->ptex_face_index,
+                                       (const float(*)[2])batch->uvs,
+                                       batch->num_vertices,
+                                       batch->coarse_poly_index,
+                                       batch->coarse_corner,
+                                       batch->start_subdiv_vertex_index);
+  batch->num_vertices = 0;
+}
+
+/* Either invoke per-vertex callback, or gather the vertex into the batch which is flushed when
+ * it is full or the next vertex does not continue it. */
+static void subdiv_foreach_inner_vertex(SubdivForeachTaskContext *ctx,
+                                        void *tls,
+                                        InnerVerticesBatch *batch,
+                                        const int ptex_face_index,
+                                        const float u,
+                                        const float v,
+                                        const int coarse_poly_index,
+                                        const int coarse_corner,
+                                        const int subdiv_vertex_index)
+{
+  if (ctx->foreach_context->vertices_inner == NULL) {
+    ctx->foreach_context->vertex_inner(ctx->foreach_context,
+                                       tls,
+                                       ptex_face_index,
+                                       u,
+                                       v,
+                                       coarse_poly_index,
+                                       coarse_corner,
+                                       subdiv_vertex_index);
+    return;
+  }
+  if (batch->num_vertices == SUBDIV_FOREACH_VERTICES_INNER_BATCH_SIZE ||
+      (batch->num_vertices != 0 &&
+       (batch->ptex_face_index != ptex_face_index || batch->coarse_corner != coarse_corner ||
+        batch->start_subdiv_vertex_index + batch->num_vertices != subdiv_vertex_index))) {
+    subdiv_foreach_inner_vertices_batch_flush(ctx, tls, batch);
+  }
+  if (batch->num_vertices == 0) {
+    batch->ptex_face_index = ptex_face_index;
+    batch->coarse_poly_index = coarse_poly_index;
+    batch->coarse_corner = coarse_corner;
+    batch->start_subdiv_vertex_index = subdiv_vertex_index;
+  }
+  batch->uvs[batch->num_vertices][0] = u;
+  batch->uvs[batch->num_vertices][1] = v;
+  batch->num_vertices++;
+}
+
 static void subdiv_foreach_inner_vertices_regular(SubdivForeachTaskContext *ctx,
                                                   void *tls,
+                                                  InnerVerticesBatch *batch,
                                                   const MPoly *coarse_poly)
 {
   const int resolution = ctx->settings->resolution;
@@ -640,20 +709,15 @@ static void subdiv_foreach_inner_vertices_regular(SubdivForeachTaskContext *ctx,
     const float v = y * inv_resolution_1;
     for (int x = 1; x < resolution - 1; x++, subdiv_vertex_index++) {
       const float u = x * inv_resolution_1;
-      ctx->foreach_context->vertex_inner(ctx->foreach_context,
-                                         tls,
-                                         ptex_face_index,
-                                         u,
-                                         v,
-                                         coarse_poly_index,
-                                         0,
-                                         subdiv_vertex_index);
+      subdiv_foreach_inner_vertex(
+          ctx, tls, batch, ptex_face_index, u, v, coarse_poly_index, 0, subdiv_vertex_index);
     }
   }
 }
 
 static void subdiv_foreach_inner_vertices_special(SubdivForeachTaskContext *ctx,
                                                   void *tls,
+                                                  InnerVerticesBatch *batch,
                                                   const MPoly *coarse_poly)
 {
   const int resolution = ctx->settings->resolution;
@@ -664,28 +728,23 @@ static void subdiv_foreach_inner_vertices_special(SubdivForeachTaskContext *ctx,
   int ptex_face_index = ctx->face_ptex_offset[coarse_poly_index];
   const int start_vertex_index = ctx->subdiv_vertex_offset[coarse_poly_index];
   int subdiv_vertex_index = ctx->vertices_inner_offset + start_vertex_index;
-  ctx->foreach_context->vertex_inner(ctx->foreach_context,
-                                     tls,
-                                     ptex_face_index,
-                                     1.0f,
-                                     1.0f,
-                                     coarse_poly_index,
-                                     0,
-                                     subdiv_vertex_index);
+  subdiv_foreach_inner_vertex(
+      ctx, tls, batch, ptex_face_index, 1.0f, 1.0f, coarse_poly_index, 0, subdiv_vertex_index);
   subdiv_vertex_index++;
   for (int corner = 0; corner < coarse_poly->totloop; corner++, ptex_face_index++) {
     for (int y = 1; y < ptex_face_resolution - 1; y++) {
       const float v = y * inv_ptex_face_resolution_1;
       for (int x = 1; x < ptex_face_resolution; x++, subdiv_vertex_index++) {
         const float u = x * inv_ptex_face_resolution_1;
-        ctx->foreach_context->vertex_inner(ctx->foreach_context,
-                                           tls,
-                                           ptex_face_index,
-                                           u,
-                                           v,
-                                           coarse_poly_index,
-                                           corner,
-                                           subdiv_vertex_index);
+        subdiv_foreach_inner_vertex(ctx,
+                                    tls,
+                                    batch,
+                                    ptex_face_index,
+                                    u,
+                                    v,
+                                    coarse_poly_index,
+                                    corner,
+                                    subdiv_vertex_index);
       }
     }
   }
@@ -695,12 +754,15 @@ static void subdiv_foreach_inner_vertices(SubdivForeachTaskContext *ctx,
                                           void *tls,
                                           const MPoly *coarse_poly)
 {
+  InnerVerticesBatch batch;
+  batch.num_vertices = 0;
   if (coarse_poly->totloop == 4) {
-    subdiv_foreach_inner_vertices_regular(ctx, tls, coarse_poly);
+    subdiv_foreach_inner_vertices_regular(ctx, tls, &batch, coarse_poly);
   }
   else {
-    subdiv_foreach_inner_vertices_special(ctx, tls, coarse_poly);
+    subdiv_foreach_inner_vertices_special(ctx, tls, &batch, coarse_poly);
   }
+  subdiv_foreach_inner_vertices_batch_flush(ctx, tls, &batch);
 }
 
 /* Traverse all vertices which are emitted from given coarse polygon. */
@@ -709,7 +771,8 @@ static void subdiv_foreach_vertices(SubdivForeachTaskContext *ctx, void *tls, co
   const Mesh *coarse_mesh = ctx->coarse_mesh;
   const MPoly *coarse_mpoly = coarse_mesh->mpoly;
   const MPoly *coarse_poly = &coarse_mpoly[poly_index];
-  if (ctx->foreach_context->vertex_inner != NULL) {
+  const SubdivForeachContext *foreach_context = ctx->foreach_context;
+  if (foreach_context->vertex_inner != NULL || foreach_context->vertices_inner != NULL) {
     subdiv_foreach_inner_vertices(ctx, tls, coarse_poly);
   }
 }
@@ -794,6 +794,50 @@ static void subdiv_mesh_vertex_inner(const SubdivForeachContext *foreach_context
   subdiv_mesh_tag_center_vertex(coarse_poly, subdiv_vert, u, v);
 }
 
+static void subdiv_mesh_vertices_inner(const SubdivForeachContext *foreach_context,
+                                       void *tls_v,
+                                       const int ptex_face_index,
+                                       const float (*uvs)[2],
+                                       const int num_vertices,
+                                       const int coarse_poly_index,
+                                       const int coarse_corner,
+                                       const int start_subdiv_vertex_index)
+{
+  SubdivMeshContext *ctx = foreach_context->user_data;
+  SubdivMeshTLS *tls = tls_v;
+  Subdiv *subdiv = ctx->subdiv;
+  const Mesh *coarse_mesh = ctx->coarse_mesh;
+  const MPoly *coarse_mpoly = coarse_mesh->mpoly;
+  const MPoly *coarse_poly = &coarse_mpoly[coarse_poly_index];
+  Mesh *subdiv_mesh = ctx->subdiv_mesh;
+  MVert *subdiv_mvert = &subdiv_mesh->mvert[start_subdiv_vertex_index];
+  subdiv_mesh_ensure_vertex_interpolation(ctx, tls, coarse_poly, coarse_corner);
+  for (int i = 0; i < num_vertices; i++) {
+    subdiv_vertex_data_interpolate(
+        ctx, &subdiv_mvert[i], &tls->vertex_interpolation, uvs[i][0], uvs[i][1]);
+  }
+  float P[SUBDIV_FOREACH_VERTICES_INNER_BATCH_SIZE][3];
+  if (subdiv->displacement_evaluator == NULL) {
+    /* Same as eval_final_point_and_vertex_normal(), normal is calculated from derivatives. */
+    float dPdu[SUBDIV_FOREACH_VERTICES_INNER_BATCH_SIZE][3];
+    float dPdv[SUBDIV_FOREACH_VERTICES_INNER_BATCH_SIZE][3];
+    BKE_subdiv_eval_limit_points(subdiv, ptex_face_index, uvs, num_vertices, P, dPdu, dPdv);
+    for (int i = 0; i < num_vertices; i++) {
+      float N[3];
+      cross_v3_v3v3(N, dPdu[i], dPdv[i]);
+      normalize_v3(N);
+      normal_float_to_short_v3(subdiv_mvert[i].no, N);
+    }
+  }
+  else {
+    BKE_subdiv_eval_final_points(subdiv, ptex_face_index, uvs, num_vertices, P);
+  }
+  for (int i = 0; i < num_vertices; i++) {
+    copy_v3_v3(subdiv_mvert[i].co, P[i]);
+    subdiv_mesh_tag_center_vertex(coarse_poly, &subdiv_mvert[i], uvs[i][0], uvs[i][1]);
+  }
+}
+
 /** \} */
 
 /* -------------------------------------------------------------------- */
@@ -1175,6 +1219,7 @@ static void setup_foreach_callbacks(const SubdivMeshContext *subdiv_context,
   foreach_context->vertex_corner = subdiv_mesh_vertex_corner;
   foreach_context->vertex_edge = subdiv_mesh_vertex_edge;
   foreach_context->vertex_inner = subdiv_mesh_vertex_inner;
+  foreach_context->vertices_inner = subdiv_mesh_vertices_inner;
   foreach_context->edge = subdiv_mesh_edge;
   foreach_context->loop = subdiv_mesh_loop;
   foreach_context->poly = subdiv_mesh_poly;
@@ -237,6 +237,8 @@ static void tbb_task_pool_work_and_wait(TaskPool *pool)
     BLI_mempool_iternew(pool->suspended_mempool, &iter);
     while (Task *task = (Task *)BLI_mempool_iterstep(&iter)) {
       tbb_task_pool_run(pool, std::move(*task));
+      /* Tasks executed immediately are not moved from, free their data. */
+      task->~Task();
     }
 
     BLI_mempool_clear(pool->suspended_mempool);
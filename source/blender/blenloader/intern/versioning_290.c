@@ -25,6 +25,8 @@
 
 #include "DNA_brush_types.h"
 #include "DNA_genfile.h"
+#include "DNA_modifier_types.h"
+#include "DNA_object_types.h"
 #include "DNA_screen_types.h"
 
 #include "BKE_collection.h"
@@ -96,5 +98,16 @@ void blo_do_versions_290(FileData *fd, Library *UNUSED(lib), Main *bmain)
    */
   {
     /* Keep this block, even when empty. */
+
+    if (!DNA_struct_elem_find(fd->filesdna, "SubsurfModifierData", "float", "camera_edge_size")) {
+      LISTBASE_FOREACH (Object *, ob, &bmain->objects) {
+        LISTBASE_FOREACH (ModifierData *, md, &ob->modifiers) {
+          if (md->type == eModifierType_Subsurf) {
+            SubsurfModifierData *smd = (SubsurfModifierData *)md;
+            smd->camera_edge_size = 2.0f;
+          }
+        }
+      }
+    }
   }
 }
@@ -94,6 +94,15 @@ void DEG_graph_relations_update(struct Depsgraph *graph,
 /* Tag all relations in the database for update.*/
 void DEG_relations_tag_update(struct Main *bmain);
 
+/* Tag relations of the given ID for update in the specified graph.
+ * Unlike DEG_graph_tag_relations_update(), only relations of this ID are rebuilt, when possible.
+ * This is meant for changes which only affect relations built from the ID itself, such as adding
+ * or removing a modifier or constraint of an object. */
+void DEG_graph_id_relations_tag_update(struct Depsgraph *graph, struct ID *id);
+
+/* Tag relations of the given ID for update in all graphs. */
+void DEG_id_relations_tag_update(struct Main *bmain, struct ID *id);
+
 /* Add Dependencies  ----------------------------- */
 
 /* Handle for components to define their dependencies from callbacks.
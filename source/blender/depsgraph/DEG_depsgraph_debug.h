@@ -33,6 +33,7 @@ extern "C" {
 #endif
 
 struct Depsgraph;
+struct Main;
 struct Scene;
 struct ViewLayer;
 
@@ -63,6 +64,19 @@ void DEG_debug_stats_gnuplot(const struct Depsgraph *graph,
                              const char *label,
                              const char *output_filename);
 
+/* ************************************************ */
+/* Evaluation Profiling */
+
+/* Start recording timing of every operation evaluated by the graph, discarding previously
+ * recorded timing. */
+void DEG_debug_profile_begin(struct Depsgraph *depsgraph);
+void DEG_debug_profile_end(struct Depsgraph *depsgraph);
+
+/* Export the recorded timing in the Chrome trace event format (chrome://tracing). */
+void DEG_debug_profile_write_chrome_trace(const struct Depsgraph *depsgraph, FILE *stream);
+/* Export the recorded timing as comma separated values. */
+void DEG_debug_profile_write_csv(const struct Depsgraph *depsgraph, FILE *stream);
+
 /* ************************************************ */
 
 /* Compare two dependency graphs. */
@@ -77,6 +91,10 @@ bool DEG_debug_graph_relations_validate(struct Depsgraph *graph,
 /* Perform consistency check on the graph. */
 bool DEG_debug_consistency_check(struct Depsgraph *graph);
 
+/* Tag all operations of the graph for update and evaluate it.
+ * Is used to benchmark the evaluation engine on a real scene. */
+void DEG_debug_replay_evaluation(struct Main *bmain, struct Depsgraph *graph);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -32,6 +32,7 @@
 #include "DNA_object_types.h"
 
 #include "BLI_stack.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_action.h"
@@ -201,6 +202,15 @@ void deg_graph_build_flush_visibility(Depsgraph *graph)
   BLI_stack_free(stack);
 }
 
+void finalize_build_id_node_func(void *__restrict data_v,
+                                 const int i,
+                                 const TaskParallelTLS *__restrict /*tls*/)
+{
+  Depsgraph *graph = (Depsgraph *)data_v;
+  IDNode *id_node = graph->id_nodes[i];
+  id_node->finalize_build(graph);
+}
+
 }  // namespace
 
 void deg_graph_build_finalize(Main *bmain, Depsgraph *graph)
@@ -208,12 +218,22 @@ void deg_graph_build_finalize(Main *bmain, Depsgraph *graph)
   /* Make sure dependencies of visible ID datablocks are visible. */
   deg_graph_build_flush_visibility(graph);
   deg_graph_remove_unused_noops(graph);
+  graph->need_update_critical_path_costs = true;
+
+  /* Finalize build of every ID node. Only touches nodes of the ID itself, so can be done in
+   * parallel. */
+  {
+    const int num_id_nodes = graph->id_nodes.size();
+    TaskParallelSettings settings;
+    BLI_parallel_range_settings_defaults(&settings);
+    settings.min_iter_per_thread = 256;
+    BLI_task_parallel_range(0, num_id_nodes, graph, finalize_build_id_node_func, &settings);
+  }
 
   /* Re-tag IDs for update if it was tagged before the relations
    * update tag. */
   for (IDNode *id_node : graph->id_nodes) {
     ID *id_orig = id_node->id_orig;
-    id_node->finalize_build(graph);
     int flag = 0;
     /* Tag rebuild if special evaluation flags changed. */
     if (id_node->eval_flags != id_node->previous_eval_flags) {
@@ -179,7 +179,9 @@ void solve_cycles(CyclesSolverState *state)
     const int num_visited = get_node_num_visited_children(node);
     for (int i = num_visited; i < node->outlinks.size(); i++) {
       Relation *rel = node->outlinks[i];
-      if (rel->to->type == NodeType::OPERATION) {
+      /* Relations which were already sacrificed are ignored by evaluation. This happens when
+       * cycles are detected again after an incremental update of relations. */
+      if (rel->to->type == NodeType::OPERATION && (rel->flag & RELATION_FLAG_CYCLIC) == 0) {
         OperationNode *to = (OperationNode *)rel->to;
         eCyclicCheckVisitedState to_state = get_node_visited_state(to);
         if (to_state == NODE_IN_STACK) {
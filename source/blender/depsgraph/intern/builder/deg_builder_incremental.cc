@@ -0,0 +1,265 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "intern/builder/deg_builder_incremental.h"
+
+#include "DNA_layer_types.h"
+#include "DNA_object_types.h"
+
+#include "BKE_layer.h"
+
+#include "DEG_depsgraph.h"
+
+#include "intern/builder/deg_builder.h"
+#include "intern/builder/deg_builder_cache.h"
+#include "intern/builder/deg_builder_cycle.h"
+#include "intern/builder/deg_builder_nodes.h"
+#include "intern/builder/deg_builder_relations.h"
+#include "intern/depsgraph.h"
+#include "intern/depsgraph_relation.h"
+#include "intern/depsgraph_type.h"
+#include "intern/node/deg_node.h"
+#include "intern/node/deg_node_component.h"
+#include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
+
+namespace DEG {
+
+namespace {
+
+/* Relation which goes from an operation of an ID which is being rebuilt to an operation of an ID
+ * which is kept in the graph. Such relations are built by the builder of the kept ID, so they are
+ * to be restored once the rebuilt ID has its operations again. */
+struct SavedRelation {
+  ID *id_orig;
+  NodeType component_type;
+  string component_name;
+  OperationCode opcode;
+  string name;
+  int name_tag;
+  Node *to;
+  const char *description;
+  int flag;
+};
+
+bool check_object_can_build_incremental(Depsgraph *graph, Object *object)
+{
+  IDNode *id_node = graph->find_id_node(&object->id);
+  if (id_node == nullptr) {
+    /* Object which is new to the graph might be pulled in by other objects. */
+    return false;
+  }
+  if (!id_node->has_base || id_node->linked_state != DEG_ID_LINKED_DIRECTLY) {
+    return false;
+  }
+  /* Proxies build nodes and relations of other objects. */
+  if (object->proxy != nullptr || object->proxy_from != nullptr ||
+      object->proxy_group != nullptr) {
+    return false;
+  }
+  /* Rigid body relations are built by the scene. */
+  if (object->rigidbody_object != nullptr || object->rigidbody_constraint != nullptr) {
+    return false;
+  }
+  /* Object is to be rebuilt from its base. Bases which are pulled into the graph due to animated
+   * visibility are not handled here. */
+  const int base_flag = (graph->mode == DAG_EVAL_VIEWPORT) ? BASE_ENABLED_VIEWPORT :
+                                                             BASE_ENABLED_RENDER;
+  Base *base = BKE_view_layer_base_find(graph->view_layer, object);
+  if (base == nullptr || (base->flag & base_flag) == 0) {
+    return false;
+  }
+  return true;
+}
+
+bool check_graph_can_build_incremental(Depsgraph *graph)
+{
+  if (graph->need_update || graph->is_render_pipeline_depsgraph) {
+    return false;
+  }
+  /* Cached physics relations are not updated incrementally. */
+  for (int i = 0; i < DEG_PHYSICS_RELATIONS_NUM; i++) {
+    if (graph->physics_relations[i] != nullptr) {
+      return false;
+    }
+  }
+  for (const ID *id : graph->need_update_relations_ids) {
+    if (GS(id->name) != ID_OB) {
+      return false;
+    }
+    if (!check_object_can_build_incremental(graph, (Object *)id)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void save_outgoing_relations(const Vector<IDNode *> &id_nodes,
+                             Vector<SavedRelation> &r_saved_relations)
+{
+  for (IDNode *id_node : id_nodes) {
+    for (ComponentNode *comp_node : id_node->components.values()) {
+      for (OperationNode *op_node : comp_node->operations) {
+        for (Relation *rel : op_node->outlinks) {
+          if (rel->to->type != NodeType::OPERATION) {
+            continue;
+          }
+          OperationNode *op_to = (OperationNode *)rel->to;
+          if (id_nodes.contains(op_to->owner->owner)) {
+            continue;
+          }
+          SavedRelation saved_relation;
+          saved_relation.id_orig = id_node->id_orig;
+          saved_relation.component_type = comp_node->type;
+          saved_relation.component_name = comp_node->name;
+          saved_relation.opcode = op_node->opcode;
+          saved_relation.name = op_node->name;
+          saved_relation.name_tag = op_node->name_tag;
+          saved_relation.to = op_to;
+          saved_relation.description = rel->name;
+          /* Cycles are detected again once the update is done. */
+          saved_relation.flag = rel->flag & ~RELATION_FLAG_CYCLIC;
+          r_saved_relations.append(saved_relation);
+        }
+      }
+    }
+  }
+}
+
+bool restore_outgoing_relations(Depsgraph *graph, const Vector<SavedRelation> &saved_relations)
+{
+  for (const SavedRelation &saved_relation : saved_relations) {
+    IDNode *id_node = graph->find_id_node(saved_relation.id_orig);
+    if (id_node == nullptr) {
+      return false;
+    }
+    ComponentNode *comp_node = id_node->find_component(saved_relation.component_type,
+                                                       saved_relation.component_name.c_str());
+    if (comp_node == nullptr) {
+      return false;
+    }
+    OperationNode *op_from = comp_node->find_operation(
+        saved_relation.opcode, saved_relation.name.c_str(), saved_relation.name_tag);
+    if (op_from == nullptr) {
+      /* Operation is gone, so the kept ID needs its relations to be built again. */
+      return false;
+    }
+    graph->add_new_relation(
+        op_from, saved_relation.to, saved_relation.description, saved_relation.flag);
+  }
+  return true;
+}
+
+/* No-op operations of the kept IDs which have no outgoing relations. Relations to such
+ * operations got removed by #deg_graph_remove_unused_noops() when the graph was built. */
+void find_unused_noops(Depsgraph *graph,
+                       const Vector<IDNode *> &id_nodes,
+                       Vector<OperationNode *> &r_unused_noops)
+{
+  for (OperationNode *op_node : graph->operations) {
+    if (!op_node->is_noop() || (op_node->flag & DEPSOP_FLAG_PINNED) ||
+        !op_node->outlinks.is_empty()) {
+      continue;
+    }
+    if (id_nodes.contains(op_node->owner->owner)) {
+      continue;
+    }
+    r_unused_noops.append(op_node);
+  }
+}
+
+}  // namespace
+
+bool deg_graph_build_incremental(Main *bmain, Depsgraph *graph)
+{
+  if (!check_graph_can_build_incremental(graph)) {
+    return false;
+  }
+  Vector<IDNode *> id_nodes;
+  for (const ID *id : graph->need_update_relations_ids) {
+    id_nodes.append(graph->find_id_node(id));
+  }
+  Vector<SavedRelation> saved_relations;
+  save_outgoing_relations(id_nodes, saved_relations);
+  Vector<OperationNode *> unused_noops;
+  find_unused_noops(graph, id_nodes, unused_noops);
+
+  DepsgraphBuilderCache builder_cache;
+  DepsgraphNodeBuilder node_builder(bmain, graph, &builder_cache);
+  DepsgraphRelationBuilder relation_builder(bmain, graph, &builder_cache);
+  /* Remove nodes of the IDs which are being rebuilt. */
+  node_builder.begin_build_incremental(id_nodes);
+  relation_builder.begin_build_incremental();
+  const int num_kept_id_nodes = graph->id_nodes.size();
+  const int num_kept_operations = graph->operations.size();
+
+  /* Build nodes of the removed IDs, and of IDs they started to depend on. */
+  node_builder.build_view_layer_incremental(graph->scene, graph->view_layer);
+  node_builder.end_build();
+  Set<const IDNode *> new_id_nodes;
+  for (int i = num_kept_id_nodes; i < graph->id_nodes.size(); i++) {
+    new_id_nodes.add_new(graph->id_nodes[i]);
+  }
+  /* Operations added to the kept IDs (for example, ID property operation for a new driver
+   * variable) are not covered by the copy-on-write relations of those IDs. */
+  for (int i = num_kept_operations; i < graph->operations.size(); i++) {
+    if (!new_id_nodes.contains(graph->operations[i]->owner->owner)) {
+      return false;
+    }
+  }
+
+  /* Build relations of the new nodes. */
+  relation_builder.build_view_layer_incremental(graph->scene, graph->view_layer);
+  for (int i = num_kept_id_nodes; i < graph->id_nodes.size(); i++) {
+    IDNode *id_node = graph->id_nodes[i];
+    relation_builder.build_copy_on_write_relations(id_node);
+    relation_builder.build_object_data_copy_on_write_relations(id_node);
+    relation_builder.build_driver_relations(id_node);
+  }
+  if (!restore_outgoing_relations(graph, saved_relations)) {
+    return false;
+  }
+  /* The rebuilt IDs started to depend on a no-op which lost its incoming relations, so the
+   * ordering of the no-op with the operations it is waiting for is to be built again. */
+  for (OperationNode *op_node : unused_noops) {
+    if (!op_node->outlinks.is_empty()) {
+      return false;
+    }
+  }
+
+  /* Finalize building, same as for the full build. */
+  deg_graph_detect_cycles(graph);
+  deg_graph_build_finalize(bmain, graph);
+  /* Evaluated state of the rebuilt IDs is to follow their new relations. */
+  for (const ID *id : graph->need_update_relations_ids) {
+    IDNode *id_node = graph->find_id_node(id);
+    if (id_node != nullptr) {
+      id_node->tag_update(graph, DEG_UPDATE_SOURCE_RELATIONS);
+    }
+  }
+  DEG_graph_on_visible_update(bmain, reinterpret_cast<::Depsgraph *>(graph), false);
+  graph->need_update_relations_ids.clear();
+  return true;
+}
+
+}  // namespace DEG
@@ -0,0 +1,40 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#pragma once
+
+struct Main;
+
+namespace DEG {
+
+struct Depsgraph;
+
+/* Update relations of IDs from Depsgraph::need_update_relations_ids without rebuilding the whole
+ * graph: nodes of those IDs are removed from the graph and are built again, the rest of the graph
+ * is kept as-is.
+ *
+ * Returns false if the update can not be done incrementally. In this case the graph might have
+ * been partially updated, and the caller is to rebuild the whole graph. */
+bool deg_graph_build_incremental(Main *bmain, Depsgraph *graph);
+
+}  // namespace DEG
@@ -165,13 +165,14 @@ IDNode *DepsgraphNodeBuilder::add_id_node(ID *id)
     id_info->id_cow = nullptr;
   }
   id_node = graph_->add_id_node(id, id_cow);
-  id_node->previously_visible_components_mask = previously_visible_components_mask;
-  id_node->previous_eval_flags = previous_eval_flags;
-  id_node->previous_customdata_masks = previous_customdata_masks;
   /* Currently all ID nodes are supposed to have copy-on-write logic.
    *
-   * NOTE: Zero number of components indicates that ID node was just created. */
+   * NOTE: Zero number of components indicates that ID node was just created. Nodes which are
+   * kept by incremental update are to preserve their state. */
   if (id_node->components.is_empty()) {
+    id_node->previously_visible_components_mask = previously_visible_components_mask;
+    id_node->previous_eval_flags = previous_eval_flags;
+    id_node->previous_customdata_masks = previous_customdata_masks;
     ComponentNode *comp_cow = id_node->add_component(NodeType::COPY_ON_WRITE);
     OperationNode *op_cow = comp_cow->add_operation(
         function_bind(deg_evaluate_copy_on_write, _1, id_node),
@@ -310,43 +311,15 @@ void DepsgraphNodeBuilder::begin_build()
   /* Store existing copy-on-write versions of datablock, so we can re-use
    * them for new ID nodes. */
   for (IDNode *id_node : graph_->id_nodes) {
-    /* It is possible that the ID does not need to have CoW version in which case id_cow is the
-     * same as id_orig. Additionally, such ID might have been removed, which makes the check
-     * for whether id_cow is expanded to access freed memory. In order to deal with this we
-     * check whether CoW is needed based on a scalar value which does not lead to access of
-     * possibly deleted memory.
-     * Additionally, this saves some space in the map by skipping mapping for datablocks which
-     * do not need CoW, */
-    if (!deg_copy_on_write_is_needed(id_node->id_type)) {
-      id_node->id_cow = nullptr;
-      continue;
-    }
-
-    IDInfo *id_info = (IDInfo *)MEM_mallocN(sizeof(IDInfo), "depsgraph id info");
-    if (deg_copy_on_write_is_expanded(id_node->id_cow) && id_node->id_orig != id_node->id_cow) {
-      id_info->id_cow = id_node->id_cow;
-    }
-    else {
-      id_info->id_cow = nullptr;
-    }
-    id_info->previously_visible_components_mask = id_node->visible_components_mask;
-    id_info->previous_eval_flags = id_node->eval_flags;
-    id_info->previous_customdata_masks = id_node->customdata_masks;
-    id_info_hash_.add_new(id_node->id_orig, id_info);
-    id_node->id_cow = nullptr;
+    save_id_info(id_node);
   }
 
   for (OperationNode *op_node : graph_->entry_tags) {
-    ComponentNode *comp_node = op_node->owner;
-    IDNode *id_node = comp_node->owner;
+    save_entry_tag(op_node);
+  }
 
-    SavedEntryTag entry_tag;
-    entry_tag.id_orig = id_node->id_orig;
-    entry_tag.component_type = comp_node->type;
-    entry_tag.opcode = op_node->opcode;
-    entry_tag.name = op_node->name;
-    entry_tag.name_tag = op_node->name_tag;
-    saved_entry_tags_.push_back(entry_tag);
+  for (OperationNode *op_node : graph_->operations) {
+    save_evaluation_cost(op_node);
   }
 
   /* Make sure graph has no nodes left from previous state. */
@@ -355,6 +328,95 @@ void DepsgraphNodeBuilder::begin_build()
   graph_->entry_tags.clear();
 }
 
+void DepsgraphNodeBuilder::begin_build_incremental(const Vector<IDNode *> &id_nodes)
+{
+  for (IDNode *id_node : id_nodes) {
+    save_id_info(id_node);
+    for (ComponentNode *comp_node : id_node->components.values()) {
+      for (OperationNode *op_node : comp_node->operations) {
+        if (graph_->entry_tags.contains(op_node)) {
+          save_entry_tag(op_node);
+        }
+        save_evaluation_cost(op_node);
+      }
+    }
+  }
+
+  for (IDNode *id_node : id_nodes) {
+    graph_->remove_id_node(id_node);
+  }
+
+  /* Nodes which are kept are considered built, and their current state is what the state after
+   * the update is to be compared against. */
+  for (IDNode *id_node : graph_->id_nodes) {
+    built_map_.tagBuild(id_node->id_orig);
+    id_node->previously_visible_components_mask = id_node->visible_components_mask;
+    id_node->previous_eval_flags = id_node->eval_flags;
+    id_node->previous_customdata_masks = id_node->customdata_masks;
+  }
+}
+
+void DepsgraphNodeBuilder::save_id_info(IDNode *id_node)
+{
+  /* It is possible that the ID does not need to have CoW version in which case id_cow is the
+   * same as id_orig. Additionally, such ID might have been removed, which makes the check
+   * for whether id_cow is expanded to access freed memory. In order to deal with this we
+   * check whether CoW is needed based on a scalar value which does not lead to access of
+   * possibly deleted memory.
+   * Additionally, this saves some space in the map by skipping mapping for datablocks which
+   * do not need CoW, */
+  if (!deg_copy_on_write_is_needed(id_node->id_type)) {
+    id_node->id_cow = nullptr;
+    return;
+  }
+
+  IDInfo *id_info = (IDInfo *)MEM_mallocN(sizeof(IDInfo), "depsgraph id info");
+  if (deg_copy_on_write_is_expanded(id_node->id_cow) && id_node->id_orig != id_node->id_cow) {
+    id_info->id_cow = id_node->id_cow;
+  }
+  else {
+    id_info->id_cow = nullptr;
+  }
+  id_info->previously_visible_components_mask = id_node->visible_components_mask;
+  id_info->previous_eval_flags = id_node->eval_flags;
+  id_info->previous_customdata_masks = id_node->customdata_masks;
+  id_info_hash_.add_new(id_node->id_orig, id_info);
+  id_node->id_cow = nullptr;
+}
+
+void DepsgraphNodeBuilder::save_entry_tag(OperationNode *op_node)
+{
+  ComponentNode *comp_node = op_node->owner;
+  IDNode *id_node = comp_node->owner;
+
+  SavedEntryTag entry_tag;
+  entry_tag.id_orig = id_node->id_orig;
+  entry_tag.component_type = comp_node->type;
+  entry_tag.opcode = op_node->opcode;
+  entry_tag.name = op_node->name;
+  entry_tag.name_tag = op_node->name_tag;
+  saved_entry_tags_.push_back(entry_tag);
+}
+
+void DepsgraphNodeBuilder::save_evaluation_cost(OperationNode *op_node)
+{
+  if (op_node->evaluation_cost == 0.0f) {
+    return;
+  }
+  ComponentNode *comp_node = op_node->owner;
+  IDNode *id_node = comp_node->owner;
+
+  SavedEvaluationCost evaluation_cost;
+  evaluation_cost.id_orig = id_node->id_orig;
+  evaluation_cost.component_type = comp_node->type;
+  evaluation_cost.component_name = comp_node->name;
+  evaluation_cost.opcode = op_node->opcode;
+  evaluation_cost.name = op_node->name;
+  evaluation_cost.name_tag = op_node->name_tag;
+  evaluation_cost.evaluation_cost = op_node->evaluation_cost;
+  saved_evaluation_costs_.push_back(evaluation_cost);
+}
+
 void DepsgraphNodeBuilder::end_build()
 {
   for (const SavedEntryTag &entry_tag : saved_entry_tags_) {
@@ -375,6 +437,24 @@ void DepsgraphNodeBuilder::end_build()
      * that originally node was explicitly tagged for user update. */
     op_node->tag_update(graph_, DEG_UPDATE_SOURCE_USER_EDIT);
   }
+
+  for (const SavedEvaluationCost &evaluation_cost : saved_evaluation_costs_) {
+    IDNode *id_node = find_id_node(evaluation_cost.id_orig);
+    if (id_node == nullptr) {
+      continue;
+    }
+    ComponentNode *comp_node = id_node->find_component(evaluation_cost.component_type,
+                                                       evaluation_cost.component_name.c_str());
+    if (comp_node == nullptr) {
+      continue;
+    }
+    OperationNode *op_node = comp_node->find_operation(
+        evaluation_cost.opcode, evaluation_cost.name.c_str(), evaluation_cost.name_tag);
+    if (op_node == nullptr) {
+      continue;
+    }
+    op_node->evaluation_cost = evaluation_cost.evaluation_cost;
+  }
 }
 
 void DepsgraphNodeBuilder::build_id(ID *id)
@@ -99,6 +99,12 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
   virtual void begin_build();
   virtual void end_build();
 
+  /* Begin incremental update of the graph: only nodes of the given IDs are removed from the graph
+   * and are to be built again, the rest of the graph is kept as-is.
+   * The removed IDs are expected to have no other relations than the ones which are built from
+   * the IDs themselves or go from their operations to the operations of other IDs. */
+  virtual void begin_build_incremental(const Vector<IDNode *> &id_nodes);
+
   IDNode *add_id_node(ID *id);
   IDNode *find_id_node(ID *id);
   TimeSourceNode *add_time_source();
@@ -160,6 +166,9 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
   virtual void build_view_layer(Scene *scene,
                                 ViewLayer *view_layer,
                                 eDepsNode_LinkedState_Type linked_state);
+  /* Build objects of the given view layer which are not in the graph yet. Used by incremental
+   * update, after nodes of the objects were removed by begin_build_incremental(). */
+  virtual void build_view_layer_incremental(Scene *scene, ViewLayer *view_layer);
   virtual void build_collection(LayerCollection *from_layer_collection, Collection *collection);
   virtual void build_object(int base_index,
                             Object *object,
@@ -253,6 +262,24 @@ class DepsgraphNodeBuilder : public DepsgraphBuilder {
   };
   vector<SavedEntryTag> saved_entry_tags_;
 
+  /* Evaluation cost of an operation measured by the previous state of the dependency graph.
+   * Allows the scheduler to prioritize critical path right after relations update, without
+   * re-learning the timing of every operation. */
+  struct SavedEvaluationCost {
+    ID *id_orig;
+    NodeType component_type;
+    string component_name;
+    OperationCode opcode;
+    string name;
+    int name_tag;
+    float evaluation_cost;
+  };
+  vector<SavedEvaluationCost> saved_evaluation_costs_;
+
+  void save_id_info(IDNode *id_node);
+  void save_entry_tag(OperationNode *op_node);
+  void save_evaluation_cost(OperationNode *op_node);
+
   struct BuilderWalkUserData {
     DepsgraphNodeBuilder *builder;
     /* Denotes whether object the walk is invoked from is visible. */
@@ -174,4 +174,23 @@ void DepsgraphNodeBuilder::build_view_layer(Scene *scene,
   }
 }
 
+void DepsgraphNodeBuilder::build_view_layer_incremental(Scene *scene, ViewLayer *view_layer)
+{
+  /* Setup currently building context, same as build_view_layer(). */
+  view_layer_index_ = 0;
+  scene_ = scene;
+  view_layer_ = view_layer;
+  /* Base index is to match the one of the full build, so count all bases which are pulled into
+   * the graph. */
+  int base_index = 0;
+  LISTBASE_FOREACH (Base *, base, &view_layer->object_bases) {
+    if (need_pull_base_into_graph(base)) {
+      if (!built_map_.checkIsBuilt(base->object)) {
+        build_object(base_index, base->object, DEG_ID_LINKED_DIRECTLY, true);
+      }
+      base_index++;
+    }
+  }
+}
+
 }  // namespace DEG
@@ -32,6 +32,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_blenlib.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_action_types.h"
@@ -477,6 +478,13 @@ void DepsgraphRelationBuilder::begin_build()
 {
 }
 
+void DepsgraphRelationBuilder::begin_build_incremental()
+{
+  for (IDNode *id_node : graph_->id_nodes) {
+    built_map_.tagBuild(id_node->id_orig);
+  }
+}
+
 void DepsgraphRelationBuilder::build_id(ID *id)
 {
   if (id == nullptr) {
@@ -2651,10 +2659,28 @@ void DepsgraphRelationBuilder::build_scene_speakers(Scene * /*scene*/, ViewLayer
   }
 }
 
+static void build_copy_on_write_relations_func(void *__restrict data_v,
+                                               const int i,
+                                               const TaskParallelTLS *__restrict /*tls*/)
+{
+  DepsgraphRelationBuilder *builder = (DepsgraphRelationBuilder *)data_v;
+  IDNode *id_node = builder->getGraph()->id_nodes[i];
+  builder->build_copy_on_write_relations(id_node);
+}
+
 void DepsgraphRelationBuilder::build_copy_on_write_relations()
 {
+  /* Relations between operations of the same ID are independent from other IDs, so they are
+   * built in parallel. Relations between different IDs are added afterwards, from a single
+   * thread, since they modify nodes of IDs which could be handled by other threads. */
+  const int num_id_nodes = graph_->id_nodes.size();
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 256;
+  BLI_task_parallel_range(0, num_id_nodes, this, build_copy_on_write_relations_func, &settings);
+
   for (IDNode *id_node : graph_->id_nodes) {
-    build_copy_on_write_relations(id_node);
+    build_object_data_copy_on_write_relations(id_node);
   }
 }
 
@@ -2777,23 +2803,6 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
      * evaluation step needs geometry, it will have transitive dependency
      * to Mesh copy-on-write already. */
   }
-  /* TODO(sergey): This solves crash for now, but causes too many
-   * updates potentially. */
-  if (GS(id_orig->name) == ID_OB) {
-    Object *object = (Object *)id_orig;
-    ID *object_data_id = (ID *)object->data;
-    if (object_data_id != nullptr) {
-      if (deg_copy_on_write_is_needed(object_data_id)) {
-        OperationKey data_copy_on_write_key(
-            object_data_id, NodeType::COPY_ON_WRITE, OperationCode::COPY_ON_WRITE);
-        add_relation(
-            data_copy_on_write_key, copy_on_write_key, "Eval Order", RELATION_FLAG_GODMODE);
-      }
-    }
-    else {
-      BLI_assert(object->type == OB_EMPTY);
-    }
-  }
 
 #if 0
   /* NOTE: Relation is disabled since AnimationBackup() is disabled.
@@ -2816,6 +2825,32 @@ void DepsgraphRelationBuilder::build_copy_on_write_relations(IDNode *id_node)
 #endif
 }
 
+/* Relations from copy-on-write of the object data to the copy-on-write of the object.
+ *
+ * NOTE: Modifies nodes of the object data ID, so is not to be called in parallel with
+ * build_copy_on_write_relations(). */
+void DepsgraphRelationBuilder::build_object_data_copy_on_write_relations(IDNode *id_node)
+{
+  ID *id_orig = id_node->id_orig;
+  if (GS(id_orig->name) != ID_OB) {
+    return;
+  }
+  /* TODO(sergey): This solves crash for now, but causes too many
+   * updates potentially. */
+  Object *object = (Object *)id_orig;
+  ID *object_data_id = (ID *)object->data;
+  if (object_data_id == nullptr) {
+    BLI_assert(object->type == OB_EMPTY);
+    return;
+  }
+  if (deg_copy_on_write_is_needed(object_data_id)) {
+    OperationKey copy_on_write_key(id_orig, NodeType::COPY_ON_WRITE, OperationCode::COPY_ON_WRITE);
+    OperationKey data_copy_on_write_key(
+        object_data_id, NodeType::COPY_ON_WRITE, OperationCode::COPY_ON_WRITE);
+    add_relation(data_copy_on_write_key, copy_on_write_key, "Eval Order", RELATION_FLAG_GODMODE);
+  }
+}
+
 static bool is_reachable(const Node *const from, const Node *const to)
 {
   if (from == to) {
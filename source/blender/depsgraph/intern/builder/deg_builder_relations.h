@@ -162,6 +162,9 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
   DepsgraphRelationBuilder(Main *bmain, Depsgraph *graph, DepsgraphBuilderCache *cache);
 
   void begin_build();
+  /* Begin incremental update of the graph: relations of all IDs which are currently in the graph
+   * are considered built. */
+  void begin_build_incremental();
 
   template<typename KeyFrom, typename KeyTo>
   Relation *add_relation(const KeyFrom &key_from,
@@ -207,6 +210,7 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
   virtual void build_view_layer(Scene *scene,
                                 ViewLayer *view_layer,
                                 eDepsNode_LinkedState_Type linked_state);
+  virtual void build_view_layer_incremental(Scene *scene, ViewLayer *view_layer);
   virtual void build_collection(LayerCollection *from_layer_collection,
                                 Object *object,
                                 Collection *collection);
@@ -309,6 +313,7 @@ class DepsgraphRelationBuilder : public DepsgraphBuilder {
 
   virtual void build_copy_on_write_relations();
   virtual void build_copy_on_write_relations(IDNode *id_node);
+  virtual void build_object_data_copy_on_write_relations(IDNode *id_node);
   virtual void build_driver_relations();
   virtual void build_driver_relations(IDNode *id_node);
 
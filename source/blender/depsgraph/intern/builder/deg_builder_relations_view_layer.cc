@@ -153,4 +153,15 @@ void DepsgraphRelationBuilder::build_view_layer(Scene *scene,
   }
 }
 
+void DepsgraphRelationBuilder::build_view_layer_incremental(Scene *scene, ViewLayer *view_layer)
+{
+  /* Setup currently building context. */
+  scene_ = scene;
+  LISTBASE_FOREACH (Base *, base, &view_layer->object_bases) {
+    if (need_pull_base_into_graph(base) && !built_map_.checkIsBuilt(base->object)) {
+      build_object(base, base->object);
+    }
+  }
+}
+
 }  // namespace DEG
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "intern/debug/deg_debug_profile.h"
 #include "intern/debug/deg_time_average.h"
 #include "intern/depsgraph_type.h"
 
@@ -52,6 +53,9 @@ class DepsgraphDebug {
    * This is NOT an indication that depsgraph is at its evaluated state. */
   bool is_ever_evaluated;
 
+  /* Per-operation timing recorder, see DEG_debug_profile_begin(). */
+  EvaluationProfiler profiler;
+
  protected:
   /* Maximum number of counters used to calculate frame rate of depsgraph update. */
   static const constexpr int MAX_FPS_COUNTERS = 64;
@@ -0,0 +1,237 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#include "intern/debug/deg_debug_profile.h"
+
+#include "PIL_time.h"
+
+#include "BLI_utildefines.h"
+
+#include "DEG_depsgraph_debug.h"
+
+#include "atomic_ops.h"
+
+#include "intern/depsgraph.h"
+#include "intern/node/deg_node.h"
+#include "intern/node/deg_node_component.h"
+#include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
+
+namespace DEG {
+
+namespace {
+
+/* Small sequential index of the thread, used to group events of the same thread in the
+ * exported data. */
+int profile_thread_index_get()
+{
+  static int32_t num_threads = 0;
+  static thread_local int thread_index = -1;
+  if (thread_index == -1) {
+    thread_index = atomic_fetch_and_add_int32(&num_threads, 1);
+  }
+  return thread_index;
+}
+
+/* Write string as a JSON string literal. */
+void write_json_string(FILE *stream, const string &str)
+{
+  fputc('"', stream);
+  for (const char c : str) {
+    switch (c) {
+      case '"':
+        fputs("\\\"", stream);
+        break;
+      case '\\':
+        fputs("\\\\", stream);
+        break;
+      default:
+        if ((unsigned char)c < 0x20) {
+          fprintf(stream, "\\u%04x", (unsigned int)c);
+        }
+        else {
+          fputc(c, stream);
+        }
+        break;
+    }
+  }
+  fputc('"', stream);
+}
+
+/* Write string as a CSV field, quoted when needed. */
+void write_csv_string(FILE *stream, const string &str)
+{
+  if (str.find_first_of(",\"\n") == string::npos) {
+    fputs(str.c_str(), stream);
+    return;
+  }
+  fputc('"', stream);
+  for (const char c : str) {
+    if (c == '"') {
+      fputc('"', stream);
+    }
+    fputc(c, stream);
+  }
+  fputc('"', stream);
+}
+
+}  // namespace
+
+EvaluationProfiler::EvaluationProfiler() : is_active_(false), begin_time_(0.0)
+{
+  BLI_spin_init(&lock_);
+}
+
+EvaluationProfiler::~EvaluationProfiler()
+{
+  BLI_spin_end(&lock_);
+}
+
+void EvaluationProfiler::begin()
+{
+  events_.clear();
+  operations_.clear();
+  operation_index_map_.clear();
+  begin_time_ = PIL_check_seconds_timer();
+  is_active_ = true;
+}
+
+void EvaluationProfiler::end()
+{
+  is_active_ = false;
+}
+
+int EvaluationProfiler::operation_index_get(const OperationNode *operation_node)
+{
+  const int *index_ptr = operation_index_map_.lookup_ptr(operation_node);
+  if (index_ptr != nullptr) {
+    return *index_ptr;
+  }
+  const ComponentNode *comp_node = operation_node->owner;
+  const IDNode *id_node = comp_node->owner;
+  OperationInfo info;
+  info.id_name = id_node->name;
+  info.component_name = nodeTypeAsString(comp_node->type);
+  if (!comp_node->name.empty()) {
+    info.component_name += "/" + comp_node->name;
+  }
+  info.operation_name = operation_node->identifier();
+  const int index = operations_.size();
+  operations_.append(info);
+  operation_index_map_.add_new(operation_node, index);
+  return index;
+}
+
+void EvaluationProfiler::record(const OperationNode *operation_node,
+                                float frame,
+                                double start_time,
+                                double end_time)
+{
+  Event event;
+  event.thread_index = profile_thread_index_get();
+  event.frame = frame;
+  event.start_time = start_time - begin_time_;
+  event.end_time = end_time - begin_time_;
+  BLI_spin_lock(&lock_);
+  event.operation_index = operation_index_get(operation_node);
+  events_.append(event);
+  BLI_spin_unlock(&lock_);
+}
+
+void EvaluationProfiler::clear_operation_nodes()
+{
+  operation_index_map_.clear();
+}
+
+void EvaluationProfiler::write_chrome_trace(FILE *stream) const
+{
+  fprintf(stream, "{\"traceEvents\": [\n");
+  bool is_first = true;
+  for (const Event &event : events_) {
+    const OperationInfo &info = operations_[event.operation_index];
+    if (!is_first) {
+      fprintf(stream, ",\n");
+    }
+    is_first = false;
+    fprintf(stream, "{\"name\": ");
+    write_json_string(stream, info.operation_name);
+    fprintf(stream, ", \"cat\": ");
+    write_json_string(stream, info.id_name + "/" + info.component_name);
+    fprintf(stream,
+            ", \"ph\": \"X\", \"pid\": 0, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f",
+            event.thread_index,
+            event.start_time * 1e6,
+            (event.end_time - event.start_time) * 1e6);
+    fprintf(stream, ", \"args\": {\"frame\": %g, \"id\": ", event.frame);
+    write_json_string(stream, info.id_name);
+    fprintf(stream, ", \"component\": ");
+    write_json_string(stream, info.component_name);
+    fprintf(stream, "}}");
+  }
+  fprintf(stream, "\n], \"displayTimeUnit\": \"ms\"}\n");
+}
+
+void EvaluationProfiler::write_csv(FILE *stream) const
+{
+  fprintf(stream, "frame,thread,id,component,operation,start_ms,end_ms,duration_ms\n");
+  for (const Event &event : events_) {
+    const OperationInfo &info = operations_[event.operation_index];
+    fprintf(stream, "%g,%d,", event.frame, event.thread_index);
+    write_csv_string(stream, info.id_name);
+    fputc(',', stream);
+    write_csv_string(stream, info.component_name);
+    fputc(',', stream);
+    write_csv_string(stream, info.operation_name);
+    fprintf(stream,
+            ",%.6f,%.6f,%.6f\n",
+            event.start_time * 1e3,
+            event.end_time * 1e3,
+            (event.end_time - event.start_time) * 1e3);
+  }
+}
+
+}  // namespace DEG
+
+void DEG_debug_profile_begin(Depsgraph *depsgraph)
+{
+  DEG::Depsgraph *deg_graph = reinterpret_cast<DEG::Depsgraph *>(depsgraph);
+  deg_graph->debug.profiler.begin();
+}
+
+void DEG_debug_profile_end(Depsgraph *depsgraph)
+{
+  DEG::Depsgraph *deg_graph = reinterpret_cast<DEG::Depsgraph *>(depsgraph);
+  deg_graph->debug.profiler.end();
+}
+
+void DEG_debug_profile_write_chrome_trace(const Depsgraph *depsgraph, FILE *stream)
+{
+  const DEG::Depsgraph *deg_graph = reinterpret_cast<const DEG::Depsgraph *>(depsgraph);
+  deg_graph->debug.profiler.write_chrome_trace(stream);
+}
+
+void DEG_debug_profile_write_csv(const Depsgraph *depsgraph, FILE *stream)
+{
+  const DEG::Depsgraph *deg_graph = reinterpret_cast<const DEG::Depsgraph *>(depsgraph);
+  deg_graph->debug.profiler.write_csv(stream);
+}
@@ -0,0 +1,99 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 Blender Foundation.
+ * All rights reserved.
+ */
+
+/** \file
+ * \ingroup depsgraph
+ */
+
+#pragma once
+
+#include <stdio.h>
+
+#include "BLI_threads.h" /* for SpinLock */
+
+#include "intern/depsgraph_type.h"
+
+namespace DEG {
+
+struct OperationNode;
+
+/* Records timing of every operation evaluated by the dependency graph, so it can be exported
+ * for an external analysis of the evaluation.
+ *
+ * Recording is only done between begin() and end(), so the profiler has no effect on the
+ * evaluation when it is not active. */
+class EvaluationProfiler {
+ public:
+  EvaluationProfiler();
+  ~EvaluationProfiler();
+
+  /* Start recording, discarding all previously recorded events. */
+  void begin();
+  /* Stop recording. Recorded events are kept until the next begin(). */
+  void end();
+
+  bool is_active() const
+  {
+    return is_active_;
+  }
+
+  /* Record evaluation of an operation. Times are in seconds, as returned by
+   * PIL_check_seconds_timer(). Is safe to be called from multiple threads. */
+  void record(const OperationNode *operation_node,
+              float frame,
+              double start_time,
+              double end_time);
+
+  /* Forget all pointers to operation nodes, must be called before nodes are freed.
+   * Already recorded events are kept. */
+  void clear_operation_nodes();
+
+  /* Export recorded events in the Chrome trace event format (chrome://tracing). */
+  void write_chrome_trace(FILE *stream) const;
+  /* Export recorded events as a table with comma separated values. */
+  void write_csv(FILE *stream) const;
+
+ protected:
+  /* Operation description, resolved once per operation node. */
+  struct OperationInfo {
+    string id_name;
+    string component_name;
+    string operation_name;
+  };
+
+  struct Event {
+    int operation_index;
+    int thread_index;
+    float frame;
+    double start_time;
+    double end_time;
+  };
+
+  int operation_index_get(const OperationNode *operation_node);
+
+  bool is_active_;
+  double begin_time_;
+
+  SpinLock lock_;
+  Vector<OperationInfo> operations_;
+  Map<const OperationNode *, int> operation_index_map_;
+  Vector<Event> events_;
+};
+
+}  // namespace DEG
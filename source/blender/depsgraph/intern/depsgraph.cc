@@ -60,6 +60,7 @@ namespace DEG {
 Depsgraph::Depsgraph(Main *bmain, Scene *scene, ViewLayer *view_layer, eEvaluationMode mode)
     : time_source(nullptr),
       need_update(true),
+      need_update_critical_path_costs(true),
       need_update_time(false),
       bmain(bmain),
       scene(scene),
@@ -163,6 +164,38 @@ void Depsgraph::clear_id_nodes()
   clear_physics_relations(this);
 }
 
+void Depsgraph::remove_id_node(IDNode *id_node)
+{
+  for (ComponentNode *comp_node : id_node->components.values()) {
+    for (OperationNode *op_node : comp_node->operations) {
+      while (!op_node->inlinks.is_empty()) {
+        Relation *rel = op_node->inlinks[0];
+        rel->unlink();
+        OBJECT_GUARDED_DELETE(rel, Relation);
+      }
+      while (!op_node->outlinks.is_empty()) {
+        Relation *rel = op_node->outlinks[0];
+        rel->unlink();
+        OBJECT_GUARDED_DELETE(rel, Relation);
+      }
+      if (entry_tags.contains(op_node)) {
+        entry_tags.remove(op_node);
+      }
+    }
+  }
+  operations.erase(std::remove_if(operations.begin(),
+                                  operations.end(),
+                                  [id_node](OperationNode *op_node) {
+                                    return op_node->owner->owner == id_node;
+                                  }),
+                   operations.end());
+  id_nodes.erase(std::remove(id_nodes.begin(), id_nodes.end(), id_node), id_nodes.end());
+  id_hash.remove(id_node->id_orig);
+  /* Profiler addresses operations by pointer, which are about to be freed. */
+  debug.profiler.clear_operation_nodes();
+  OBJECT_GUARDED_DELETE(id_node, IDNode);
+}
+
 /* Add new relation between two nodes */
 Relation *Depsgraph::add_new_relation(Node *from, Node *to, const char *description, int flags)
 {
@@ -225,6 +258,7 @@ void Depsgraph::add_entry_tag(OperationNode *node)
 
 void Depsgraph::clear_all_nodes()
 {
+  debug.profiler.clear_operation_nodes();
   clear_id_nodes();
   if (time_source != nullptr) {
     OBJECT_GUARDED_DELETE(time_source, TimeSourceNode);
@@ -71,6 +71,10 @@ struct Depsgraph {
   IDNode *add_id_node(ID *id, ID *id_cow_hint = nullptr);
   void clear_id_nodes();
   void clear_id_nodes_conditional(const std::function<bool(ID_Type id_type)> &filter);
+  /* Remove node of the given ID from the graph, together with all relations which are going to or
+   * from its operations.
+   * NOTE: Copy-on-write datablock of the node is freed, unless it was taken by a builder. */
+  void remove_id_node(IDNode *id_node);
 
   /* Add new relationship between two nodes. */
   Relation *add_new_relation(Node *from, Node *to, const char *description, int flags = 0);
@@ -108,6 +112,16 @@ struct Depsgraph {
   /* Indicates whether relations needs to be updated. */
   bool need_update;
 
+  /* Original IDs which relations are to be updated, without rebuilding the whole graph.
+   * Only used when need_update is false, in which case relations are updated incrementally when
+   * possible. */
+  Set<const ID *> need_update_relations_ids;
+
+  /* Indicates whether critical path costs of operations are to be calculated before the next
+   * evaluation. Is set when relations are updated, and when operations got their evaluation time
+   * measured for the first time. */
+  bool need_update_critical_path_costs;
+
   /* Indicates which ID types were updated. */
   char id_type_updated[MAX_LIBARRAY];
 
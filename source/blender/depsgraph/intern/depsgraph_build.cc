@@ -46,6 +46,7 @@
 #include "builder/deg_builder.h"
 #include "builder/deg_builder_cache.h"
 #include "builder/deg_builder_cycle.h"
+#include "builder/deg_builder_incremental.h"
 #include "builder/deg_builder_nodes.h"
 #include "builder/deg_builder_relations.h"
 #include "builder/deg_builder_transitive.h"
@@ -231,6 +232,7 @@ static void graph_build_finalize_common(DEG::Depsgraph *deg_graph, Main *bmain)
 #endif
   /* Relations are up to date. */
   deg_graph->need_update = false;
+  deg_graph->need_update_relations_ids.clear();
 }
 
 /* Build depsgraph for the given scene layer, and dump results in given graph container. */
@@ -501,8 +503,24 @@ void DEG_graph_relations_update(Depsgraph *graph, Main *bmain, Scene *scene, Vie
 {
   DEG::Depsgraph *deg_graph = (DEG::Depsgraph *)graph;
   if (!deg_graph->need_update) {
-    /* Graph is up to date, nothing to do. */
-    return;
+    if (deg_graph->need_update_relations_ids.is_empty()) {
+      /* Graph is up to date, nothing to do. */
+      return;
+    }
+    /* Only relations of some IDs are to be updated, try to avoid full rebuild. */
+    BLI_assert(deg_graph->scene == scene);
+    BLI_assert(deg_graph->view_layer == view_layer);
+    double start_time = 0.0;
+    if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
+      start_time = PIL_check_seconds_timer();
+    }
+    if (DEG::deg_graph_build_incremental(bmain, deg_graph)) {
+      if (G.debug & (G_DEBUG_DEPSGRAPH_BUILD | G_DEBUG_DEPSGRAPH_TIME)) {
+        printf("Depsgraph updated incrementally in %f seconds.\n",
+               PIL_check_seconds_timer() - start_time);
+      }
+      return;
+    }
   }
   DEG_graph_build_from_view_layer(graph, bmain, scene, view_layer);
 }
@@ -515,3 +533,25 @@ void DEG_relations_tag_update(Main *bmain)
     DEG_graph_tag_relations_update(reinterpret_cast<Depsgraph *>(depsgraph));
   }
 }
+
+void DEG_graph_id_relations_tag_update(Depsgraph *graph, ID *id)
+{
+  DEG_DEBUG_PRINTF(graph, TAG, "%s: Tagging relations of %s for update.\n", __func__, id->name);
+  DEG::Depsgraph *deg_graph = reinterpret_cast<DEG::Depsgraph *>(graph);
+  if (deg_graph->need_update) {
+    /* Full rebuild of relations is already scheduled. */
+    return;
+  }
+  deg_graph->need_update_relations_ids.add(id);
+}
+
+void DEG_id_relations_tag_update(Main *bmain, ID *id)
+{
+  for (DEG::Depsgraph *depsgraph : DEG::get_all_registered_graphs(bmain)) {
+    /* Relations of an ID which is not in the graph do not affect evaluation of the graph. */
+    if (depsgraph->find_id_node(id) == nullptr) {
+      continue;
+    }
+    DEG_graph_id_relations_tag_update(reinterpret_cast<Depsgraph *>(depsgraph), id);
+  }
+}
@@ -40,6 +40,7 @@
 #include "intern/depsgraph_type.h"
 #include "intern/node/deg_node_component.h"
 #include "intern/node/deg_node_id.h"
+#include "intern/node/deg_node_operation.h"
 #include "intern/node/deg_node_time.h"
 
 void DEG_debug_flags_set(Depsgraph *depsgraph, int flags)
@@ -192,6 +193,20 @@ bool DEG_debug_consistency_check(Depsgraph *graph)
   return true;
 }
 
+void DEG_debug_replay_evaluation(Main *bmain, Depsgraph *graph)
+{
+  DEG::Depsgraph *deg_graph = reinterpret_cast<DEG::Depsgraph *>(graph);
+  for (DEG::OperationNode *node : deg_graph->operations) {
+    /* Copy-on-write operations are not tagged: they would discard the evaluated state of the
+     * datablocks rather than replay their evaluation. */
+    if (node->owner->type == DEG::NodeType::COPY_ON_WRITE) {
+      continue;
+    }
+    node->tag_update(deg_graph, DEG::DEG_UPDATE_SOURCE_TIME);
+  }
+  DEG_evaluate_on_refresh(bmain, graph);
+}
+
 /* ------------------------------------------------ */
 
 /**
@@ -29,7 +29,10 @@
 
 #include "BLI_compiler_attrs.h"
 #include "BLI_gsqueue.h"
+#include "BLI_heap.h"
+#include "BLI_math_base.h"
 #include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "BKE_global.h"
@@ -68,10 +71,7 @@ void schedule_children(DepsgraphEvalState *state,
                        ScheduleFunction *schedule_function,
                        ScheduleFunctionArgs... schedule_function_args);
 
-void schedule_node_to_pool(OperationNode *node, const int UNUSED(thread_id), TaskPool *pool)
-{
-  BLI_task_pool_push(pool, deg_task_run_func, node, false, NULL);
-}
+void schedule_node_to_pool(OperationNode *node, const int thread_id, TaskPool *pool);
 
 /* Denotes which part of dependency graph is being evaluated. */
 enum class EvaluationStage {
@@ -95,32 +95,72 @@ struct DepsgraphEvalState {
   bool do_stats;
   EvaluationStage stage;
   bool need_single_thread_pass;
+  /* Operations which are ready for evaluation, ordered by their critical path cost.
+   * Every task pushed to the pool picks the most expensive operation from this queue, so that
+   * operations on the longest dependency chain start as early as possible. */
+  Heap *ready_queue;
+  SpinLock ready_queue_lock;
+  /* Set when an operation got its evaluation time measured for the first time. */
+  uint8_t has_new_evaluation_costs;
 };
 
-void evaluate_node(const DepsgraphEvalState *state, OperationNode *operation_node)
+/* Cost of an operation which did not have its evaluation time measured yet. Makes it so the
+ * length of the dependency chain is still taken into account by the scheduler. */
+const float UNMEASURED_OPERATION_COST = 1e-6f;
+
+void evaluate_node(DepsgraphEvalState *state, OperationNode *operation_node)
 {
   ::Depsgraph *depsgraph = reinterpret_cast<::Depsgraph *>(state->graph);
 
   /* Sanity checks. */
   BLI_assert(!operation_node->is_noop() && "NOOP nodes should not actually be scheduled");
-  /* Perform operation. */
+  /* Perform operation. The timing is always measured, since it feeds the cost model used for
+   * the critical path scheduling. */
+  const double start_time = PIL_check_seconds_timer();
+  operation_node->evaluate(depsgraph);
+  const double end_time = PIL_check_seconds_timer();
+  const double evaluation_time = end_time - start_time;
+  if (operation_node->evaluation_cost == 0.0f) {
+    atomic_fetch_and_or_uint8(&state->has_new_evaluation_costs, 1);
+  }
+  operation_node->update_evaluation_cost(evaluation_time);
   if (state->do_stats) {
-    const double start_time = PIL_check_seconds_timer();
-    operation_node->evaluate(depsgraph);
-    operation_node->stats.current_time += PIL_check_seconds_timer() - start_time;
+    operation_node->stats.current_time += evaluation_time;
   }
-  else {
-    operation_node->evaluate(depsgraph);
+  EvaluationProfiler &profiler = state->graph->debug.profiler;
+  if (profiler.is_active()) {
+    profiler.record(operation_node, state->graph->ctime, start_time, end_time);
   }
 }
 
-void deg_task_run_func(TaskPool *pool, void *taskdata)
+void schedule_node_to_pool(OperationNode *node, const int UNUSED(thread_id), TaskPool *pool)
+{
+  DepsgraphEvalState *state = (DepsgraphEvalState *)BLI_task_pool_user_data(pool);
+  BLI_spin_lock(&state->ready_queue_lock);
+  /* Heap is sorted in ascending order, so use negative cost to pop most expensive chain first. */
+  BLI_heap_insert(state->ready_queue, -node->critical_path_cost, node);
+  BLI_spin_unlock(&state->ready_queue_lock);
+  /* Every pushed task evaluates exactly one operation, so the queue is never empty when task is
+   * executed. Which operation it will be is decided at the time the task is run. */
+  BLI_task_pool_push(pool, deg_task_run_func, NULL, false, NULL);
+}
+
+OperationNode *pop_ready_node(DepsgraphEvalState *state)
+{
+  BLI_spin_lock(&state->ready_queue_lock);
+  BLI_assert(!BLI_heap_is_empty(state->ready_queue));
+  OperationNode *operation_node = (OperationNode *)BLI_heap_pop_min(state->ready_queue);
+  BLI_spin_unlock(&state->ready_queue_lock);
+  return operation_node;
+}
+
+void deg_task_run_func(TaskPool *pool, void *UNUSED(taskdata))
 {
   void *userdata_v = BLI_task_pool_user_data(pool);
   DepsgraphEvalState *state = (DepsgraphEvalState *)userdata_v;
 
   /* Evaluate node. */
-  OperationNode *operation_node = reinterpret_cast<OperationNode *>(taskdata);
+  OperationNode *operation_node = pop_ready_node(state);
   evaluate_node(state, operation_node);
 
   /* Schedule children. */
@@ -177,10 +217,79 @@ void calculate_pending_parents(Depsgraph *graph)
   }
 }
 
+bool is_relation_used_for_scheduling(const Relation *rel)
+{
+  return rel->to->type == NodeType::OPERATION && (rel->flag & RELATION_FLAG_CYCLIC) == 0;
+}
+
+/* Own cost of the operation on the critical path. Does not depend on which operations are tagged
+ * for update, so that the critical path costs are only calculated when relations or measured
+ * costs change, and not on every evaluation. */
+float operation_node_scheduling_cost(const OperationNode *node)
+{
+  if (node->is_noop()) {
+    return 0.0f;
+  }
+  if (node->evaluation_cost == 0.0f) {
+    return UNMEASURED_OPERATION_COST;
+  }
+  return node->evaluation_cost;
+}
+
+/* Calculate cost of the longest chain of operations starting at every operation.
+ *
+ * Operations are visited in the reverse topological order: an operation is handled once all
+ * of its children got their critical path cost calculated. The custom_flags of the nodes are
+ * used to count children which are not handled yet. */
+void calculate_critical_path_costs(Depsgraph *graph)
+{
+  GSQueue *queue = BLI_gsqueue_new(sizeof(OperationNode *));
+  for (OperationNode *node : graph->operations) {
+    int num_children = 0;
+    for (Relation *rel : node->outlinks) {
+      if (is_relation_used_for_scheduling(rel)) {
+        ++num_children;
+      }
+    }
+    node->custom_flags = num_children;
+    node->critical_path_cost = operation_node_scheduling_cost(node);
+    if (num_children == 0) {
+      BLI_gsqueue_push(queue, &node);
+    }
+  }
+  while (!BLI_gsqueue_is_empty(queue)) {
+    OperationNode *node;
+    BLI_gsqueue_pop(queue, &node);
+    float max_child_cost = 0.0f;
+    for (Relation *rel : node->outlinks) {
+      if (is_relation_used_for_scheduling(rel)) {
+        const OperationNode *child = (OperationNode *)rel->to;
+        max_child_cost = max_ff(max_child_cost, child->critical_path_cost);
+      }
+    }
+    node->critical_path_cost = operation_node_scheduling_cost(node) + max_child_cost;
+    for (Relation *rel : node->inlinks) {
+      if (rel->from->type != NodeType::OPERATION || (rel->flag & RELATION_FLAG_CYCLIC) != 0) {
+        continue;
+      }
+      OperationNode *parent = (OperationNode *)rel->from;
+      BLI_assert(parent->custom_flags > 0);
+      if (--parent->custom_flags == 0) {
+        BLI_gsqueue_push(queue, &parent);
+      }
+    }
+  }
+  BLI_gsqueue_free(queue);
+}
+
 void initialize_execution(DepsgraphEvalState *state, Depsgraph *graph)
 {
   const bool do_stats = state->do_stats;
   calculate_pending_parents(graph);
+  if (graph->need_update_critical_path_costs) {
+    calculate_critical_path_costs(graph);
+    graph->need_update_critical_path_costs = false;
+  }
   /* Clear tags and other things which needs to be clear. */
   for (OperationNode *node : graph->operations) {
     if (do_stats) {
@@ -380,6 +489,9 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
   state.graph = graph;
   state.do_stats = graph->debug.do_time_debug();
   state.need_single_thread_pass = false;
+  state.ready_queue = BLI_heap_new();
+  BLI_spin_init(&state.ready_queue_lock);
+  state.has_new_evaluation_costs = false;
   /* Prepare all nodes for evaluation. */
   initialize_execution(&state, graph);
 
@@ -403,6 +515,17 @@ void deg_evaluate_on_refresh(Depsgraph *graph)
     evaluate_graph_single_threaded(&state);
   }
 
+  BLI_assert(BLI_heap_is_empty(state.ready_queue));
+  BLI_heap_free(state.ready_queue, NULL);
+  BLI_spin_end(&state.ready_queue_lock);
+
+  /* Operations which were evaluated for the first time now have a measured cost, which is used
+   * by the next evaluation. Running average updates of already measured operations are picked up
+   * on the next relations update. */
+  if (state.has_new_evaluation_costs) {
+    graph->need_update_critical_path_costs = true;
+  }
+
   /* Finalize statistics gathering. This is because we only gather single
    * operation timing here, without aggregating anything to avoid any extra
    * synchronization. */
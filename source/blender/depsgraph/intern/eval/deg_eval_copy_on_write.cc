@@ -41,11 +41,13 @@
 #include "BLI_utildefines.h"
 
 #include "BKE_curve.h"
+#include "BKE_customdata.h"
 #include "BKE_global.h"
 #include "BKE_gpencil.h"
 #include "BKE_idprop.h"
 #include "BKE_layer.h"
 #include "BKE_lib_id.h"
+#include "BKE_mesh.h"
 #include "BKE_scene.h"
 
 #include "DEG_depsgraph.h"
@@ -298,6 +300,40 @@ bool id_copy_inplace_no_main(const ID *id, ID *newid)
   return result;
 }
 
+/* Geometry of meshes which can not be modified in-place can be shared between the original and
+ * copy-on-write datablocks: original arrays are guaranteed to outlive the copy.
+ * Evaluation never modifies referenced layers in-place, it duplicates them first (see
+ * CustomData_duplicate_referenced_layer()), so sharing is transparent to the modifier stack. */
+bool mesh_can_share_geometry(const Mesh *mesh)
+{
+  return ID_IS_LINKED(mesh) && mesh->edit_mesh == nullptr;
+}
+
+/* Similar to id_copy_inplace_no_main() but custom data layers of the copy are referencing the
+ * original arrays instead of being duplicated. */
+bool mesh_copy_inplace_no_main_shared(const Mesh *mesh, Mesh *new_mesh)
+{
+  BLI_assert(mesh_can_share_geometry(mesh));
+  if (!BKE_id_copy_ex(nullptr,
+                      &mesh->id,
+                      (ID **)&new_mesh,
+                      (LIB_ID_COPY_LOCALIZE | LIB_ID_CREATE_NO_ALLOCATE |
+                       LIB_ID_COPY_CD_REFERENCE))) {
+    return false;
+  }
+  /* Dirty normals are calculated in-place by BKE_mesh_ensure_normals_for_display(), which does
+   * not go through CustomData_duplicate_referenced_layer(). Own the layers which store them, so
+   * that the original mesh is not written to. */
+  if (new_mesh->runtime.cd_dirty_vert & CD_MASK_NORMAL) {
+    CustomData_duplicate_referenced_layer(&new_mesh->vdata, CD_MVERT, new_mesh->totvert);
+  }
+  if (new_mesh->runtime.cd_dirty_poly & CD_MASK_NORMAL) {
+    CustomData_duplicate_referenced_layer(&new_mesh->pdata, CD_NORMAL, new_mesh->totpoly);
+  }
+  BKE_mesh_update_customdata_pointers(new_mesh, false);
+  return true;
+}
+
 /* Similar to BKE_scene_copy() but does not require main and assumes pointer
  * is already allocated. */
 bool scene_copy_inplace_no_main(const Scene *scene, Scene *new_scene)
@@ -860,8 +896,6 @@ ID *deg_expand_copy_on_write_datablock(const Depsgraph *depsgraph,
   }
   // BLI_assert(check_datablock_expanded(id_cow) == false);
   /* Copy data from original ID to a copied version. */
-  /* TODO(sergey): Avoid doing full ID copy somehow, make Mesh to reference
-   * original geometry arrays for until those are modified. */
   /* TODO(sergey): We do some trickery with temp bmain and extra ID pointer
    * just to be able to use existing API. Ideally we need to replace this with
    * in-place copy from existing datablock to a prepared memory.
@@ -885,8 +919,15 @@ ID *deg_expand_copy_on_write_datablock(const Depsgraph *depsgraph,
       break;
     }
     case ID_ME: {
-      /* TODO(sergey): Ideally we want to handle meshes in a special
-       * manner here to avoid initial copy of all the geometry arrays. */
+      /* Avoid copy of all the geometry arrays when they can not change under the copy. This
+       * saves memory of static linked meshes, and makes their copy-on-write update cheap.
+       *
+       * TODO: Local meshes need reference counting of the arrays, since they can be
+       * freed or re-allocated by edit mode and operators while being referenced. */
+      const Mesh *mesh_orig = (const Mesh *)id_orig;
+      if (mesh_can_share_geometry(mesh_orig)) {
+        done = mesh_copy_inplace_no_main_shared(mesh_orig, (Mesh *)id_cow);
+      }
       break;
     }
     default:
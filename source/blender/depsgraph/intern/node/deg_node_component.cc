@@ -169,8 +169,14 @@ OperationNode *ComponentNode::add_operation(const DepsEvalOperationCb &op,
     op_node = (OperationNode *)factory->create_node(this->owner->id_orig, "", name);
 
     /* register opnode in this component's operation set */
-    OperationIDKey key(opcode, name, name_tag);
-    operations_map->add(key, op_node);
+    if (operations_map != nullptr) {
+      OperationIDKey key(opcode, name, name_tag);
+      operations_map->add(key, op_node);
+    }
+    else {
+      /* Component is already finalized, happens when relations are updated incrementally. */
+      operations.push_back(op_node);
+    }
 
     /* set backlink */
     op_node->owner = this;
@@ -280,6 +286,10 @@ OperationNode *ComponentNode::get_exit_operation()
 
 void ComponentNode::finalize_build(Depsgraph * /*graph*/)
 {
+  if (operations_map == nullptr) {
+    /* Already finalized by a previous build. */
+    return;
+  }
   operations.reserve(operations_map->size());
   for (OperationNode *op_node : operations_map->values()) {
     operations.push_back(op_node);
@@ -201,7 +201,11 @@ const char *operationCodeAsString(OperationCode opcode)
   return "UNKNOWN";
 }
 
-OperationNode::OperationNode() : name_tag(-1), flag(0)
+/* Weight of the most recent timing in the running average of the operation evaluation cost. */
+static const float EVALUATION_COST_SMOOTHING_FACTOR = 0.25f;
+
+OperationNode::OperationNode()
+    : name_tag(-1), flag(0), evaluation_cost(0.0f), critical_path_cost(0.0f)
 {
 }
 
@@ -244,6 +248,17 @@ void OperationNode::tag_update(Depsgraph *graph, eUpdateSource source)
   }
 }
 
+void OperationNode::update_evaluation_cost(double evaluation_time)
+{
+  if (evaluation_cost == 0.0f) {
+    evaluation_cost = (float)evaluation_time;
+  }
+  else {
+    evaluation_cost += ((float)evaluation_time - evaluation_cost) *
+                       EVALUATION_COST_SMOOTHING_FACTOR;
+  }
+}
+
 void OperationNode::set_as_entry()
 {
   BLI_assert(owner != nullptr);
@@ -251,6 +251,9 @@ struct OperationNode : public Node {
   void set_as_entry();
   void set_as_exit();
 
+  /* Accumulate time spent on evaluating this operation into the cost model. */
+  void update_evaluation_cost(double evaluation_time);
+
   /* Component that contains the operation. */
   ComponentNode *owner;
 
@@ -268,6 +271,15 @@ struct OperationNode : public Node {
   /* (OperationFlag) extra settings affecting evaluation. */
   int flag;
 
+  /* Expected time in seconds needed to evaluate this operation. Is a running average of the
+   * timing measured during previous evaluations of the graph. */
+  float evaluation_cost;
+
+  /* Expected time in seconds needed to evaluate the longest chain of operations which starts
+   * at this operation (including the operation itself). Operations with the highest value are
+   * on the critical path of the evaluation and are scheduled first. */
+  float critical_path_cost;
+
   DEG_DEPSNODE_DECLARE;
 };
 
@@ -222,11 +222,11 @@ typedef struct MeshBatchCache {
   DRWBatchFlag batch_ready;
 
   /* settings to determine if cache is invalid */
-  int edge_len;
-  int tri_len;
-  int poly_len;
-  int vert_len;
   int mat_len;
+  /* Element counts (verts, edges, polys, loops) of the final and cage meshes the buffers are
+   * extracted from. Used to detect topology changes on #BKE_MESH_BATCH_DIRTY_DEFORM. */
+  int final_elem_len[4];
+  int cage_elem_len[4];
   bool is_dirty; /* Instantly invalidates cache, skipping mesh check */
   bool is_editmode;
   bool is_uvsyncsel;
@@ -1483,11 +1483,9 @@ static void *extract_pos_nor_init(const MeshRenderData *mr, void *buf)
       data->packed_nor[v] = GPU_normal_convert_i10_v3(eve->no);
     }
   }
-  else {
-    const MVert *mvert = mr->mvert;
-    for (int v = 0; v < mr->vert_len; v++, mvert++) {
-      data->packed_nor[v] = GPU_normal_convert_i10_s3(mvert->no);
-    }
+  else if (mr->vert_len > 0) {
+    GPU_normal_convert_i10_s3_array(
+        data->packed_nor, mr->mvert[0].no, sizeof(MVert) / sizeof(short), mr->vert_len);
   }
   return data;
 }
@@ -1701,7 +1699,12 @@ static void *extract_lnor_init(const MeshRenderData *mr, void *buf)
 static void extract_lnor_loop_bmesh(const MeshRenderData *mr, int l, BMLoop *loop, void *data)
 {
   if (mr->loop_normals) {
-    ((GPUPackedNormal *)data)[l] = GPU_normal_convert_i10_v3(mr->loop_normals[l]);
+    /* Custom/split normals of the face loops are contiguous, convert them all at once when
+     * visiting the first loop. */
+    if (loop == loop->f->l_first) {
+      GPU_normal_convert_i10_v3_array(
+          &((GPUPackedNormal *)data)[l], mr->loop_normals[l], 3, loop->f->len);
+    }
   }
   else if (BM_elem_flag_test(loop->f, BM_ELEM_SMOOTH)) {
     ((GPUPackedNormal *)data)[l] = GPU_normal_convert_i10_v3(loop->v->no);
@@ -1718,7 +1721,11 @@ static void extract_lnor_loop_mesh(
 {
   GPUPackedNormal *lnor_data = &((GPUPackedNormal *)data)[l];
   if (mr->loop_normals) {
-    *lnor_data = GPU_normal_convert_i10_v3(mr->loop_normals[l]);
+    /* Custom/split normals of the polygon loops are contiguous, convert them all at once when
+     * visiting the first loop. */
+    if (l == mpoly->loopstart) {
+      GPU_normal_convert_i10_v3_array(lnor_data, mr->loop_normals[l], 3, mpoly->totloop);
+    }
   }
   else if (mpoly->flag & ME_SMOOTH) {
     *lnor_data = GPU_normal_convert_i10_s3(mr->mvert[mloop->v].no);
@@ -2011,19 +2018,12 @@ static void extract_tan_ex(const MeshRenderData *mr, GPUVertBuf *vbo, const bool
   }
   else {
     GPUPackedNormal *tan_data = (GPUPackedNormal *)vbo->data;
-    for (int i = 0; i < tan_len; i++) {
-      const char *name = tangent_names[i];
-      float(*layer_data)[4] = (float(*)[4])CustomData_get_layer_named(cd_ldata, CD_TANGENT, name);
-      for (int l = 0; l < mr->loop_len; l++) {
-        *tan_data = GPU_normal_convert_i10_v3(layer_data[l]);
-        tan_data->w = (layer_data[l][3] > 0.0f) ? 1 : -2;
-        tan_data++;
-      }
-    }
-    if (use_orco_tan) {
-      float(*layer_data)[4] = (float(*)[4])CustomData_get_layer_n(cd_ldata, CD_TANGENT, 0);
+    for (int i = 0; i < tan_len + (use_orco_tan ? 1 : 0); i++) {
+      float(*layer_data)[4] = (float(*)[4])(
+          (i < tan_len) ? CustomData_get_layer_named(cd_ldata, CD_TANGENT, tangent_names[i]) :
+                          CustomData_get_layer_n(cd_ldata, CD_TANGENT, 0));
+      GPU_normal_convert_i10_v3_array(tan_data, layer_data[0], 4, mr->loop_len);
       for (int l = 0; l < mr->loop_len; l++) {
-        *tan_data = GPU_normal_convert_i10_v3(layer_data[l]);
         tan_data->w = (layer_data[l][3] > 0.0f) ? 1 : -2;
         tan_data++;
       }
@@ -390,6 +390,43 @@ static bool mesh_batch_cache_valid(Mesh *me)
   return true;
 }
 
+static void mesh_elem_len_get(const Mesh *me, int r_elem_len[4])
+{
+  if (me == NULL) {
+    r_elem_len[0] = r_elem_len[1] = r_elem_len[2] = r_elem_len[3] = 0;
+    return;
+  }
+  r_elem_len[0] = me->totvert;
+  r_elem_len[1] = me->totedge;
+  r_elem_len[2] = me->totpoly;
+  r_elem_len[3] = me->totloop;
+}
+
+static void mesh_batch_cache_elem_len_get(const Mesh *me,
+                                          int r_final_elem_len[4],
+                                          int r_cage_elem_len[4])
+{
+  if (me->edit_mesh) {
+    mesh_elem_len_get(me->edit_mesh->mesh_eval_final, r_final_elem_len);
+    mesh_elem_len_get(me->edit_mesh->mesh_eval_cage, r_cage_elem_len);
+  }
+  else {
+    mesh_elem_len_get(me, r_final_elem_len);
+    mesh_elem_len_get(me, r_cage_elem_len);
+  }
+}
+
+/* Return true if the meshes drawn by the cache still have the topology the buffers were
+ * extracted from. Only compares element counts, which is enough to catch modifiers whose
+ * output topology depends on the vertex coordinates (boolean, weld, remesh...). */
+static bool mesh_batch_cache_topology_matches(const MeshBatchCache *cache, const Mesh *me)
+{
+  int final_elem_len[4], cage_elem_len[4];
+  mesh_batch_cache_elem_len_get(me, final_elem_len, cage_elem_len);
+  return (memcmp(final_elem_len, cache->final_elem_len, sizeof(final_elem_len)) == 0) &&
+         (memcmp(cage_elem_len, cache->cage_elem_len, sizeof(cage_elem_len)) == 0);
+}
+
 static void mesh_batch_cache_init(Mesh *me)
 {
   MeshBatchCache *cache = me->runtime.batch_cache;
@@ -403,12 +440,7 @@ static void mesh_batch_cache_init(Mesh *me)
 
   cache->is_editmode = me->edit_mesh != NULL;
 
-  if (cache->is_editmode == false) {
-    // cache->edge_len = mesh_render_edges_len_get(me);
-    // cache->tri_len = mesh_render_looptri_len_get(me);
-    // cache->poly_len = mesh_render_polys_len_get(me);
-    // cache->vert_len = mesh_render_verts_len_get(me);
-  }
+  mesh_batch_cache_elem_len_get(me, cache->final_elem_len, cache->cage_elem_len);
 
   cache->mat_len = mesh_render_mat_len_get(me);
   cache->surface_per_mat = MEM_callocN(sizeof(*cache->surface_per_mat) * cache->mat_len, __func__);
@@ -533,6 +565,62 @@ static void mesh_batch_cache_discard_uvedit_select(MeshBatchCache *cache)
   cache->batch_ready &= ~MBC_EDITUV;
 }
 
+/* Discard the buffers depending on vertex coordinates and the batches using them.
+ * Attribute buffers (UVs, colors, weights, edit flags...) and the index buffers not built from
+ * the tessellation are kept, so only the coordinate dependent buffers are extracted again.
+ * Triangle index buffers are discarded too: tessellation depends on the vertex positions, quads
+ * may pick the other diagonal and n-gons may be triangulated differently. */
+static void mesh_batch_cache_discard_deform(MeshBatchCache *cache)
+{
+  FOREACH_MESH_BUFFER_CACHE (cache, mbufcache) {
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.pos_nor);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.lnor);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.edge_fac);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.tan);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.orco);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.stretch_area);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.stretch_angle);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.mesh_analysis);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.fdots_pos);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.fdots_nor);
+    GPU_VERTBUF_DISCARD_SAFE(mbufcache->vbo.skin_roots);
+    GPU_INDEXBUF_DISCARD_SAFE(mbufcache->ibo.tris);
+    GPU_INDEXBUF_DISCARD_SAFE(mbufcache->ibo.edituv_tris);
+    GPU_INDEXBUF_DISCARD_SAFE(mbufcache->ibo.lines_adjacency);
+  }
+  /* Every batch except the UV editor ones uses the positions, UV faces use the triangles. */
+  GPU_BATCH_DISCARD_SAFE(cache->batch.surface);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.surface_weights);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edit_triangles);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edit_vertices);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edit_edges);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edit_vnor);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edit_lnor);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edit_fdots);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edit_mesh_analysis);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edit_skin_roots);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edituv_faces);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edituv_faces_stretch_area);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edituv_faces_stretch_angle);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edit_selection_verts);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edit_selection_edges);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edit_selection_faces);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edit_selection_fdots);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.all_verts);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.all_edges);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.loose_edges);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.edge_detection);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.wire_edges);
+  GPU_BATCH_DISCARD_SAFE(cache->batch.wire_loops);
+  mesh_batch_cache_discard_shaded_batches(cache);
+
+  cache->tot_area = 0.0f;
+  cache->tot_uv_area = 0.0f;
+
+  cache->batch_ready &= (MBC_EDITUV_EDGES | MBC_EDITUV_VERTS | MBC_EDITUV_FACEDOTS |
+                         MBC_WIRE_LOOPS_UVS);
+}
+
 void DRW_mesh_batch_cache_dirty_tag(Mesh *me, int mode)
 {
   MeshBatchCache *cache = me->runtime.batch_cache;
@@ -602,6 +690,16 @@ void DRW_mesh_batch_cache_dirty_tag(Mesh *me, int mode)
       GPU_BATCH_DISCARD_SAFE(cache->batch.edituv_fdots);
       cache->batch_ready &= ~MBC_EDITUV;
       break;
+    case BKE_MESH_BATCH_DIRTY_DEFORM:
+      if (cache->is_dirty) {
+        break;
+      }
+      if (!mesh_batch_cache_topology_matches(cache, me)) {
+        cache->is_dirty = true;
+        break;
+      }
+      mesh_batch_cache_discard_deform(cache);
+      break;
     default:
       BLI_assert(0);
   }
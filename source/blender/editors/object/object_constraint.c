@@ -1990,7 +1990,7 @@ static int constraint_add_exec(
   }
 
   /* force depsgraph to get recalculated since new relationships added */
-  DEG_relations_tag_update(bmain);
+  DEG_id_relations_tag_update(bmain, &ob->id);
 
   if ((ob->type == OB_ARMATURE) && (pchan)) {
     BKE_pose_tag_recalc(bmain, ob->pose); /* sort pose channels */
@@ -46,6 +46,8 @@
 #include "BKE_sound.h"
 #include "BKE_workspace.h"
 
+#include "IMB_moviecache.h"
+
 #include "WM_api.h"
 #include "WM_types.h"
 
@@ -1456,6 +1458,9 @@ void ED_screen_animation_timer(bContext *C, int redraws, int sync, int enable)
     stopscreen->animtimer = NULL;
   }
 
+  /* Let frame caches favor frames ahead of the play-head. */
+  IMB_moviecache_set_playback(enable, enable ? (PEFRA - PSFRA + 1) : 0);
+
   if (enable) {
     ScreenAnimData *sad = MEM_callocN(sizeof(ScreenAnimData), "ScreenAnimData");
 
@@ -2181,16 +2181,11 @@ static float brush_strength(const Sculpt *sd,
   }
 }
 
-/* Return a multiplier for brush strength on a particular vertex. */
-float SCULPT_brush_strength_factor(SculptSession *ss,
-                                   const Brush *br,
-                                   const float brush_point[3],
-                                   const float len,
-                                   const short vno[3],
-                                   const float fno[3],
-                                   const float mask,
-                                   const int vertex_index,
-                                   const int thread_id)
+/* Strength of the brush texture at a point. */
+static float sculpt_brush_texture_strength(SculptSession *ss,
+                                           const Brush *br,
+                                           const float brush_point[3],
+                                           const int thread_id)
 {
   StrokeCache *cache = ss->cache;
   const Scene *scene = cache->vc->scene;
@@ -2253,6 +2248,22 @@ float SCULPT_brush_strength_factor(SculptSession *ss,
     }
   }
 
+  return avg;
+}
+
+float SCULPT_brush_strength_factor(SculptSession *ss,
+                                   const Brush *br,
+                                   const float brush_point[3],
+                                   const float len,
+                                   const short vno[3],
+                                   const float fno[3],
+                                   const float mask,
+                                   const int vertex_index,
+                                   const int thread_id)
+{
+  StrokeCache *cache = ss->cache;
+  float avg = sculpt_brush_texture_strength(ss, br, brush_point, thread_id);
+
   /* Hardness. */
   float final_len = len;
   const float hardness = br->hardness;
@@ -2281,6 +2292,152 @@ float SCULPT_brush_strength_factor(SculptSession *ss,
   return avg;
 }
 
+/* Remove the vertices that are not kept from the block, preserving the order of the others. */
+void SCULPT_vertex_block_compact(SculptVertexBlock *block, const bool *keep)
+{
+  int len = 0;
+  for (int i = 0; i < block->len; i++) {
+    if (!keep[i]) {
+      continue;
+    }
+    if (len != i) {
+      block->co[0][len] = block->co[0][i];
+      block->co[1][len] = block->co[1][i];
+      block->co[2][len] = block->co[2][i];
+      block->no[len] = block->no[i];
+      block->fno[len] = block->fno[i];
+      block->mask[len] = block->mask[i];
+      block->vertex_index[len] = block->vertex_index[i];
+      block->node_index[len] = block->node_index[i];
+      block->mvert[len] = block->mvert[i];
+      block->fade[len] = block->fade[i];
+    }
+    len++;
+  }
+  block->len = len;
+}
+
+/**
+ * Block version of the brush test returned by #SCULPT_brush_test_init_with_falloff_shape.
+ * Vertices outside of the brush are removed from the block, the distance of the others to the
+ * brush is stored in #SculptVertexBlock.fade.
+ */
+void SCULPT_vertex_block_brush_test_sq(SculptVertexBlock *block,
+                                       const SculptBrushTest *test,
+                                       const char falloff_shape)
+{
+  const int len = block->len;
+  const float *co_x = block->co[0];
+  const float *co_y = block->co[1];
+  const float *co_z = block->co[2];
+  float *dist_sq = block->fade;
+  const float *location = test->location;
+
+  if (falloff_shape == PAINT_FALLOFF_SHAPE_SPHERE) {
+    for (int i = 0; i < len; i++) {
+      const float dx = co_x[i] - location[0];
+      const float dy = co_y[i] - location[1];
+      const float dz = co_z[i] - location[2];
+      dist_sq[i] = dx * dx + dy * dy + dz * dz;
+    }
+  }
+  else {
+    /* PAINT_FALLOFF_SHAPE_TUBE: distance of the coordinates projected on the view plane. */
+    const float *plane = test->plane_view;
+    for (int i = 0; i < len; i++) {
+      const float side = co_x[i] * plane[0] + co_y[i] * plane[1] + co_z[i] * plane[2] + plane[3];
+      const float dx = co_x[i] - plane[0] * side - location[0];
+      const float dy = co_y[i] - plane[1] * side - location[1];
+      const float dz = co_z[i] - plane[2] * side - location[2];
+      dist_sq[i] = dx * dx + dy * dy + dz * dz;
+    }
+  }
+
+  bool keep[SCULPT_VERTEX_BLOCK_SIZE];
+  bool keep_all = true;
+  for (int i = 0; i < len; i++) {
+    keep[i] = dist_sq[i] <= test->radius_squared;
+    keep_all &= keep[i];
+  }
+  if (test->clip_rv3d) {
+    for (int i = 0; i < len; i++) {
+      if (keep[i]) {
+        float co[3];
+        SCULPT_vertex_block_co_get(block, i, co);
+        keep[i] = !sculpt_brush_test_clipping(test, co);
+        keep_all &= keep[i];
+      }
+    }
+  }
+  if (!keep_all) {
+    SCULPT_vertex_block_compact(block, keep);
+  }
+
+  float *dist = block->fade;
+  for (int i = 0; i < block->len; i++) {
+    dist[i] = sqrtf(dist[i]);
+  }
+}
+
+/**
+ * Block version of #SCULPT_brush_strength_factor, replaces the distance of each vertex
+ * to the brush in #SculptVertexBlock.fade by the strength of the brush.
+ */
+void SCULPT_vertex_block_strength_factor(SculptSession *ss,
+                                         const Brush *br,
+                                         SculptVertexBlock *block,
+                                         const int thread_id)
+{
+  StrokeCache *cache = ss->cache;
+  const int len = block->len;
+  float *fade = block->fade;
+  const float radius = cache->radius;
+
+  /* Hardness. */
+  const float hardness = br->hardness;
+  if (hardness == 1.0f) {
+    for (int i = 0; i < len; i++) {
+      fade[i] = (fade[i] / radius < hardness) ? 0.0f : radius;
+    }
+  }
+  else {
+    for (int i = 0; i < len; i++) {
+      const float p = fade[i] / radius;
+      fade[i] = (p < hardness) ? 0.0f : ((p - hardness) / (1.0f - hardness)) * radius;
+    }
+  }
+
+  /* Falloff curve. */
+  BKE_brush_curve_strength_array(br, fade, len, radius);
+
+  if (br->mtex.tex) {
+    for (int i = 0; i < len; i++) {
+      float co[3];
+      SCULPT_vertex_block_co_get(block, i, co);
+      fade[i] *= sculpt_brush_texture_strength(ss, br, co, thread_id);
+    }
+  }
+
+  if (br->flag & BRUSH_FRONTFACE) {
+    for (int i = 0; i < len; i++) {
+      fade[i] *= frontface(br, cache->view_normal, block->no[i], block->fno[i]);
+    }
+  }
+
+  /* Paint mask. */
+  for (int i = 0; i < len; i++) {
+    fade[i] *= 1.0f - block->mask[i];
+  }
+
+  /* Automasking. */
+  if (cache->automask) {
+    const float *automask = cache->automask;
+    for (int i = 0; i < len; i++) {
+      fade[i] *= automask[block->vertex_index[i]];
+    }
+  }
+}
+
 /* Test AABB against sphere. */
 bool SCULPT_search_sphere_cb(PBVHNode *node, void *data_v)
 {
@@ -2747,6 +2904,28 @@ static void do_mask_brush(Sculpt *sd, Object *ob, PBVHNode **nodes, int totnode)
   }
 }
 
+static void do_draw_brush_block(SculptSession *ss,
+                                const Brush *brush,
+                                const SculptBrushTest *test,
+                                const float offset[3],
+                                float (*proxy)[3],
+                                SculptVertexBlock *block,
+                                const int thread_id)
+{
+  SCULPT_vertex_block_brush_test_sq(block, test, brush->falloff_shape);
+  SCULPT_vertex_block_strength_factor(ss, brush, block, thread_id);
+
+  for (int i = 0; i < block->len; i++) {
+    /* Offset vertex. */
+    mul_v3_v3fl(proxy[block->node_index[i]], offset, block->fade[i]);
+
+    if (block->mvert[i]) {
+      block->mvert[i]->flag |= ME_VERT_PBVH_UPDATE;
+    }
+  }
+  block->len = 0;
+}
+
 static void do_draw_brush_task_cb_ex(void *__restrict userdata,
                                      const int n,
                                      const TaskParallelTLS *__restrict tls)
@@ -2762,32 +2941,22 @@ static void do_draw_brush_task_cb_ex(void *__restrict userdata,
   proxy = BKE_pbvh_node_add_proxy(ss->pbvh, data->nodes[n])->co;
 
   SculptBrushTest test;
-  SculptBrushTestFn sculpt_brush_test_sq_fn = SCULPT_brush_test_init_with_falloff_shape(
-      ss, &test, data->brush->falloff_shape);
+  SCULPT_brush_test_init_with_falloff_shape(ss, &test, data->brush->falloff_shape);
   const int thread_id = BLI_task_parallel_thread_id(tls);
 
+  SculptVertexBlock block;
+  block.len = 0;
+
   BKE_pbvh_vertex_iter_begin(ss->pbvh, data->nodes[n], vd, PBVH_ITER_UNIQUE)
   {
-    if (sculpt_brush_test_sq_fn(&test, vd.co)) {
-      /* Offset vertex. */
-      const float fade = SCULPT_brush_strength_factor(ss,
-                                                      brush,
-                                                      vd.co,
-                                                      sqrtf(test.dist),
-                                                      vd.no,
-                                                      vd.fno,
-                                                      vd.mask ? *vd.mask : 0.0f,
-                                                      vd.index,
-                                                      thread_id);
-
-      mul_v3_v3fl(proxy[vd.i], offset, fade);
-
-      if (vd.mvert) {
-        vd.mvert->flag |= ME_VERT_PBVH_UPDATE;
-      }
+    SCULPT_vertex_block_add(&block, &vd);
+    if (block.len == SCULPT_VERTEX_BLOCK_SIZE) {
+      do_draw_brush_block(ss, brush, &test, offset, proxy, &block, thread_id);
     }
   }
   BKE_pbvh_vertex_iter_end;
+
+  do_draw_brush_block(ss, brush, &test, offset, proxy, &block, thread_id);
 }
 
 static void do_draw_brush(Sculpt *sd, Object *ob, PBVHNode **nodes, int totnode)
@@ -4182,6 +4351,39 @@ static void do_layer_brush(Sculpt *sd, Object *ob, PBVHNode **nodes, int totnode
   BLI_task_parallel_range(0, totnode, &data, do_layer_brush_task_cb_ex, &settings);
 }
 
+static void do_inflate_brush_block(SculptSession *ss,
+                                   const Brush *brush,
+                                   const SculptBrushTest *test,
+                                   float (*proxy)[3],
+                                   SculptVertexBlock *block,
+                                   const int thread_id)
+{
+  const float bstrength = ss->cache->bstrength;
+
+  SCULPT_vertex_block_brush_test_sq(block, test, brush->falloff_shape);
+  SCULPT_vertex_block_strength_factor(ss, brush, block, thread_id);
+
+  for (int i = 0; i < block->len; i++) {
+    const float fade = bstrength * block->fade[i];
+    float val[3];
+
+    if (block->fno[i]) {
+      copy_v3_v3(val, block->fno[i]);
+    }
+    else {
+      normal_short_to_float_v3(val, block->no[i]);
+    }
+
+    mul_v3_fl(val, fade * ss->cache->radius);
+    mul_v3_v3v3(proxy[block->node_index[i]], val, ss->cache->scale);
+
+    if (block->mvert[i]) {
+      block->mvert[i]->flag |= ME_VERT_PBVH_UPDATE;
+    }
+  }
+  block->len = 0;
+}
+
 static void do_inflate_brush_task_cb_ex(void *__restrict userdata,
                                         const int n,
                                         const TaskParallelTLS *__restrict tls)
@@ -4192,45 +4394,26 @@ static void do_inflate_brush_task_cb_ex(void *__restrict userdata,
 
   PBVHVertexIter vd;
   float(*proxy)[3];
-  const float bstrength = ss->cache->bstrength;
 
   proxy = BKE_pbvh_node_add_proxy(ss->pbvh, data->nodes[n])->co;
 
   SculptBrushTest test;
-  SculptBrushTestFn sculpt_brush_test_sq_fn = SCULPT_brush_test_init_with_falloff_shape(
-      ss, &test, data->brush->falloff_shape);
+  SCULPT_brush_test_init_with_falloff_shape(ss, &test, data->brush->falloff_shape);
   const int thread_id = BLI_task_parallel_thread_id(tls);
 
+  SculptVertexBlock block;
+  block.len = 0;
+
   BKE_pbvh_vertex_iter_begin(ss->pbvh, data->nodes[n], vd, PBVH_ITER_UNIQUE)
   {
-    if (sculpt_brush_test_sq_fn(&test, vd.co)) {
-      const float fade = bstrength * SCULPT_brush_strength_factor(ss,
-                                                                  brush,
-                                                                  vd.co,
-                                                                  sqrtf(test.dist),
-                                                                  vd.no,
-                                                                  vd.fno,
-                                                                  vd.mask ? *vd.mask : 0.0f,
-                                                                  vd.index,
-                                                                  thread_id);
-      float val[3];
-
-      if (vd.fno) {
-        copy_v3_v3(val, vd.fno);
-      }
-      else {
-        normal_short_to_float_v3(val, vd.no);
-      }
-
-      mul_v3_fl(val, fade * ss->cache->radius);
-      mul_v3_v3v3(proxy[vd.i], val, ss->cache->scale);
-
-      if (vd.mvert) {
-        vd.mvert->flag |= ME_VERT_PBVH_UPDATE;
-      }
+    SCULPT_vertex_block_add(&block, &vd);
+    if (block.len == SCULPT_VERTEX_BLOCK_SIZE) {
+      do_inflate_brush_block(ss, brush, &test, proxy, &block, thread_id);
     }
   }
   BKE_pbvh_vertex_iter_end;
+
+  do_inflate_brush_block(ss, brush, &test, proxy, &block, thread_id);
 }
 
 static void do_inflate_brush(Sculpt *sd, Object *ob, PBVHNode **nodes, int totnode)
@@ -4556,6 +4739,62 @@ static void do_clay_brush(Sculpt *sd, Object *ob, PBVHNode **nodes, int totnode)
   BLI_task_parallel_range(0, totnode, &data, do_clay_brush_task_cb_ex, &settings);
 }
 
+static void do_clay_strips_brush_block(SculptSession *ss,
+                                       const Brush *brush,
+                                       SculptBrushTest *test,
+                                       float mat[4][4],
+                                       const bool flip,
+                                       const float bstrength,
+                                       float (*proxy)[3],
+                                       SculptVertexBlock *block,
+                                       const int thread_id)
+{
+  bool keep[SCULPT_VERTEX_BLOCK_SIZE];
+
+  for (int i = 0; i < block->len; i++) {
+    float co[3];
+    SCULPT_vertex_block_co_get(block, i, co);
+    keep[i] = false;
+
+    if (SCULPT_brush_test_cube(test, co, mat, brush->tip_roundness)) {
+      if (plane_point_side_flip(co, test->plane_tool, flip)) {
+        float intr[3];
+        float val[3];
+
+        closest_to_plane_normalized_v3(intr, test->plane_tool, co);
+
+        sub_v3_v3v3(val, intr, co);
+
+        if (SCULPT_plane_trim(ss->cache, brush, val)) {
+          block->fade[i] = ss->cache->radius * test->dist;
+          keep[i] = true;
+        }
+      }
+    }
+  }
+  SCULPT_vertex_block_compact(block, keep);
+
+  /* The normal from the vertices is ignored, it causes glitch with planes, see: T44390. */
+  SCULPT_vertex_block_strength_factor(ss, brush, block, thread_id);
+
+  for (int i = 0; i < block->len; i++) {
+    float co[3];
+    float intr[3];
+    float val[3];
+    SCULPT_vertex_block_co_get(block, i, co);
+    closest_to_plane_normalized_v3(intr, test->plane_tool, co);
+    sub_v3_v3v3(val, intr, co);
+
+    const float fade = bstrength * block->fade[i];
+    mul_v3_v3fl(proxy[block->node_index[i]], val, fade);
+
+    if (block->mvert[i]) {
+      block->mvert[i]->flag |= ME_VERT_PBVH_UPDATE;
+    }
+  }
+  block->len = 0;
+}
+
 static void do_clay_strips_brush_task_cb_ex(void *__restrict userdata,
                                             const int n,
                                             const TaskParallelTLS *__restrict tls)
@@ -4579,40 +4818,20 @@ static void do_clay_strips_brush_task_cb_ex(void *__restrict userdata,
   plane_from_point_normal_v3(test.plane_tool, area_co, area_no_sp);
   const int thread_id = BLI_task_parallel_thread_id(tls);
 
+  SculptVertexBlock block;
+  block.len = 0;
+
   BKE_pbvh_vertex_iter_begin(ss->pbvh, data->nodes[n], vd, PBVH_ITER_UNIQUE)
   {
-    if (SCULPT_brush_test_cube(&test, vd.co, mat, brush->tip_roundness)) {
-      if (plane_point_side_flip(vd.co, test.plane_tool, flip)) {
-        float intr[3];
-        float val[3];
-
-        closest_to_plane_normalized_v3(intr, test.plane_tool, vd.co);
-
-        sub_v3_v3v3(val, intr, vd.co);
-
-        if (SCULPT_plane_trim(ss->cache, brush, val)) {
-          /* The normal from the vertices is ignored, it causes glitch with planes, see: T44390. */
-          const float fade = bstrength *
-                             SCULPT_brush_strength_factor(ss,
-                                                          brush,
-                                                          vd.co,
-                                                          ss->cache->radius * test.dist,
-                                                          vd.no,
-                                                          vd.fno,
-                                                          vd.mask ? *vd.mask : 0.0f,
-                                                          vd.index,
-                                                          thread_id);
-
-          mul_v3_v3fl(proxy[vd.i], val, fade);
-
-          if (vd.mvert) {
-            vd.mvert->flag |= ME_VERT_PBVH_UPDATE;
-          }
-        }
-      }
+    SCULPT_vertex_block_add(&block, &vd);
+    if (block.len == SCULPT_VERTEX_BLOCK_SIZE) {
+      do_clay_strips_brush_block(
+          ss, brush, &test, mat, flip, bstrength, proxy, &block, thread_id);
     }
   }
   BKE_pbvh_vertex_iter_end;
+
+  do_clay_strips_brush_block(ss, brush, &test, mat, flip, bstrength, proxy, &block, thread_id);
 }
 
 static void do_clay_strips_brush(Sculpt *sd, Object *ob, PBVHNode **nodes, int totnode)
@@ -7585,6 +7804,14 @@ void ED_object_sculptmode_enter_ex(Main *bmain,
    * freed memory. */
   BKE_object_free_derived_caches(ob);
 
+  /* Reorder the vertices by PBVH node, before the sculpt session builds its data from them. */
+  Sculpt *sd = scene->toolsettings->sculpt;
+  if (sd && (sd->flags & SCULPT_OPTIMIZE_VERTEX_ORDER) && (mmd == NULL)) {
+    if (BKE_sculpt_vertex_order_optimize(bmain, ob)) {
+      BKE_scene_graph_update_tagged(depsgraph, bmain);
+    }
+  }
+
   sculpt_init_session(depsgraph, scene, ob);
 
   /* Mask layer is required. */
@@ -7708,6 +7935,9 @@ void ED_object_sculptmode_exit_ex(Main *bmain, Depsgraph *depsgraph, Scene *scen
 
   BKE_sculptsession_free(ob);
 
+  /* Sculpt mode may have reordered the vertices, other modes expect the original order. */
+  BKE_sculpt_vertex_order_restore(me);
+
   paint_cursor_delete_textures();
 
   /* Never leave derived meshes behind. */
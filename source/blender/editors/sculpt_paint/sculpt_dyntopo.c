@@ -141,6 +141,15 @@ void SCULPT_dyntopo_node_layers_add(SculptSession *ss)
   ss->bm->pdata.layers[cd_node_layer_index].flag |= CD_FLAG_TEMPORARY;
 }
 
+static void sculpt_dynamic_topology_vertex_order_layer_free(BMesh *bm, const char *name)
+{
+  const int layer_index = CustomData_get_named_layer_index(&bm->vdata, CD_PROP_INT, name);
+  if (layer_index != -1) {
+    const int n = layer_index - CustomData_get_layer_index(&bm->vdata, CD_PROP_INT);
+    BM_data_layer_free_n(bm, &bm->vdata, CD_PROP_INT, n);
+  }
+}
+
 void SCULPT_dynamic_topology_enable_ex(Main *bmain, Depsgraph *depsgraph, Scene *scene, Object *ob)
 {
   SculptSession *ss = ob->sculpt;
@@ -168,6 +177,10 @@ void SCULPT_dynamic_topology_enable_ex(Main *bmain, Depsgraph *depsgraph, Scene
                          .use_shapekey = true,
                          .active_shapekey = ob->shapenr,
                      }));
+  /* Vertex indices are not preserved by dynamic topology, the mesh (and its undo copy) keeps
+   * the layers so the original order can still be restored when dynamic topology is undone. */
+  sculpt_dynamic_topology_vertex_order_layer_free(ss->bm, SCULPT_ORIG_VERT_INDEX_LAYER_NAME);
+  sculpt_dynamic_topology_vertex_order_layer_free(ss->bm, SCULPT_VERT_ORDER_LAYER_NAME);
   SCULPT_dynamic_topology_triangulate(ss->bm);
   BM_data_layer_add(ss->bm, &ss->bm->vdata, CD_PAINT_MASK);
   SCULPT_dyntopo_node_layers_add(ss);
@@ -371,7 +384,17 @@ enum eDynTopoWarnFlag SCULPT_dynamic_topology_check(Scene *scene, Object *ob)
   for (int i = 0; i < CD_NUMTYPES; i++) {
     if (!ELEM(i, CD_MVERT, CD_MEDGE, CD_MFACE, CD_MLOOP, CD_MPOLY, CD_PAINT_MASK, CD_ORIGINDEX)) {
       if (CustomData_has_layer(&me->vdata, i)) {
-        flag |= DYNTOPO_WARN_VDATA;
+        /* The layers of sculpt vertex reordering are no user data. */
+        int num_user_layers = CustomData_number_of_layers(&me->vdata, i);
+        if (i == CD_PROP_INT) {
+          num_user_layers -= (CustomData_get_named_layer_index(
+                                  &me->vdata, i, SCULPT_ORIG_VERT_INDEX_LAYER_NAME) != -1);
+          num_user_layers -= (CustomData_get_named_layer_index(
+                                  &me->vdata, i, SCULPT_VERT_ORDER_LAYER_NAME) != -1);
+        }
+        if (num_user_layers > 0) {
+          flag |= DYNTOPO_WARN_VDATA;
+        }
       }
       if (CustomData_has_layer(&me->edata, i)) {
         flag |= DYNTOPO_WARN_EDATA;
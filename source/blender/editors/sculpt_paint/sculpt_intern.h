@@ -439,6 +439,16 @@ typedef struct SculptUndoNodeGeometry {
   int totpoly;
 } SculptUndoNodeGeometry;
 
+/* De-duplicated storage of the undo node arrays, used once the undo step is finished.
+ * While an array is in the store its pointer in #SculptUndoNode is NULL. */
+typedef struct SculptUndoNodeArrayStore {
+  struct BArrayState *co;
+  struct BArrayState *orig_co;
+  struct BArrayState *mask;
+  struct BArrayState *index;
+  struct BArrayState *face_sets;
+} SculptUndoNodeArrayStore;
+
 typedef struct SculptUndoNode {
   struct SculptUndoNode *next, *prev;
 
@@ -492,6 +502,8 @@ typedef struct SculptUndoNode {
   /* Sculpt Face Sets */
   int *face_sets;
 
+  SculptUndoNodeArrayStore store;
+
   size_t undo_size;
 } SculptUndoNode;
 
@@ -662,6 +674,57 @@ float SCULPT_brush_strength_factor(struct SculptSession *ss,
                                    const int vertex_index,
                                    const int thread_id);
 
+/* Batched brush evaluation.
+ * Brushes gather the vertices of a node in blocks and test and weight a whole block at once,
+ * with loops over flat arrays instead of calling the test and strength functions per vertex. */
+
+#define SCULPT_VERTEX_BLOCK_SIZE 64
+
+typedef struct SculptVertexBlock {
+  int len;
+  /* Coordinates, one array per axis. */
+  float co[3][SCULPT_VERTEX_BLOCK_SIZE];
+  const short *no[SCULPT_VERTEX_BLOCK_SIZE];
+  const float *fno[SCULPT_VERTEX_BLOCK_SIZE];
+  float mask[SCULPT_VERTEX_BLOCK_SIZE];
+  int vertex_index[SCULPT_VERTEX_BLOCK_SIZE];
+  /* Index of the vertex in the node (#PBVHVertexIter.i), for proxies. */
+  int node_index[SCULPT_VERTEX_BLOCK_SIZE];
+  struct MVert *mvert[SCULPT_VERTEX_BLOCK_SIZE];
+  /* Distance to the brush after the brush test, strength after the strength factor. */
+  float fade[SCULPT_VERTEX_BLOCK_SIZE];
+} SculptVertexBlock;
+
+BLI_INLINE void SCULPT_vertex_block_add(SculptVertexBlock *block, const PBVHVertexIter *vd)
+{
+  const int i = block->len++;
+  block->co[0][i] = vd->co[0];
+  block->co[1][i] = vd->co[1];
+  block->co[2][i] = vd->co[2];
+  block->no[i] = vd->no;
+  block->fno[i] = vd->fno;
+  block->mask[i] = vd->mask ? *vd->mask : 0.0f;
+  block->vertex_index[i] = vd->index;
+  block->node_index[i] = vd->i;
+  block->mvert[i] = vd->mvert;
+}
+
+BLI_INLINE void SCULPT_vertex_block_co_get(const SculptVertexBlock *block, int i, float r_co[3])
+{
+  r_co[0] = block->co[0][i];
+  r_co[1] = block->co[1][i];
+  r_co[2] = block->co[2][i];
+}
+
+void SCULPT_vertex_block_compact(SculptVertexBlock *block, const bool *keep);
+void SCULPT_vertex_block_brush_test_sq(SculptVertexBlock *block,
+                                       const SculptBrushTest *test,
+                                       const char falloff_shape);
+void SCULPT_vertex_block_strength_factor(struct SculptSession *ss,
+                                         const struct Brush *br,
+                                         SculptVertexBlock *block,
+                                         const int thread_id);
+
 /* just for vertex paint. */
 bool SCULPT_pbvh_calc_area_normal(const struct Brush *brush,
                                   Object *ob,
@@ -70,6 +70,17 @@
 #include "bmesh.h"
 #include "sculpt_intern.h"
 
+#define USE_ARRAY_STORE
+
+#ifdef USE_ARRAY_STORE
+#  include "BLI_array_store.h"
+#  include "BLI_array_store_utils.h"
+/* Elements per chunk, PBVH leaf nodes are limited to a few hundred vertices. */
+#  define ARRAY_CHUNK_SIZE 128
+
+#  define USE_ARRAY_STORE_THREAD
+#endif
+
 /* Implementation of undo system for objects in sculpt mode.
  *
  * Each undo step in sculpt mode consists of list of nodes, each node contains:
@@ -113,6 +124,11 @@ typedef struct UndoSculpt {
   ListBase nodes;
 
   size_t undo_size;
+
+#ifdef USE_ARRAY_STORE
+  /* Node arrays have been moved into the array store. */
+  bool use_array_store;
+#endif
 } UndoSculpt;
 
 static UndoSculpt *sculpt_undo_get_nodes(void);
@@ -981,7 +997,7 @@ static SculptUndoNode *sculpt_undo_alloc_node(Object *ob, PBVHNode *node, Sculpt
       unode->co = MEM_callocN(sizeof(float[3]) * allvert, "SculptUndoNode.co");
       unode->no = MEM_callocN(sizeof(short[3]) * allvert, "SculptUndoNode.no");
 
-      usculpt->undo_size = (sizeof(float[3]) + sizeof(short[3]) + sizeof(int)) * allvert;
+      usculpt->undo_size += (sizeof(float[3]) + sizeof(short[3]) + sizeof(int)) * allvert;
       break;
     case SCULPT_UNDO_HIDDEN:
       if (maxgrid) {
@@ -995,7 +1011,7 @@ static SculptUndoNode *sculpt_undo_alloc_node(Object *ob, PBVHNode *node, Sculpt
     case SCULPT_UNDO_MASK:
       unode->mask = MEM_callocN(sizeof(float) * allvert, "SculptUndoNode.mask");
 
-      usculpt->undo_size += (sizeof(float) * sizeof(int)) * allvert;
+      usculpt->undo_size += (sizeof(float) + sizeof(int)) * allvert;
 
       break;
     case SCULPT_UNDO_DYNTOPO_BEGIN:
@@ -1126,6 +1142,8 @@ static SculptUndoNode *sculpt_undo_face_sets_push(Object *ob, SculptUndoType typ
     unode->face_sets[i] = face_sets[i];
   }
 
+  usculpt->undo_size += sizeof(int) * me->totpoly;
+
   BLI_addtail(&usculpt->nodes, unode);
 
   return unode;
@@ -1338,6 +1356,284 @@ void SCULPT_undo_push_end_ex(const bool use_nested_undo)
   }
 }
 
+#ifdef USE_ARRAY_STORE
+
+/* -------------------------------------------------------------------- */
+/** \name Array Store
+ *
+ * Once an undo step is finished its arrays are moved into a #BArrayStore shared by all sculpt
+ * undo steps. Every array references the array of the same PBVH node in the previous step,
+ * so only the chunks changed by a stroke take additional memory.
+ *
+ * Compacting runs in a background task while sculpting continues,
+ * everything accessing stored steps waits for it to finish first.
+ * \{ */
+
+static struct {
+  struct BArrayStore_AtSize bs_stride;
+  int users;
+
+#  ifdef USE_ARRAY_STORE_THREAD
+  TaskPool *task_pool;
+#  endif
+
+  /* Step which is being compacted, its memory usage is only known once compacting is done. */
+  UndoStep *us_pending;
+  UndoSculpt *usculpt_pending;
+} sculpt_arraystore = {{NULL}};
+
+static BArrayState *sculpt_arraystore_state_add(void **data_p,
+                                                const int stride,
+                                                const BArrayState *state_reference)
+{
+  if (*data_p == NULL) {
+    return NULL;
+  }
+
+  BArrayStore *bs = BLI_array_store_at_size_ensure(
+      &sculpt_arraystore.bs_stride, stride, ARRAY_CHUNK_SIZE);
+  BArrayState *state = BLI_array_store_state_add(
+      bs, *data_p, MEM_allocN_len(*data_p), state_reference);
+
+  MEM_freeN(*data_p);
+  *data_p = NULL;
+
+  return state;
+}
+
+static void *sculpt_arraystore_state_expand(BArrayState *state)
+{
+  if (state == NULL) {
+    return NULL;
+  }
+
+  size_t state_len;
+  return BLI_array_store_state_data_get_alloc(state, &state_len);
+}
+
+static void sculpt_arraystore_state_remove(BArrayState **state_p, const int stride)
+{
+  if (*state_p == NULL) {
+    return;
+  }
+
+  BArrayStore *bs = BLI_array_store_at_size_get(&sculpt_arraystore.bs_stride, stride);
+  BLI_array_store_state_remove(bs, *state_p);
+  *state_p = NULL;
+}
+
+static void sculpt_arraystore_node_store_free(SculptUndoNodeArrayStore *store)
+{
+  sculpt_arraystore_state_remove(&store->co, sizeof(float[3]));
+  sculpt_arraystore_state_remove(&store->orig_co, sizeof(float[3]));
+  sculpt_arraystore_state_remove(&store->mask, sizeof(float));
+  sculpt_arraystore_state_remove(&store->index, sizeof(int));
+  sculpt_arraystore_state_remove(&store->face_sets, sizeof(int));
+}
+
+/**
+ * Move the arrays of the node into the store, replacing states it might already have.
+ */
+static void sculpt_arraystore_node_compact(SculptUndoNode *unode,
+                                           const SculptUndoNodeArrayStore *store_ref)
+{
+  SculptUndoNodeArrayStore store_prev = unode->store;
+  if (store_ref == &unode->store) {
+    store_ref = &store_prev;
+  }
+
+  unode->store.co = sculpt_arraystore_state_add(
+      (void **)&unode->co, sizeof(float[3]), store_ref ? store_ref->co : NULL);
+  unode->store.orig_co = sculpt_arraystore_state_add(
+      (void **)&unode->orig_co, sizeof(float[3]), store_ref ? store_ref->orig_co : NULL);
+  unode->store.mask = sculpt_arraystore_state_add(
+      (void **)&unode->mask, sizeof(float), store_ref ? store_ref->mask : NULL);
+  unode->store.index = sculpt_arraystore_state_add(
+      (void **)&unode->index, sizeof(int), store_ref ? store_ref->index : NULL);
+  unode->store.face_sets = sculpt_arraystore_state_add(
+      (void **)&unode->face_sets, sizeof(int), store_ref ? store_ref->face_sets : NULL);
+
+  sculpt_arraystore_node_store_free(&store_prev);
+}
+
+/**
+ * Find the node of the previous step holding the same data, used as a reference for
+ * de-duplication. Any node would give correct results, a good match only saves memory.
+ */
+static const SculptUndoNode *sculpt_arraystore_node_ref_find(
+    GHash *nodes_ref, const SculptUndoNode **nodes_ref_by_type, const SculptUndoNode *unode)
+{
+  const SculptUndoNode *unode_ref = unode->node ? BLI_ghash_lookup(nodes_ref, unode->node) :
+                                                  nodes_ref_by_type[unode->type];
+  return (unode_ref && unode_ref->type == unode->type) ? unode_ref : NULL;
+}
+
+static void sculpt_arraystore_compact(UndoSculpt *usculpt, const UndoSculpt *usculpt_ref)
+{
+  size_t size_expanded, size_compacted_prev, size_compacted;
+  BLI_array_store_at_size_calc_memory_usage(
+      &sculpt_arraystore.bs_stride, &size_expanded, &size_compacted_prev);
+
+  if (usculpt->use_array_store) {
+    /* The step was expanded to be applied, its own previous states are the best reference. */
+    LISTBASE_FOREACH (SculptUndoNode *, unode, &usculpt->nodes) {
+      sculpt_arraystore_node_compact(unode, &unode->store);
+    }
+  }
+  else {
+    GHash *nodes_ref = BLI_ghash_ptr_new(__func__);
+    const SculptUndoNode *nodes_ref_by_type[SCULPT_UNDO_FACE_SETS + 1] = {NULL};
+
+    if (usculpt_ref && usculpt_ref->use_array_store) {
+      LISTBASE_FOREACH (const SculptUndoNode *, unode_ref, &usculpt_ref->nodes) {
+        if (unode_ref->node) {
+          BLI_ghash_insert(nodes_ref, unode_ref->node, (void *)unode_ref);
+        }
+        else if (nodes_ref_by_type[unode_ref->type] == NULL) {
+          nodes_ref_by_type[unode_ref->type] = unode_ref;
+        }
+      }
+    }
+
+    LISTBASE_FOREACH (SculptUndoNode *, unode, &usculpt->nodes) {
+      const SculptUndoNode *unode_ref = sculpt_arraystore_node_ref_find(
+          nodes_ref, nodes_ref_by_type, unode);
+      sculpt_arraystore_node_compact(unode, unode_ref ? &unode_ref->store : NULL);
+    }
+
+    BLI_ghash_free(nodes_ref, NULL, NULL);
+
+    usculpt->use_array_store = true;
+    usculpt->undo_size = 0;
+    sculpt_arraystore.users += 1;
+  }
+
+  /* Memory of the step is what the store grew by when adding it. This is an estimate since
+   * chunks are shared between steps, but it is what keeps the undo memory limit meaningful. */
+  BLI_array_store_at_size_calc_memory_usage(
+      &sculpt_arraystore.bs_stride, &size_expanded, &size_compacted);
+  if (size_compacted >= size_compacted_prev) {
+    usculpt->undo_size += size_compacted - size_compacted_prev;
+  }
+  else {
+    usculpt->undo_size -= MIN2(usculpt->undo_size, size_compacted_prev - size_compacted);
+  }
+}
+
+#  ifdef USE_ARRAY_STORE_THREAD
+
+typedef struct SculptArrayStoreTaskData {
+  UndoSculpt *usculpt;
+  const UndoSculpt *usculpt_ref; /* Can be NULL. */
+} SculptArrayStoreTaskData;
+
+static void sculpt_arraystore_compact_cb(TaskPool *__restrict UNUSED(pool), void *taskdata)
+{
+  SculptArrayStoreTaskData *task_data = taskdata;
+  sculpt_arraystore_compact(task_data->usculpt, task_data->usculpt_ref);
+}
+
+#  endif /* USE_ARRAY_STORE_THREAD */
+
+/**
+ * Wait for compacting to finish, must be called before accessing any stored step.
+ */
+static void sculpt_arraystore_wait(void)
+{
+#  ifdef USE_ARRAY_STORE_THREAD
+  if (sculpt_arraystore.task_pool) {
+    BLI_task_pool_work_and_wait(sculpt_arraystore.task_pool);
+  }
+#  endif
+
+  if (sculpt_arraystore.us_pending) {
+    sculpt_arraystore.us_pending->data_size = sculpt_arraystore.usculpt_pending->undo_size;
+    sculpt_arraystore.us_pending = NULL;
+    sculpt_arraystore.usculpt_pending = NULL;
+  }
+}
+
+/**
+ * Start compacting the finished step \a us, \a usculpt_ref is the previous step (can be NULL).
+ */
+static void sculpt_arraystore_compact_begin(UndoStep *us,
+                                            UndoSculpt *usculpt,
+                                            const UndoSculpt *usculpt_ref)
+{
+  sculpt_arraystore_wait();
+
+  sculpt_arraystore.us_pending = us;
+  sculpt_arraystore.usculpt_pending = usculpt;
+
+#  ifdef USE_ARRAY_STORE_THREAD
+  if (sculpt_arraystore.task_pool == NULL) {
+    sculpt_arraystore.task_pool = BLI_task_pool_create_background(NULL, TASK_PRIORITY_LOW);
+  }
+
+  SculptArrayStoreTaskData *task_data = MEM_mallocN(sizeof(*task_data), __func__);
+  task_data->usculpt = usculpt;
+  task_data->usculpt_ref = usculpt_ref;
+
+  BLI_task_pool_push(
+      sculpt_arraystore.task_pool, sculpt_arraystore_compact_cb, task_data, true, NULL);
+#  else
+  sculpt_arraystore_compact(usculpt, usculpt_ref);
+  sculpt_arraystore_wait();
+#  endif
+}
+
+/**
+ * Allocate the arrays of the step again, keeping the states so the step can be compacted
+ * against them once it has been applied.
+ */
+static void sculpt_arraystore_expand(UndoSculpt *usculpt)
+{
+  sculpt_arraystore_wait();
+
+  if (!usculpt->use_array_store) {
+    return;
+  }
+
+  LISTBASE_FOREACH (SculptUndoNode *, unode, &usculpt->nodes) {
+    BLI_assert(unode->co == NULL && unode->mask == NULL && unode->face_sets == NULL);
+    unode->co = sculpt_arraystore_state_expand(unode->store.co);
+    unode->orig_co = sculpt_arraystore_state_expand(unode->store.orig_co);
+    unode->mask = sculpt_arraystore_state_expand(unode->store.mask);
+    unode->index = sculpt_arraystore_state_expand(unode->store.index);
+    unode->face_sets = sculpt_arraystore_state_expand(unode->store.face_sets);
+  }
+}
+
+static void sculpt_arraystore_free(UndoSculpt *usculpt)
+{
+  sculpt_arraystore_wait();
+
+  if (!usculpt->use_array_store) {
+    return;
+  }
+
+  LISTBASE_FOREACH (SculptUndoNode *, unode, &usculpt->nodes) {
+    sculpt_arraystore_node_store_free(&unode->store);
+  }
+  usculpt->use_array_store = false;
+
+  sculpt_arraystore.users -= 1;
+  BLI_assert(sculpt_arraystore.users >= 0);
+
+  if (sculpt_arraystore.users == 0) {
+    BLI_array_store_at_size_clear(&sculpt_arraystore.bs_stride);
+
+#  ifdef USE_ARRAY_STORE_THREAD
+    BLI_task_pool_free(sculpt_arraystore.task_pool);
+    sculpt_arraystore.task_pool = NULL;
+#  endif
+  }
+}
+
+/** \} */
+
+#endif /* USE_ARRAY_STORE */
+
 /* -------------------------------------------------------------------- */
 /** \name Implements ED Undo System
  * \{ */
@@ -1374,15 +1670,43 @@ static bool sculpt_undosys_step_encode(struct bContext *UNUSED(C),
     bmain->is_memfile_undo_flush_needed = true;
   }
 
+#ifdef USE_ARRAY_STORE
+  {
+    const SculptUndoStep *us_ref = (us->step.prev &&
+                                    us->step.prev->type == BKE_UNDOSYS_TYPE_SCULPT) ?
+                                       (SculptUndoStep *)us->step.prev :
+                                       NULL;
+    sculpt_arraystore_compact_begin(&us->step, &us->data, us_ref ? &us_ref->data : NULL);
+  }
+#endif
+
   return true;
 }
 
+static void sculpt_undosys_step_restore_list(struct bContext *C,
+                                             Depsgraph *depsgraph,
+                                             SculptUndoStep *us)
+{
+#ifdef USE_ARRAY_STORE
+  sculpt_arraystore_expand(&us->data);
+#endif
+
+  sculpt_undo_restore_list(C, depsgraph, &us->data.nodes);
+
+#ifdef USE_ARRAY_STORE
+  /* Restoring swaps data with the mesh, store the new contents. */
+  if (us->data.use_array_store) {
+    sculpt_arraystore_compact_begin(&us->step, &us->data, NULL);
+  }
+#endif
+}
+
 static void sculpt_undosys_step_decode_undo_impl(struct bContext *C,
                                                  Depsgraph *depsgraph,
                                                  SculptUndoStep *us)
 {
   BLI_assert(us->step.is_applied == true);
-  sculpt_undo_restore_list(C, depsgraph, &us->data.nodes);
+  sculpt_undosys_step_restore_list(C, depsgraph, us);
   us->step.is_applied = false;
 }
 
@@ -1391,7 +1715,7 @@ static void sculpt_undosys_step_decode_redo_impl(struct bContext *C,
                                                  SculptUndoStep *us)
 {
   BLI_assert(us->step.is_applied == false);
-  sculpt_undo_restore_list(C, depsgraph, &us->data.nodes);
+  sculpt_undosys_step_restore_list(C, depsgraph, us);
   us->step.is_applied = true;
 }
 
@@ -1480,6 +1804,9 @@ static void sculpt_undosys_step_decode(
 static void sculpt_undosys_step_free(UndoStep *us_p)
 {
   SculptUndoStep *us = (SculptUndoStep *)us_p;
+#ifdef USE_ARRAY_STORE
+  sculpt_arraystore_free(&us->data);
+#endif
   sculpt_undo_free_list(&us->data.nodes);
 }
 
@@ -911,11 +911,10 @@ static void prefetch_task_func(TaskPool *__restrict pool, void *task_data)
       colorspace_name = clip->colorspace_settings.name;
     }
 
-    ibuf = IMB_ibImageFromMemory(mem, size, flag, colorspace_name, "prefetch frame");
+    ibuf = BKE_movieclip_ibuf_from_memory(mem, size, flag, colorspace_name, "prefetch frame");
     if (ibuf == NULL) {
       continue;
     }
-    BKE_movieclip_convert_multilayer_ibuf(ibuf);
 
     result = BKE_movieclip_put_frame_if_possible(clip, &user, ibuf);
 
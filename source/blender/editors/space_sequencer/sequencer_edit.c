@@ -147,18 +147,12 @@ static void proxy_freejob(void *pjv)
 static void proxy_startjob(void *pjv, short *stop, short *do_update, float *progress)
 {
   ProxyJob *pj = pjv;
-  LinkData *link;
-
-  for (link = pj->queue.first; link; link = link->next) {
-    struct SeqIndexBuildContext *context = link->data;
 
-    BKE_sequencer_proxy_rebuild(context, stop, do_update, progress);
+  BKE_sequencer_proxy_rebuild_queue(&pj->queue, stop, do_update, progress);
 
-    if (*stop) {
-      pj->stop = 1;
-      fprintf(stderr, "Canceling proxy rebuild on users request...\n");
-      break;
-    }
+  if (*stop) {
+    pj->stop = 1;
+    fprintf(stderr, "Canceling proxy rebuild on users request...\n");
   }
 }
 
@@ -853,9 +853,14 @@ static void recalcData_objects(TransInfo *t)
         projectVertSlideData(t, false);
       }
 
+      /* Modes editing custom data (crease, bevel weight, skin radius, UV correction)
+       * need all draw buffers to be updated, the others only move vertices. */
+      const bool is_deform_only = !ELEM(t->mode, TFM_BWEIGHT, TFM_CREASE, TFM_SKIN_RESIZE);
+
       FOREACH_TRANS_DATA_CONTAINER (t, tc) {
         DEG_id_tag_update(tc->obedit->data, 0); /* sets recalc flags */
         BMEditMesh *em = BKE_editmesh_from_object(tc->obedit);
+        em->is_deform_only_update = is_deform_only && (tc->custom.type.data == NULL);
         EDBM_mesh_normals_update(em);
         BKE_editmesh_looptri_calc(em);
       }
@@ -1936,6 +1941,14 @@ void postTrans(bContext *C, TransInfo *t)
     WM_cursor_modal_restore(CTX_wm_window(C));
   }
 
+  if ((t->flag & T_EDIT) && (t->obedit_type == OB_MESH)) {
+    /* Updates after transform (auto-merge, undo...) may change topology. */
+    FOREACH_TRANS_DATA_CONTAINER (t, tc) {
+      BMEditMesh *em = BKE_editmesh_from_object(tc->obedit);
+      em->is_deform_only_update = false;
+    }
+  }
+
   /* Free all custom-data */
   freeTransCustomDataContainer(t, NULL, &t->custom);
   FOREACH_TRANS_DATA_CONTAINER (t, tc) {
@@ -191,6 +191,19 @@ BLI_INLINE GPUPackedNormal GPU_normal_convert_i10_s3(const short data[3])
   return n;
 }
 
+/* Batch versions of the conversions above, for filling whole vertex buffers at once.
+ * `src_stride` is the distance between consecutive input normals in floats/shorts,
+ * so normals can be read directly from interleaved arrays (e.g. `MVert` or tangents).
+ * The `w` component of the output is set to 0. */
+void GPU_normal_convert_i10_v3_array(GPUPackedNormal *r_packed,
+                                     const float *src,
+                                     const uint src_stride,
+                                     const uint len);
+void GPU_normal_convert_i10_s3_array(GPUPackedNormal *r_packed,
+                                     const short *src,
+                                     const uint src_stride,
+                                     const uint len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -34,6 +34,10 @@
 #include "BLI_string.h"
 #include "BLI_utildefines.h"
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 #define PACK_DEBUG 0
 
 #if PACK_DEBUG
@@ -505,3 +509,82 @@ void GPU_vertformat_from_interface(GPUVertFormat *format, const GPUShaderInterfa
     }
   }
 }
+
+/* -------------------------------------------------------------------- */
+/** \name Batch Normal Conversion
+ * \{ */
+
+BLI_STATIC_ASSERT(sizeof(GPUPackedNormal) == sizeof(uint32_t), "GPUPackedNormal must be 32 bits")
+
+/* Packs three 10 bit components the same way as the #GPUPackedNormal bit-fields
+ * (x in the lowest bits, w left to 0). Writing whole words avoids the read-modify-write
+ * sequences compilers emit for bit-field assignments. */
+BLI_INLINE uint32_t gpu_pack_i10_v3(int x, int y, int z)
+{
+  return ((uint32_t)x & 0x3ffu) | (((uint32_t)y & 0x3ffu) << 10) |
+         (((uint32_t)z & 0x3ffu) << 20);
+}
+
+void GPU_normal_convert_i10_v3_array(GPUPackedNormal *r_packed,
+                                     const float *src,
+                                     const uint src_stride,
+                                     const uint len)
+{
+  BLI_assert(src_stride >= 3);
+  uint32_t *dst = (uint32_t *)r_packed;
+  uint i = 0;
+
+#ifdef __SSE2__
+  /* Four normals are processed at once, each loaded as four floats. With a tightly packed
+   * stride the last load reads one float past the normal, so keep the last one scalar. */
+  const uint simd_len = (src_stride >= 4) ? len : (len > 0 ? len - 1 : 0);
+  const __m128 scale = _mm_set1_ps(511.0f);
+  const __m128 min = _mm_set1_ps(-512.0f);
+  const __m128 max = _mm_set1_ps(511.0f);
+  const __m128i mask = _mm_set1_epi32(0x3ff);
+  for (; i + 4 <= simd_len; i += 4) {
+    const float *co = src + (size_t)i * src_stride;
+    __m128 r0 = _mm_loadu_ps(co);
+    __m128 r1 = _mm_loadu_ps(co + src_stride);
+    __m128 r2 = _mm_loadu_ps(co + src_stride * 2);
+    __m128 r3 = _mm_loadu_ps(co + src_stride * 3);
+    /* After the transpose r0, r1 and r2 hold the x, y and z components. */
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    /* Clamping before the truncating conversion gives the same result as
+     * #gpu_convert_normalized_f32_to_i10, since the bounds are integers. */
+    __m128i x = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(r0, scale), min), max));
+    __m128i y = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(r1, scale), min), max));
+    __m128i z = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_mul_ps(r2, scale), min), max));
+    __m128i packed = _mm_or_si128(
+        _mm_and_si128(x, mask),
+        _mm_or_si128(_mm_slli_epi32(_mm_and_si128(y, mask), 10),
+                     _mm_slli_epi32(_mm_and_si128(z, mask), 20)));
+    _mm_storeu_si128((__m128i *)(dst + i), packed);
+  }
+#endif
+
+  for (; i < len; i++) {
+    const float *co = src + (size_t)i * src_stride;
+    dst[i] = gpu_pack_i10_v3(gpu_convert_normalized_f32_to_i10(co[0]),
+                             gpu_convert_normalized_f32_to_i10(co[1]),
+                             gpu_convert_normalized_f32_to_i10(co[2]));
+  }
+}
+
+void GPU_normal_convert_i10_s3_array(GPUPackedNormal *r_packed,
+                                     const short *src,
+                                     const uint src_stride,
+                                     const uint len)
+{
+  BLI_assert(src_stride >= 3);
+  uint32_t *dst = (uint32_t *)r_packed;
+  /* Simple enough for compilers to vectorize, the inputs are usually strided (#MVert). */
+  for (uint i = 0; i < len; i++) {
+    const short *no = src + (size_t)i * src_stride;
+    dst[i] = gpu_pack_i10_v3(gpu_convert_i16_to_i10(no[0]),
+                             gpu_convert_i16_to_i10(no[1]),
+                             gpu_convert_i16_to_i10(no[2]));
+  }
+}
+
+/** \} */
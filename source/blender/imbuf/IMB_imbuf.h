@@ -456,6 +456,24 @@ bool IMB_scalefastImBuf(struct ImBuf *ibuf, unsigned int newx, unsigned int newy
  */
 void IMB_scaleImBuf_threaded(struct ImBuf *ibuf, unsigned int newx, unsigned int newy);
 
+typedef enum IMB_ScaleFilter {
+  /** Area average when scaling down, nearest pixel when scaling up. */
+  IMB_SCALE_FILTER_BOX = 0,
+  IMB_SCALE_FILTER_BILINEAR = 1,
+  /** Sharpest, but can ring around high contrast edges. */
+  IMB_SCALE_FILTER_LANCZOS3 = 2,
+  IMB_SCALE_FILTER_MITCHELL = 3,
+} IMB_ScaleFilter;
+
+/**
+ *
+ * \attention Defined in scaling.c
+ */
+bool IMB_scaleImBuf_filtered(struct ImBuf *ibuf,
+                             unsigned int newx,
+                             unsigned int newy,
+                             IMB_ScaleFilter filter);
+
 /**
  *
  * \attention Defined in writeimage.c
@@ -40,6 +40,10 @@ struct MovieCache;
 
 typedef void (*MovieCacheGetKeyDataFP)(void *userkey, int *framenr, int *proxy, int *render_flags);
 
+/* Frame number reported by MovieCacheGetKeyDataFP for buffers which are not frames of a sequence,
+ * such as still images. They keep the neutral priority of the cache limiter. */
+#define IMB_MOVIECACHE_NO_FRAMENR (-0x7fffffff)
+
 typedef void *(*MovieCacheGetPriorityDataFP)(void *userkey);
 typedef int (*MovieCacheGetItemPriorityFP)(void *last_userkey, void *priority_data);
 typedef void (*MovieCachePriorityDeleterFP)(void *priority_data);
@@ -47,6 +51,9 @@ typedef void (*MovieCachePriorityDeleterFP)(void *priority_data);
 void IMB_moviecache_init(void);
 void IMB_moviecache_destruct(void);
 
+void IMB_moviecache_set_playback(int direction, int loop_length);
+int IMB_moviecache_frame_priority(int current_framenr, int framenr);
+
 struct MovieCache *IMB_moviecache_create(const char *name,
                                          int keysize,
                                          GHashHashFP hashfp,
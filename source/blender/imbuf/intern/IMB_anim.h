@@ -79,9 +79,13 @@
 #define ANIM_AVI (1 << 6)
 #define ANIM_FFMPEG (1 << 8)
 
+/* Frames decoded ahead of the last fetched one during sequential playback. */
+#define ANIM_DECODE_AHEAD_FRAMES 4
+
 #define MAXNUMSTREAMS 50
 
 struct IDProperty;
+struct TaskPool;
 struct _AviMovie;
 struct anim_index;
 
@@ -137,6 +141,17 @@ struct anim {
   int64_t last_pts;
   int64_t next_pts;
   AVPacket next_packet;
+
+  /* Ring of converted frames following last_frame, filled by a background task. While it is
+   * not empty the decoder is positioned after its last frame instead of after last_frame. */
+  struct TaskPool *decode_ahead_pool;
+  struct ImBuf *decode_ahead_frames[ANIM_DECODE_AHEAD_FRAMES];
+  int64_t decode_ahead_pts[ANIM_DECODE_AHEAD_FRAMES];
+  int64_t decode_ahead_next_pts[ANIM_DECODE_AHEAD_FRAMES];
+  int decode_ahead_start;
+  int decode_ahead_num;
+  /* Set by the owner thread while the background task runs, polled by the task. */
+  volatile bool decode_ahead_stop;
 #endif
 
   char index_dir[768];
@@ -55,6 +55,8 @@
 
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
 #include "BLI_utildefines.h"
 
 #include "MEM_guardedalloc.h"
@@ -554,6 +556,10 @@ static int startffmpeg(struct anim *anim)
 
   pCodecCtx->workaround_bugs = 1;
 
+  /* Let the decoder use frame and slice threading instead of relying on FFmpeg defaults. */
+  pCodecCtx->thread_count = BLI_system_thread_count();
+  pCodecCtx->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
   if (avcodec_open2(pCodecCtx, pCodec, NULL) < 0) {
     avformat_close_input(&pFormatCtx);
     return -1;
@@ -622,6 +628,11 @@ static int startffmpeg(struct anim *anim)
   anim->next_pts = -1;
   anim->next_packet.stream_index = -1;
 
+  anim->decode_ahead_pool = NULL;
+  anim->decode_ahead_start = 0;
+  anim->decode_ahead_num = 0;
+  anim->decode_ahead_stop = false;
+
   anim->pFrame = av_frame_alloc();
   anim->pFrameComplete = false;
   anim->pFrameDeinterlaced = av_frame_alloc();
@@ -730,13 +741,12 @@ static int startffmpeg(struct anim *anim)
 /* postprocess the image in anim->pFrame and do color conversion
  * and deinterlacing stuff.
  *
- * Output is anim->last_frame
+ * Output is ibuf
  */
 
-static void ffmpeg_postprocess(struct anim *anim)
+static void ffmpeg_postprocess(struct anim *anim, ImBuf *ibuf)
 {
   AVFrame *input = anim->pFrame;
-  ImBuf *ibuf = anim->last_frame;
   int filter_y = 0;
 
   if (!anim->pFrameComplete) {
@@ -987,6 +997,99 @@ static void ffmpeg_decode_video_frame_scan(struct anim *anim, int64_t pts_to_sea
   }
 }
 
+static ImBuf *ffmpeg_frame_buffer_alloc(struct anim *anim)
+{
+  ImBuf *ibuf = IMB_allocImBuf(anim->x, anim->y, 32, IB_rect);
+  ibuf->rect_colorspace = colormanage_colorspace_get_named(anim->colorspace);
+  return ibuf;
+}
+
+/* Background task: convert the frame waiting in the decoder and decode the next one, until the
+ * ring is full, the stream ends or the main thread asks to stop. Only this task touches the
+ * decoder while it runs, fetching waits for it first. */
+static void ffmpeg_decode_ahead_task(TaskPool *__restrict pool, void *UNUSED(taskdata))
+{
+  struct anim *anim = BLI_task_pool_user_data(pool);
+
+  while (!anim->decode_ahead_stop && anim->decode_ahead_num < ANIM_DECODE_AHEAD_FRAMES &&
+         anim->pFrameComplete) {
+    const int index = (anim->decode_ahead_start + anim->decode_ahead_num) %
+                      ANIM_DECODE_AHEAD_FRAMES;
+    ImBuf *ibuf = ffmpeg_frame_buffer_alloc(anim);
+    bool decoded;
+
+    ffmpeg_postprocess(anim, ibuf);
+
+    anim->decode_ahead_pts[index] = anim->next_pts;
+    decoded = ffmpeg_decode_video_frame(anim);
+    /* At the end of the stream the range is empty, so the frame is never matched and the
+     * fetch falls back to seeking, like it does without decode-ahead. */
+    anim->decode_ahead_next_pts[index] = decoded ? anim->next_pts : anim->decode_ahead_pts[index];
+    anim->decode_ahead_frames[index] = ibuf;
+    anim->decode_ahead_num++;
+
+    if (!decoded) {
+      break;
+    }
+  }
+}
+
+static void ffmpeg_decode_ahead_start(struct anim *anim)
+{
+  if (anim->decode_ahead_pool == NULL) {
+    anim->decode_ahead_pool = BLI_task_pool_create_background_serial(anim, TASK_PRIORITY_LOW);
+  }
+  BLI_task_pool_push(anim->decode_ahead_pool, ffmpeg_decode_ahead_task, NULL, false, NULL);
+}
+
+static void ffmpeg_decode_ahead_stop(struct anim *anim)
+{
+  if (anim->decode_ahead_pool) {
+    anim->decode_ahead_stop = true;
+    BLI_task_pool_work_and_wait(anim->decode_ahead_pool);
+    anim->decode_ahead_stop = false;
+  }
+}
+
+static void ffmpeg_decode_ahead_flush(struct anim *anim)
+{
+  for (int i = 0; i < anim->decode_ahead_num; i++) {
+    const int index = (anim->decode_ahead_start + i) % ANIM_DECODE_AHEAD_FRAMES;
+    IMB_freeImBuf(anim->decode_ahead_frames[index]);
+    anim->decode_ahead_frames[index] = NULL;
+  }
+  anim->decode_ahead_start = 0;
+  anim->decode_ahead_num = 0;
+}
+
+/* Make the decoded-ahead frame showing pts_to_search the last frame, dropping the frames
+ * before it. */
+static bool ffmpeg_decode_ahead_take(struct anim *anim, int64_t pts_to_search)
+{
+  for (int i = 0; i < anim->decode_ahead_num; i++) {
+    const int index = (anim->decode_ahead_start + i) % ANIM_DECODE_AHEAD_FRAMES;
+
+    if (anim->decode_ahead_pts[index] <= pts_to_search &&
+        anim->decode_ahead_next_pts[index] > pts_to_search) {
+      for (int j = 0; j < i; j++) {
+        const int skip_index = (anim->decode_ahead_start + j) % ANIM_DECODE_AHEAD_FRAMES;
+        IMB_freeImBuf(anim->decode_ahead_frames[skip_index]);
+        anim->decode_ahead_frames[skip_index] = NULL;
+      }
+
+      IMB_freeImBuf(anim->last_frame);
+      anim->last_frame = anim->decode_ahead_frames[index];
+      anim->last_pts = anim->decode_ahead_pts[index];
+      anim->decode_ahead_frames[index] = NULL;
+
+      anim->decode_ahead_start = (index + 1) % ANIM_DECODE_AHEAD_FRAMES;
+      anim->decode_ahead_num -= i + 1;
+      return true;
+    }
+  }
+  return false;
+}
+
 static int match_format(const char *name, AVFormatContext *pFormatCtx)
 {
   const char *p;
@@ -1039,11 +1142,17 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
   AVStream *v_st;
   int new_frame_index = 0; /* To quiet gcc barking... */
   int old_frame_index = 0; /* To quiet gcc barking... */
+  int64_t last_frame_next_pts;
+  bool is_sequential, decoder_ahead;
 
   if (anim == NULL) {
     return (0);
   }
 
+  ffmpeg_decode_ahead_stop(anim);
+
+  is_sequential = (position == anim->curposition + 1);
+
   av_log(anim->pFormatCtx, AV_LOG_DEBUG, "FETCH: pos=%d\n", position);
 
   if (tc != IMB_TC_NONE) {
@@ -1079,24 +1188,45 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
          frame_rate,
          st_time);
 
-  if (anim->last_frame && anim->last_pts <= pts_to_search && anim->next_pts > pts_to_search) {
+  if (ffmpeg_decode_ahead_take(anim, pts_to_search)) {
+    av_log(anim->pFormatCtx,
+           AV_LOG_DEBUG,
+           "FETCH: decoded ahead: %lld\n",
+           (long long int)anim->last_pts);
+    IMB_refImBuf(anim->last_frame);
+    anim->curposition = position;
+    ffmpeg_decode_ahead_start(anim);
+    return anim->last_frame;
+  }
+
+  /* With frames decoded ahead, last_frame ends where the first of them starts. */
+  last_frame_next_pts = anim->decode_ahead_num ?
+                            anim->decode_ahead_pts[anim->decode_ahead_start] :
+                            anim->next_pts;
+
+  if (anim->last_frame && anim->last_pts <= pts_to_search && last_frame_next_pts > pts_to_search) {
     av_log(anim->pFormatCtx,
            AV_LOG_DEBUG,
            "FETCH: frame repeat: last: %lld next: %lld\n",
            (long long int)anim->last_pts,
-           (long long int)anim->next_pts);
+           (long long int)last_frame_next_pts);
     IMB_refImBuf(anim->last_frame);
     anim->curposition = position;
     return anim->last_frame;
   }
 
-  if (position > anim->curposition + 1 && anim->preseek && !tc_index &&
+  /* The decoder went past the requested frame, so scanning forward can't reach it. */
+  decoder_ahead = anim->decode_ahead_num != 0;
+  ffmpeg_decode_ahead_flush(anim);
+
+  if (!decoder_ahead && position > anim->curposition + 1 && anim->preseek && !tc_index &&
       position - (anim->curposition + 1) < anim->preseek) {
     av_log(anim->pFormatCtx, AV_LOG_DEBUG, "FETCH: within preseek interval (no index)\n");
 
     ffmpeg_decode_video_frame_scan(anim, pts_to_search);
   }
-  else if (tc_index && IMB_indexer_can_scan(tc_index, old_frame_index, new_frame_index)) {
+  else if (!decoder_ahead && tc_index &&
+           IMB_indexer_can_scan(tc_index, old_frame_index, new_frame_index)) {
     av_log(anim->pFormatCtx,
            AV_LOG_DEBUG,
            "FETCH: within preseek interval "
@@ -1104,7 +1234,7 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
 
     ffmpeg_decode_video_frame_scan(anim, pts_to_search);
   }
-  else if (position != anim->curposition + 1) {
+  else if (decoder_ahead || position != anim->curposition + 1) {
     long long pos;
     int ret;
 
@@ -1186,10 +1316,9 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
   }
 
   IMB_freeImBuf(anim->last_frame);
-  anim->last_frame = IMB_allocImBuf(anim->x, anim->y, 32, IB_rect);
-  anim->last_frame->rect_colorspace = colormanage_colorspace_get_named(anim->colorspace);
+  anim->last_frame = ffmpeg_frame_buffer_alloc(anim);
 
-  ffmpeg_postprocess(anim);
+  ffmpeg_postprocess(anim, anim->last_frame);
 
   anim->last_pts = anim->next_pts;
 
@@ -1197,6 +1326,11 @@ static ImBuf *ffmpeg_fetchibuf(struct anim *anim, int position, IMB_Timecode_Typ
 
   anim->curposition = position;
 
+  /* Only playback benefits from decoding ahead, scrubbing would throw the frames away. */
+  if (is_sequential) {
+    ffmpeg_decode_ahead_start(anim);
+  }
+
   IMB_refImBuf(anim->last_frame);
 
   return anim->last_frame;
@@ -1209,6 +1343,13 @@ static void free_anim_ffmpeg(struct anim *anim)
   }
 
   if (anim->pCodecCtx) {
+    ffmpeg_decode_ahead_stop(anim);
+    ffmpeg_decode_ahead_flush(anim);
+    if (anim->decode_ahead_pool) {
+      BLI_task_pool_free(anim->decode_ahead_pool);
+      anim->decode_ahead_pool = NULL;
+    }
+
     avcodec_close(anim->pCodecCtx);
     avformat_close_input(&anim->pFormatCtx);
 
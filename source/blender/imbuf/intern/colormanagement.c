@@ -97,10 +97,51 @@ static float imbuf_linear_srgb_to_xyz[3][3] = {{0.0f}};
  */
 static pthread_mutex_t processor_lock = BLI_MUTEX_INITIALIZER;
 
+/* Transforms which are applied without going through OCIO, see colormanage_fast_path_detect. */
+typedef enum eColormanageFastPath {
+  COLORMANAGE_FAST_PATH_NONE = 0,
+  COLORMANAGE_FAST_PATH_IDENTITY,
+  COLORMANAGE_FAST_PATH_LINEAR_TO_SRGB,
+  COLORMANAGE_FAST_PATH_SRGB_TO_LINEAR,
+} eColormanageFastPath;
+
+/* Settings the OCIO processor of a color management processor was created from, which identify
+ * its baked LUT. */
+typedef struct ColormanageLUTKey {
+  char look[MAX_COLORSPACE_NAME];
+  char view[MAX_COLORSPACE_NAME];
+  char from_colorspace[MAX_COLORSPACE_NAME];
+  /* Display device, or color space for color space transforms. */
+  char to[MAX_COLORSPACE_NAME];
+  float exposure;
+  float gamma;
+  bool is_display;
+} ColormanageLUTKey;
+
+/* Baked LUT shared by all processors with the same key, see colormanage_processor_lut_ensure. */
+typedef struct ColormanageLUT {
+  struct ColormanageLUT *next, *prev;
+  ColormanageLUTKey key;
+  /* NULL when the baked LUT did not match OCIO, so baking is not attempted again. */
+  float (*lut)[3];
+  /* Number of processors using the LUT, which is only freed when not used. */
+  int users;
+} ColormanageLUT;
+
+/* Baked LUTs, most recently used first. Guarded by lut_cache_lock, since processors are created
+ * from any thread. */
+static ListBase global_lut_cache = {NULL, NULL};
+static pthread_mutex_t lut_cache_lock = BLI_MUTEX_INITIALIZER;
+
 typedef struct ColormanageProcessor {
   OCIO_ConstProcessorRcPtr *processor;
   CurveMapping *curve_mapping;
   bool is_data_result;
+  eColormanageFastPath fast_path;
+  /* Baked transform of processors without fast path, see colormanage_processor_lut_ensure. */
+  ColormanageLUTKey lut_key;
+  ColormanageLUT *lut_entry;
+  float (*lut)[3];
 } ColormanageProcessor;
 
 static struct global_glsl_state {
@@ -585,11 +626,16 @@ static void colormanage_load_config(OCIO_ConstConfigRcPtr *config)
   invert_m3_m3(imbuf_linear_srgb_to_xyz, imbuf_xyz_to_linear_srgb);
 }
 
+static void colormanage_lut_cache_free(void);
+
 static void colormanage_free_config(void)
 {
   ColorSpace *colorspace;
   ColorManagedDisplay *display;
 
+  /* free baked LUTs, they depend on the configuration */
+  colormanage_lut_cache_free();
+
   /* free color spaces */
   colorspace = global_colorspaces.first;
   while (colorspace) {
@@ -1456,6 +1502,379 @@ bool IMB_colormanagement_space_name_is_data(const char *name)
   return (colorspace && colorspace->is_data);
 }
 
+/*********************** Fast path transforms *************************/
+
+/* Maximum difference from the OCIO result for a transform to use a fast path,
+ * which is well below a single step of 8 bit display buffers. */
+#define COLORMANAGE_FAST_PATH_EPSILON 1e-3f
+
+/* Transforms without an analytic equivalent (such as Filmic) are baked into a 3D LUT when a
+ * large buffer is transformed. The LUT is indexed in log space, so it covers scene linear HDR
+ * colors with a resolution similar to the LUTs used by such views. */
+#define COLORMANAGE_LUT_SIZE 65
+#define COLORMANAGE_LUT_LOG_MIN -15.0f
+#define COLORMANAGE_LUT_LOG_MAX 10.0f
+/* Baking evaluates OCIO for every LUT entry, only worth it for buffers a few times larger. */
+#define COLORMANAGE_LUT_MIN_PIXELS \
+  (4 * COLORMANAGE_LUT_SIZE * COLORMANAGE_LUT_SIZE * COLORMANAGE_LUT_SIZE)
+/* Maximum difference from the OCIO result for the baked LUT to be used, just below a single step
+ * of 8 bit display buffers. Relative to the result for results above 1. */
+#define COLORMANAGE_LUT_EPSILON 3.9e-3f
+#define COLORMANAGE_LUT_NUM_SAMPLES 512
+/* Number of unused baked LUTs kept around, each takes a few megabytes. */
+#define COLORMANAGE_LUT_CACHE_MAX 8
+
+/* Analytic transforms are only compared against OCIO for colors within the [0, 1] range, other
+ * colors go through OCIO since configurations differ in how they clamp or extrapolate HDR and
+ * negative values. */
+BLI_INLINE bool colormanage_fast_path_in_range(const float pixel[3])
+{
+  return (pixel[0] >= 0.0f && pixel[0] <= 1.0f && pixel[1] >= 0.0f && pixel[1] <= 1.0f &&
+          pixel[2] >= 0.0f && pixel[2] <= 1.0f);
+}
+
+static void colormanage_fast_path_transform_v3(const eColormanageFastPath fast_path,
+                                               float pixel[3])
+{
+  switch (fast_path) {
+    case COLORMANAGE_FAST_PATH_LINEAR_TO_SRGB:
+      linearrgb_to_srgb_v3_v3(pixel, pixel);
+      break;
+    case COLORMANAGE_FAST_PATH_SRGB_TO_LINEAR:
+      srgb_to_linearrgb_v3_v3(pixel, pixel);
+      break;
+    case COLORMANAGE_FAST_PATH_IDENTITY:
+    case COLORMANAGE_FAST_PATH_NONE:
+      break;
+  }
+}
+
+BLI_INLINE float colormanage_lut_value_to_index(const float value)
+{
+  const float offset = exp2f(COLORMANAGE_LUT_LOG_MIN);
+  return (log2f(value + offset) - COLORMANAGE_LUT_LOG_MIN) *
+         ((COLORMANAGE_LUT_SIZE - 1) / (COLORMANAGE_LUT_LOG_MAX - COLORMANAGE_LUT_LOG_MIN));
+}
+
+BLI_INLINE float colormanage_lut_index_to_value(const float index)
+{
+  const float stops_per_index = (COLORMANAGE_LUT_LOG_MAX - COLORMANAGE_LUT_LOG_MIN) /
+                                (COLORMANAGE_LUT_SIZE - 1);
+  return exp2f(COLORMANAGE_LUT_LOG_MIN + index * stops_per_index) -
+         exp2f(COLORMANAGE_LUT_LOG_MIN);
+}
+
+BLI_INLINE bool colormanage_lut_in_range(const float pixel[3])
+{
+  const float max = exp2f(COLORMANAGE_LUT_LOG_MAX) - exp2f(COLORMANAGE_LUT_LOG_MIN);
+  return (pixel[0] >= 0.0f && pixel[0] <= max && pixel[1] >= 0.0f && pixel[1] <= max &&
+          pixel[2] >= 0.0f && pixel[2] <= max);
+}
+
+/* The LUT entries get further apart along with the values, so results of transforms which don't
+ * clamp HDR colors are compared relative to their magnitude. */
+BLI_INLINE bool colormanage_lut_compare_v3(const float result[3], const float ocio_result[3])
+{
+  for (int c = 0; c < 3; c++) {
+    const float limit = COLORMANAGE_LUT_EPSILON * max_ff(1.0f, fabsf(ocio_result[c]));
+    if (fabsf(result[c] - ocio_result[c]) > limit) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* Trilinear lookup, the pixel must be within colormanage_lut_in_range(). */
+static void colormanage_lut_transform_v3(const float (*lut)[3], float pixel[3])
+{
+  const size_t stride[3] = {1, COLORMANAGE_LUT_SIZE, COLORMANAGE_LUT_SIZE * COLORMANAGE_LUT_SIZE};
+  size_t offset = 0;
+  float factor[3];
+
+  for (int c = 0; c < 3; c++) {
+    const float index = colormanage_lut_value_to_index(pixel[c]);
+    const int index_floor = min_ii((int)index, COLORMANAGE_LUT_SIZE - 2);
+
+    offset += stride[c] * index_floor;
+    factor[c] = clamp_f(index - index_floor, 0.0f, 1.0f);
+  }
+
+  zero_v3(pixel);
+  for (int corner = 0; corner < 8; corner++) {
+    size_t corner_offset = offset;
+    float weight = 1.0f;
+
+    for (int c = 0; c < 3; c++) {
+      if (corner & (1 << c)) {
+        corner_offset += stride[c];
+        weight *= factor[c];
+      }
+      else {
+        weight *= 1.0f - factor[c];
+      }
+    }
+
+    madd_v3_v3fl(pixel, lut[corner_offset], weight);
+  }
+}
+
+/* Bake the processor into a LUT, which is discarded when it does not match OCIO on a set of
+ * sample colors. The samples follow a low discrepancy sequence which is different per channel,
+ * so they end up between the LUT entries. */
+static float (*colormanage_lut_bake(OCIO_ConstProcessorRcPtr *processor))[3]
+{
+  const int lut_len = COLORMANAGE_LUT_SIZE * COLORMANAGE_LUT_SIZE * COLORMANAGE_LUT_SIZE;
+  const float sequence_step[3] = {0.6180340f, 0.7548777f, 0.5698403f};
+  float(*lut)[3] = MEM_mallocN(sizeof(*lut) * lut_len, "colormanage LUT");
+  OCIO_PackedImageDesc *img;
+
+  for (int b = 0, i = 0; b < COLORMANAGE_LUT_SIZE; b++) {
+    for (int g = 0; g < COLORMANAGE_LUT_SIZE; g++) {
+      for (int r = 0; r < COLORMANAGE_LUT_SIZE; r++, i++) {
+        lut[i][0] = colormanage_lut_index_to_value(r);
+        lut[i][1] = colormanage_lut_index_to_value(g);
+        lut[i][2] = colormanage_lut_index_to_value(b);
+      }
+    }
+  }
+
+  img = OCIO_createOCIO_PackedImageDesc((float *)lut,
+                                        lut_len,
+                                        1,
+                                        3,
+                                        sizeof(float),
+                                        3 * sizeof(float),
+                                        (size_t)lut_len * 3 * sizeof(float));
+  OCIO_processorApply(processor, img);
+  OCIO_PackedImageDescRelease(img);
+
+  for (int i = 0; i < COLORMANAGE_LUT_NUM_SAMPLES; i++) {
+    float sample[3], ocio_result[3];
+
+    for (int c = 0; c < 3; c++) {
+      const float t = fractf((i + 0.5f) * sequence_step[c]);
+      sample[c] = colormanage_lut_index_to_value(t * (COLORMANAGE_LUT_SIZE - 1));
+    }
+
+    copy_v3_v3(ocio_result, sample);
+    OCIO_processorApplyRGB(processor, ocio_result);
+    colormanage_lut_transform_v3((const float(*)[3])lut, sample);
+
+    if (!colormanage_lut_compare_v3(sample, ocio_result)) {
+      MEM_freeN(lut);
+      return NULL;
+    }
+  }
+
+  return lut;
+}
+
+static bool colormanage_lut_key_equal(const ColormanageLUTKey *a, const ColormanageLUTKey *b)
+{
+  return (a->is_display == b->is_display && a->exposure == b->exposure &&
+          a->gamma == b->gamma && STREQ(a->look, b->look) && STREQ(a->view, b->view) &&
+          STREQ(a->from_colorspace, b->from_colorspace) && STREQ(a->to, b->to));
+}
+
+static void colormanage_lut_free(ColormanageLUT *lut_entry)
+{
+  if (lut_entry->lut) {
+    MEM_freeN(lut_entry->lut);
+  }
+  MEM_freeN(lut_entry);
+}
+
+/* Free least recently used LUTs which are not used by any processor, until there is room for a
+ * new one. Must be called with the cache locked. */
+static void colormanage_lut_cache_trim(void)
+{
+  int num_luts = BLI_listbase_count(&global_lut_cache);
+  ColormanageLUT *lut_entry = global_lut_cache.last;
+
+  while (lut_entry && num_luts >= COLORMANAGE_LUT_CACHE_MAX) {
+    ColormanageLUT *lut_entry_prev = lut_entry->prev;
+
+    if (lut_entry->users == 0) {
+      BLI_remlink(&global_lut_cache, lut_entry);
+      colormanage_lut_free(lut_entry);
+      num_luts--;
+    }
+
+    lut_entry = lut_entry_prev;
+  }
+}
+
+static void colormanage_lut_cache_free(void)
+{
+  ColormanageLUT *lut_entry = global_lut_cache.first;
+
+  while (lut_entry) {
+    ColormanageLUT *lut_entry_next = lut_entry->next;
+
+    BLI_assert(lut_entry->users == 0);
+    colormanage_lut_free(lut_entry);
+
+    lut_entry = lut_entry_next;
+  }
+  BLI_listbase_clear(&global_lut_cache);
+}
+
+/* Get the LUT for processors without analytic fast path, when they are about to transform a
+ * buffer large enough to make up for the baking. The LUT is only baked by the first processor
+ * of its transform, others (such as the processors of following frames) reuse it. Must be
+ * called before the processor is used from multiple threads. */
+static void colormanage_processor_lut_ensure(ColormanageProcessor *cm_processor,
+                                             const size_t num_pixels)
+{
+  ColormanageLUT *lut_entry;
+
+  if (cm_processor->processor == NULL || cm_processor->fast_path != COLORMANAGE_FAST_PATH_NONE ||
+      cm_processor->lut_entry != NULL || num_pixels < COLORMANAGE_LUT_MIN_PIXELS) {
+    return;
+  }
+
+  BLI_mutex_lock(&lut_cache_lock);
+
+  for (lut_entry = global_lut_cache.first; lut_entry; lut_entry = lut_entry->next) {
+    if (colormanage_lut_key_equal(&lut_entry->key, &cm_processor->lut_key)) {
+      break;
+    }
+  }
+
+  if (lut_entry) {
+    BLI_remlink(&global_lut_cache, lut_entry);
+  }
+  else {
+    /* Baking with the cache locked, so concurrent processors of the same transform wait for
+     * the LUT instead of baking it as well. */
+    colormanage_lut_cache_trim();
+
+    lut_entry = MEM_callocN(sizeof(ColormanageLUT), "colormanage LUT cache entry");
+    lut_entry->key = cm_processor->lut_key;
+    lut_entry->lut = colormanage_lut_bake(cm_processor->processor);
+  }
+
+  BLI_addhead(&global_lut_cache, lut_entry);
+  lut_entry->users++;
+
+  BLI_mutex_unlock(&lut_cache_lock);
+
+  cm_processor->lut_entry = lut_entry;
+  cm_processor->lut = lut_entry->lut;
+}
+
+static void colormanage_processor_lut_release(ColormanageProcessor *cm_processor)
+{
+  BLI_mutex_lock(&lut_cache_lock);
+  cm_processor->lut_entry->users--;
+  BLI_mutex_unlock(&lut_cache_lock);
+}
+
+static void colormanage_processor_fast_apply_v3(ColormanageProcessor *cm_processor,
+                                                float pixel[3])
+{
+  if (cm_processor->fast_path != COLORMANAGE_FAST_PATH_NONE &&
+      colormanage_fast_path_in_range(pixel)) {
+    colormanage_fast_path_transform_v3(cm_processor->fast_path, pixel);
+  }
+  else if (cm_processor->lut != NULL && colormanage_lut_in_range(pixel)) {
+    colormanage_lut_transform_v3((const float(*)[3])cm_processor->lut, pixel);
+  }
+  else if (cm_processor->processor) {
+    OCIO_processorApplyRGB(cm_processor->processor, pixel);
+  }
+}
+
+/* Same as OCIO's predivide: transform the straight color for partially transparent pixels. */
+static void colormanage_processor_fast_apply_v4_predivide(ColormanageProcessor *cm_processor,
+                                                          float pixel[4])
+{
+  const float alpha = pixel[3];
+
+  if (alpha == 1.0f || alpha == 0.0f) {
+    colormanage_processor_fast_apply_v3(cm_processor, pixel);
+  }
+  else {
+    const float inv_alpha = 1.0f / alpha;
+
+    mul_v3_fl(pixel, inv_alpha);
+    colormanage_processor_fast_apply_v3(cm_processor, pixel);
+    mul_v3_fl(pixel, alpha);
+  }
+}
+
+/* Transform a buffer using the fast path or the baked LUT, colors outside of their range are
+ * transformed by OCIO one by one. */
+static void colormanage_processor_fast_apply(ColormanageProcessor *cm_processor,
+                                             float *buffer,
+                                             const int width,
+                                             const int height,
+                                             const int channels,
+                                             const bool predivide)
+{
+  const size_t num_pixels = (size_t)width * height;
+
+  if (predivide && channels == 4) {
+    for (size_t i = 0; i < num_pixels; i++) {
+      colormanage_processor_fast_apply_v4_predivide(cm_processor, buffer + i * 4);
+    }
+  }
+  else {
+    for (size_t i = 0; i < num_pixels; i++) {
+      colormanage_processor_fast_apply_v3(cm_processor, buffer + i * channels);
+    }
+  }
+}
+
+/* Detect processors which are equivalent to one of the analytic transforms within the [0, 1]
+ * range, by comparing results on a set of sample colors. The samples have different values in
+ * every channel, so transforms which mix channels (such as gamut conversion) are not matched. */
+static eColormanageFastPath colormanage_fast_path_detect(OCIO_ConstProcessorRcPtr *processor)
+{
+  static const float samples[][3] = {
+      {0.0f, 0.5f, 1.0f},
+      {1.0f, 0.0f, 0.25f},
+      {0.18f, 0.02f, 0.75f},
+      {0.0031308f, 0.04045f, 0.001f},
+      {0.9f, 0.3f, 0.6f},
+      {0.01f, 0.99f, 0.42f},
+      {0.07f, 0.6f, 0.003f},
+  };
+  const eColormanageFastPath candidates[] = {
+      COLORMANAGE_FAST_PATH_IDENTITY,
+      COLORMANAGE_FAST_PATH_LINEAR_TO_SRGB,
+      COLORMANAGE_FAST_PATH_SRGB_TO_LINEAR,
+  };
+  float ocio_result[ARRAY_SIZE(samples)][3];
+
+  if (processor == NULL) {
+    return COLORMANAGE_FAST_PATH_NONE;
+  }
+
+  for (int i = 0; i < ARRAY_SIZE(samples); i++) {
+    copy_v3_v3(ocio_result[i], samples[i]);
+    OCIO_processorApplyRGB(processor, ocio_result[i]);
+  }
+
+  for (int c = 0; c < ARRAY_SIZE(candidates); c++) {
+    bool is_equal = true;
+
+    for (int i = 0; i < ARRAY_SIZE(samples) && is_equal; i++) {
+      float result[3];
+
+      copy_v3_v3(result, samples[i]);
+      colormanage_fast_path_transform_v3(candidates[c], result);
+      is_equal = compare_v3v3(result, ocio_result[i], COLORMANAGE_FAST_PATH_EPSILON);
+    }
+
+    if (is_equal) {
+      return candidates[c];
+    }
+  }
+
+  return COLORMANAGE_FAST_PATH_NONE;
+}
+
 /*********************** Threaded display buffer transform routines *************************/
 
 typedef struct DisplayBufferThread {
@@ -1751,6 +2170,10 @@ static void display_buffer_apply_threaded(ImBuf *ibuf,
     init_data.float_colorspace = NULL;
   }
 
+  if (cm_processor != NULL) {
+    colormanage_processor_lut_ensure(cm_processor, (size_t)ibuf->x * ibuf->y);
+  }
+
   IMB_processor_apply_threaded(ibuf->y,
                                sizeof(DisplayBufferThread),
                                &init_data,
@@ -1945,6 +2368,8 @@ static void processor_transform_apply_threaded(unsigned char *byte_buffer,
   init_data.predivide = predivide;
   init_data.float_from_byte = float_from_byte;
 
+  colormanage_processor_lut_ensure(cm_processor, (size_t)width * height);
+
   IMB_processor_apply_threaded(height,
                                sizeof(ProcessorTransformThread),
                                &init_data,
@@ -2207,7 +2632,17 @@ void IMB_colormanagement_colorspace_to_scene_linear(float *buffer,
 
   processor = colorspace_to_scene_linear_processor(colorspace);
 
-  if (processor) {
+  if (channels >= 3 && (IMB_colormanagement_space_is_scene_linear(colorspace) ||
+                        IMB_colormanagement_space_is_srgb(colorspace))) {
+    ColormanageProcessor cm_processor = {NULL};
+
+    cm_processor.processor = processor;
+    cm_processor.fast_path = IMB_colormanagement_space_is_scene_linear(colorspace) ?
+                                 COLORMANAGE_FAST_PATH_IDENTITY :
+                                 COLORMANAGE_FAST_PATH_SRGB_TO_LINEAR;
+    colormanage_processor_fast_apply(&cm_processor, buffer, width, height, channels, predivide);
+  }
+  else if (processor) {
     OCIO_PackedImageDesc *img;
 
     img = OCIO_createOCIO_PackedImageDesc(buffer,
@@ -3780,6 +4215,23 @@ ColormanageProcessor *IMB_colormanagement_display_processor_new(
                                                             applied_view_settings->gamma,
                                                             global_role_scene_linear,
                                                             false);
+  cm_processor->fast_path = colormanage_fast_path_detect(cm_processor->processor);
+
+  BLI_strncpy(cm_processor->lut_key.look,
+              applied_view_settings->look,
+              sizeof(cm_processor->lut_key.look));
+  BLI_strncpy(cm_processor->lut_key.view,
+              applied_view_settings->view_transform,
+              sizeof(cm_processor->lut_key.view));
+  BLI_strncpy(cm_processor->lut_key.from_colorspace,
+              global_role_scene_linear,
+              sizeof(cm_processor->lut_key.from_colorspace));
+  BLI_strncpy(cm_processor->lut_key.to,
+              display_settings->display_device,
+              sizeof(cm_processor->lut_key.to));
+  cm_processor->lut_key.exposure = applied_view_settings->exposure;
+  cm_processor->lut_key.gamma = applied_view_settings->gamma;
+  cm_processor->lut_key.is_display = true;
 
   if (applied_view_settings->flag & COLORMANAGE_VIEW_USE_CURVES) {
     cm_processor->curve_mapping = BKE_curvemapping_copy(applied_view_settings->curve_mapping);
@@ -3801,6 +4253,13 @@ ColormanageProcessor *IMB_colormanagement_colorspace_processor_new(const char *f
   cm_processor->is_data_result = color_space->is_data;
 
   cm_processor->processor = create_colorspace_transform_processor(from_colorspace, to_colorspace);
+  cm_processor->fast_path = colormanage_fast_path_detect(cm_processor->processor);
+
+  BLI_strncpy(cm_processor->lut_key.from_colorspace,
+              from_colorspace,
+              sizeof(cm_processor->lut_key.from_colorspace));
+  BLI_strncpy(cm_processor->lut_key.to, to_colorspace, sizeof(cm_processor->lut_key.to));
+  cm_processor->lut_key.gamma = 1.0f;
 
   return cm_processor;
 }
@@ -3811,7 +4270,10 @@ void IMB_colormanagement_processor_apply_v4(ColormanageProcessor *cm_processor,
     BKE_curvemapping_evaluate_premulRGBF(cm_processor->curve_mapping, pixel, pixel);
   }
 
-  if (cm_processor->processor) {
+  if (cm_processor->fast_path != COLORMANAGE_FAST_PATH_NONE || cm_processor->lut) {
+    colormanage_processor_fast_apply_v3(cm_processor, pixel);
+  }
+  else if (cm_processor->processor) {
     OCIO_processorApplyRGBA(cm_processor->processor, pixel);
   }
 }
@@ -3823,7 +4285,10 @@ void IMB_colormanagement_processor_apply_v4_predivide(ColormanageProcessor *cm_p
     BKE_curvemapping_evaluate_premulRGBF(cm_processor->curve_mapping, pixel, pixel);
   }
 
-  if (cm_processor->processor) {
+  if (cm_processor->fast_path != COLORMANAGE_FAST_PATH_NONE || cm_processor->lut) {
+    colormanage_processor_fast_apply_v4_predivide(cm_processor, pixel);
+  }
+  else if (cm_processor->processor) {
     OCIO_processorApplyRGBA_predivide(cm_processor->processor, pixel);
   }
 }
@@ -3834,7 +4299,10 @@ void IMB_colormanagement_processor_apply_v3(ColormanageProcessor *cm_processor,
     BKE_curvemapping_evaluate_premulRGBF(cm_processor->curve_mapping, pixel, pixel);
   }
 
-  if (cm_processor->processor) {
+  if (cm_processor->fast_path != COLORMANAGE_FAST_PATH_NONE || cm_processor->lut) {
+    colormanage_processor_fast_apply_v3(cm_processor, pixel);
+  }
+  else if (cm_processor->processor) {
     OCIO_processorApplyRGB(cm_processor->processor, pixel);
   }
 }
@@ -3880,7 +4348,11 @@ void IMB_colormanagement_processor_apply(ColormanageProcessor *cm_processor,
     }
   }
 
-  if (cm_processor->processor && channels >= 3) {
+  if ((cm_processor->fast_path != COLORMANAGE_FAST_PATH_NONE || cm_processor->lut) &&
+      channels >= 3) {
+    colormanage_processor_fast_apply(cm_processor, buffer, width, height, channels, predivide);
+  }
+  else if (cm_processor->processor && channels >= 3) {
     OCIO_PackedImageDesc *img;
 
     /* apply OCIO processor */
@@ -3929,6 +4401,9 @@ void IMB_colormanagement_processor_free(ColormanageProcessor *cm_processor)
   if (cm_processor->processor) {
     OCIO_processorRelease(cm_processor->processor);
   }
+  if (cm_processor->lut_entry) {
+    colormanage_processor_lut_release(cm_processor);
+  }
 
   MEM_freeN(cm_processor);
 }
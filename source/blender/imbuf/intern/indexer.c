@@ -29,6 +29,7 @@
 #include "BLI_ghash.h"
 #include "BLI_path_util.h"
 #include "BLI_string.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 #ifdef _WIN32
 #  include "BLI_winstuff.h"
@@ -839,6 +840,20 @@ static void index_rebuild_ffmpeg_finish(FFmpegIndexBuilderContext *context, int
   MEM_freeN(context);
 }
 
+typedef struct FFmpegProxyEncodeData {
+  FFmpegIndexBuilderContext *context;
+  AVFrame *in_frame;
+} FFmpegProxyEncodeData;
+
+static void index_rebuild_ffmpeg_proxy_encode_cb(void *__restrict userdata,
+                                                 const int i,
+                                                 const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  FFmpegProxyEncodeData *data = userdata;
+
+  add_to_proxy_output_ffmpeg(data->context->proxy_ctx[i], data->in_frame);
+}
+
 static void index_rebuild_ffmpeg_proc_decoded_frame(FFmpegIndexBuilderContext *context,
                                                     AVPacket *curr_packet,
                                                     AVFrame *in_frame)
@@ -848,9 +863,16 @@ static void index_rebuild_ffmpeg_proc_decoded_frame(FFmpegIndexBuilderContext *c
   unsigned long long s_dts = context->seek_pos_dts;
   unsigned long long pts = av_get_pts_from_frame(context->iFormatCtx, in_frame);
 
-  for (i = 0; i < context->num_proxy_sizes; i++) {
-    add_to_proxy_output_ffmpeg(context->proxy_ctx[i], in_frame);
-  }
+  /* Every proxy size has its own scaler and encoder, so they can run side by side. */
+  FFmpegProxyEncodeData encode_data = {
+      .context = context,
+      .in_frame = in_frame,
+  };
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.min_iter_per_thread = 1;
+  BLI_task_parallel_range(
+      0, context->num_proxy_sizes, &encode_data, index_rebuild_ffmpeg_proxy_encode_cb, &settings);
 
   if (!context->start_pts_set) {
     context->start_pts = pts;
@@ -1089,6 +1111,39 @@ static void index_rebuild_fallback_finish(FallbackIndexBuilderContext *context,
   }
 }
 
+/* Frame handed from the decoding thread to the proxy encoding tasks. */
+typedef struct FallbackProxyFrame {
+  FallbackIndexBuilderContext *context;
+  struct ImBuf *ibuf;
+  int pos;
+} FallbackProxyFrame;
+
+static void index_rebuild_fallback_proxy_task(TaskPool *__restrict pool, void *taskdata)
+{
+  FallbackProxyFrame *frame = BLI_task_pool_user_data(pool);
+  FallbackIndexBuilderContext *context = frame->context;
+  struct anim *anim = context->anim;
+  const int i = POINTER_AS_INT(taskdata);
+  int x = anim->x * proxy_fac[i];
+  int y = anim->y * proxy_fac[i];
+
+  struct ImBuf *s_ibuf = IMB_dupImBuf(frame->ibuf);
+
+  IMB_scaleImBuf_filtered(s_ibuf, x, y, IMB_SCALE_FILTER_BILINEAR);
+
+  IMB_convert_rgba_to_abgr(s_ibuf);
+
+  AVI_write_frame(context->proxy_ctx[i], frame->pos, AVI_FORMAT_RGB32, s_ibuf->rect, x * y * 4);
+
+  /* note that libavi free's the buffer... */
+  s_ibuf->rect = NULL;
+
+  IMB_freeImBuf(s_ibuf);
+}
+
+/* Decoding stays on this thread, while each proxy size of the previous frame is scaled and
+ * written by its own task. At most one frame is in flight, which keeps memory bounded and
+ * frames ordered within every proxy file. */
 static void index_rebuild_fallback(FallbackIndexBuilderContext *context,
                                    short *stop,
                                    short *do_update,
@@ -1097,6 +1152,8 @@ static void index_rebuild_fallback(FallbackIndexBuilderContext *context,
   int cnt = IMB_anim_get_duration(context->anim, IMB_TC_NONE);
   int i, pos;
   struct anim *anim = context->anim;
+  FallbackProxyFrame frame = {context, NULL, 0};
+  TaskPool *pool = BLI_task_pool_create(&frame, TASK_PRIORITY_LOW);
 
   for (pos = 0; pos < cnt; pos++) {
     struct ImBuf *ibuf = IMB_anim_absolute(anim, pos, IMB_TC_NONE, IMB_PROXY_NONE);
@@ -1109,34 +1166,33 @@ static void index_rebuild_fallback(FallbackIndexBuilderContext *context,
     }
 
     if (*stop) {
+      IMB_freeImBuf(tmp_ibuf);
+      IMB_freeImBuf(ibuf);
       break;
     }
 
     IMB_flipy(tmp_ibuf);
 
-    for (i = 0; i < IMB_PROXY_MAX_SLOT; i++) {
-      if (context->proxy_sizes_in_use & proxy_sizes[i]) {
-        int x = anim->x * proxy_fac[i];
-        int y = anim->y * proxy_fac[i];
-
-        struct ImBuf *s_ibuf = IMB_dupImBuf(tmp_ibuf);
+    BLI_task_pool_work_and_wait(pool);
+    IMB_freeImBuf(frame.ibuf);
 
-        IMB_scalefastImBuf(s_ibuf, x, y);
+    frame.ibuf = tmp_ibuf;
+    frame.pos = pos;
 
-        IMB_convert_rgba_to_abgr(s_ibuf);
-
-        AVI_write_frame(context->proxy_ctx[i], pos, AVI_FORMAT_RGB32, s_ibuf->rect, x * y * 4);
-
-        /* note that libavi free's the buffer... */
-        s_ibuf->rect = NULL;
-
-        IMB_freeImBuf(s_ibuf);
+    for (i = 0; i < IMB_PROXY_MAX_SLOT; i++) {
+      if (context->proxy_sizes_in_use & proxy_sizes[i]) {
+        BLI_task_pool_push(
+            pool, index_rebuild_fallback_proxy_task, POINTER_FROM_INT(i), false, NULL);
       }
     }
 
-    IMB_freeImBuf(tmp_ibuf);
     IMB_freeImBuf(ibuf);
   }
+
+  BLI_task_pool_work_and_wait(pool);
+  BLI_task_pool_free(pool);
+
+  IMB_freeImBuf(frame.ibuf);
 }
 
 #endif /* WITH_AVI */
@@ -30,6 +30,7 @@
 #include "MEM_guardedalloc.h"
 
 #include "BLI_ghash.h"
+#include "BLI_math_base.h"
 #include "BLI_mempool.h"
 #include "BLI_string.h"
 #include "BLI_threads.h"
@@ -53,6 +54,16 @@
 static MEM_CacheLimiterC *limitor = NULL;
 static pthread_mutex_t limitor_lock = BLI_MUTEX_INITIALIZER;
 
+/* Frames behind the play-head are this many times less valuable than frames ahead of it,
+ * unless playback loops back to them soon. */
+#define MOVIECACHE_BEHIND_PENALTY 4
+
+/* Playback state shared by all caches, used to score frames against the play-head. */
+static struct {
+  int direction;
+  int loop_length;
+} moviecache_playback = {0, 0};
+
 typedef struct MovieCache {
   char name[64];
 
@@ -73,6 +84,10 @@ typedef struct MovieCache {
 
   void *last_userkey;
 
+  /* Frame of the most recent get or put, when the cache has a getdata callback. */
+  int last_framenr;
+  bool has_last_framenr;
+
   int totseg, *points, proxy, render_flags; /* for visual statistics optimization */
   int pad;
 } MovieCache;
@@ -87,6 +102,7 @@ typedef struct MovieCacheItem {
   ImBuf *ibuf;
   MEM_CacheLimiterHandleC *c_handle;
   void *priority_data;
+  int framenr;
 } MovieCacheItem;
 
 static unsigned int moviecache_hashhash(const void *keyv)
@@ -208,12 +224,40 @@ static size_t get_item_size(void *p)
   return size;
 }
 
+static int moviecache_userkey_framenr(const MovieCache *cache, void *userkey)
+{
+  int framenr, proxy, render_flags;
+
+  cache->getdatafp(userkey, &framenr, &proxy, &render_flags);
+
+  return framenr;
+}
+
+/* The play-head is read by get_item_priority() while the limiter enforces its limits, so it is
+ * only to be changed with limitor_lock held. */
+static void moviecache_last_framenr_set(MovieCache *cache, const int framenr)
+{
+  if (framenr != IMB_MOVIECACHE_NO_FRAMENR) {
+    cache->last_framenr = framenr;
+    cache->has_last_framenr = true;
+  }
+}
+
 static int get_item_priority(void *item_v, int default_priority)
 {
   MovieCacheItem *item = (MovieCacheItem *)item_v;
   MovieCache *cache = item->cache_owner;
   int priority;
 
+  if (!cache->getitempriorityfp && cache->getdatafp && cache->has_last_framenr &&
+      item->framenr != IMB_MOVIECACHE_NO_FRAMENR) {
+    priority = IMB_moviecache_frame_priority(cache->last_framenr, item->framenr);
+
+    PRINT("%s: cache '%s' item %p frame priority %d\n", __func__, cache->name, item, priority);
+
+    return priority;
+  }
+
   if (!cache->getitempriorityfp) {
     PRINT("%s: cache '%s' item %p use default priority %d\n",
           __func__,
@@ -245,6 +289,34 @@ static bool get_item_destroyable(void *item_v)
   return true;
 }
 
+void IMB_moviecache_set_playback(int direction, int loop_length)
+{
+  moviecache_playback.direction = (direction > 0) - (direction < 0);
+  moviecache_playback.loop_length = max_ii(loop_length, 0);
+}
+
+/* Higher is more valuable: frames near the play-head are kept longest. While playing, frames
+ * behind the play-head are only needed again once playback loops around, so their distance is
+ * measured through the loop range, or penalized when the range is unknown. */
+int IMB_moviecache_frame_priority(int current_framenr, int framenr)
+{
+  const int direction = moviecache_playback.direction;
+  const int loop_length = moviecache_playback.loop_length;
+  const int delta = framenr - current_framenr;
+  int distance = abs(delta);
+
+  if (direction != 0 && delta * direction < 0) {
+    if (loop_length > distance) {
+      distance = loop_length - distance;
+    }
+    else {
+      distance *= MOVIECACHE_BEHIND_PENALTY;
+    }
+  }
+
+  return -distance;
+}
+
 void IMB_moviecache_init(void)
 {
   limitor = new_MEM_CacheLimiter(IMB_moviecache_destructor, get_item_size);
@@ -328,6 +400,11 @@ static void do_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf, boo
   item->cache_owner = cache;
   item->c_handle = NULL;
   item->priority_data = NULL;
+  item->framenr = 0;
+
+  if (cache->getdatafp) {
+    item->framenr = moviecache_userkey_framenr(cache, userkey);
+  }
 
   if (cache->getprioritydatafp) {
     item->priority_data = cache->getprioritydatafp(userkey);
@@ -343,6 +420,10 @@ static void do_moviecache_put(MovieCache *cache, void *userkey, ImBuf *ibuf, boo
     BLI_mutex_lock(&limitor_lock);
   }
 
+  if (cache->getdatafp) {
+    moviecache_last_framenr_set(cache, item->framenr);
+  }
+
   item->c_handle = MEM_CacheLimiter_insert(limitor, item);
 
   MEM_CacheLimiter_ref(item->c_handle);
@@ -405,6 +486,16 @@ ImBuf *IMB_moviecache_get(MovieCache *cache, void *userkey)
   key.userkey = userkey;
   item = (MovieCacheItem *)BLI_ghash_lookup(cache->hash, &key);
 
+  /* Requests move the play-head even on a miss, so the frame about to be put is scored
+   * against the frames around it. */
+  if (cache->getdatafp) {
+    const int framenr = moviecache_userkey_framenr(cache, userkey);
+
+    BLI_mutex_lock(&limitor_lock);
+    moviecache_last_framenr_set(cache, framenr);
+    BLI_mutex_unlock(&limitor_lock);
+  }
+
   if (item) {
     if (item->ibuf) {
       BLI_mutex_lock(&limitor_lock);
@@ -515,7 +606,8 @@ void IMB_moviecache_get_cache_segments(
       if (item->ibuf) {
         cache->getdatafp(key->userkey, &framenr, &curproxy, &curflags);
 
-        if (curproxy == proxy && curflags == render_flags) {
+        if (curproxy == proxy && curflags == render_flags &&
+            framenr != IMB_MOVIECACHE_NO_FRAMENR) {
           frames[a++] = framenr;
         }
       }
@@ -1269,6 +1269,11 @@ void IMB_exr_read_channels(void *handle)
       }
     }
 
+    /* Skip decoding parts which have none of the requested channels, see IMB_exr_read_filter. */
+    if (frameBuffer.begin() == frameBuffer.end()) {
+      continue;
+    }
+
     /* Read pixels. */
     try {
       in.setFrameBuffer(frameBuffer);
@@ -1523,14 +1528,96 @@ static ExrPass *imb_exr_get_pass(ListBase *lb, char *passname)
   return pass;
 }
 
+/* Pass filter of multilayer files loaded by the calling thread, see IMB_exr_read_filter. */
+static thread_local ExrPassFilterFunc exr_read_filter = NULL;
+static thread_local void *exr_read_filter_userdata = NULL;
+
+void IMB_exr_read_filter(ExrPassFilterFunc filter, void *userdata)
+{
+  exr_read_filter = filter;
+  exr_read_filter_userdata = userdata;
+}
+
+/* Decide how channels are interleaved in the pass buffer: fills in channel strides, the pass
+ * chan_id and offset of every channel in the buffer. */
+static void imb_exr_pass_layout(ExrPass *pass, const int width, int r_chan_offset[])
+{
+  ExrChannel *echan;
+  int a;
+
+  if (pass->totchan == 1) {
+    echan = pass->chan[0];
+    echan->xstride = 1;
+    echan->ystride = width;
+    pass->chan_id[0] = echan->chan_id;
+    r_chan_offset[0] = 0;
+  }
+  else {
+    char lookup[256];
+
+    memset(lookup, 0, sizeof(lookup));
+
+    /* we can have RGB(A), XYZ(W), UVA */
+    if (pass->totchan == 3 || pass->totchan == 4) {
+      if (pass->chan[0]->chan_id == 'B' || pass->chan[1]->chan_id == 'B' ||
+          pass->chan[2]->chan_id == 'B') {
+        lookup[(unsigned int)'R'] = 0;
+        lookup[(unsigned int)'G'] = 1;
+        lookup[(unsigned int)'B'] = 2;
+        lookup[(unsigned int)'A'] = 3;
+      }
+      else if (pass->chan[0]->chan_id == 'Y' || pass->chan[1]->chan_id == 'Y' ||
+               pass->chan[2]->chan_id == 'Y') {
+        lookup[(unsigned int)'X'] = 0;
+        lookup[(unsigned int)'Y'] = 1;
+        lookup[(unsigned int)'Z'] = 2;
+        lookup[(unsigned int)'W'] = 3;
+      }
+      else {
+        lookup[(unsigned int)'U'] = 0;
+        lookup[(unsigned int)'V'] = 1;
+        lookup[(unsigned int)'A'] = 2;
+      }
+      for (a = 0; a < pass->totchan; a++) {
+        echan = pass->chan[a];
+        echan->xstride = pass->totchan;
+        echan->ystride = width * pass->totchan;
+        r_chan_offset[a] = lookup[(unsigned int)echan->chan_id];
+        pass->chan_id[(unsigned int)lookup[(unsigned int)echan->chan_id]] = echan->chan_id;
+      }
+    }
+    else { /* unknown */
+      for (a = 0; a < pass->totchan; a++) {
+        echan = pass->chan[a];
+        echan->xstride = pass->totchan;
+        echan->ystride = width * pass->totchan;
+        r_chan_offset[a] = a;
+        pass->chan_id[a] = echan->chan_id;
+      }
+    }
+  }
+}
+
+/* Remove pass which does not have memory assigned yet, together with its channels. */
+static void imb_exr_pass_remove(ExrHandle *data, ExrLayer *lay, ExrPass *pass)
+{
+  for (int a = 0; a < pass->totchan; a++) {
+    ExrChannel *echan = pass->chan[a];
+    BLI_remlink(&data->channels, echan);
+    delete echan->m;
+    MEM_freeN(echan);
+  }
+  BLI_freelinkN(&lay->passes, pass);
+}
+
 /* creates channels, makes a hierarchy and assigns memory to channels */
 static ExrHandle *imb_exr_begin_read_mem(IStream &file_stream,
                                          MultiPartInputFile &file,
                                          int width,
                                          int height)
 {
-  ExrLayer *lay;
-  ExrPass *pass;
+  ExrLayer *lay, *lay_next;
+  ExrPass *pass, *pass_next;
   ExrChannel *echan;
   ExrHandle *data = (ExrHandle *)IMB_exr_get_handle();
   int a;
@@ -1595,63 +1682,31 @@ static ExrHandle *imb_exr_begin_read_mem(IStream &file_stream,
   }
 
   /* with some heuristics, try to merge the channels in buffers */
-  for (lay = (ExrLayer *)data->layers.first; lay; lay = lay->next) {
-    for (pass = (ExrPass *)lay->passes.first; pass; pass = pass->next) {
-      if (pass->totchan) {
-        pass->rect = (float *)MEM_callocN(width * height * pass->totchan * sizeof(float),
-                                          "pass rect");
-        if (pass->totchan == 1) {
-          echan = pass->chan[0];
-          echan->rect = pass->rect;
-          echan->xstride = 1;
-          echan->ystride = width;
-          pass->chan_id[0] = echan->chan_id;
-        }
-        else {
-          char lookup[256];
-
-          memset(lookup, 0, sizeof(lookup));
-
-          /* we can have RGB(A), XYZ(W), UVA */
-          if (pass->totchan == 3 || pass->totchan == 4) {
-            if (pass->chan[0]->chan_id == 'B' || pass->chan[1]->chan_id == 'B' ||
-                pass->chan[2]->chan_id == 'B') {
-              lookup[(unsigned int)'R'] = 0;
-              lookup[(unsigned int)'G'] = 1;
-              lookup[(unsigned int)'B'] = 2;
-              lookup[(unsigned int)'A'] = 3;
-            }
-            else if (pass->chan[0]->chan_id == 'Y' || pass->chan[1]->chan_id == 'Y' ||
-                     pass->chan[2]->chan_id == 'Y') {
-              lookup[(unsigned int)'X'] = 0;
-              lookup[(unsigned int)'Y'] = 1;
-              lookup[(unsigned int)'Z'] = 2;
-              lookup[(unsigned int)'W'] = 3;
-            }
-            else {
-              lookup[(unsigned int)'U'] = 0;
-              lookup[(unsigned int)'V'] = 1;
-              lookup[(unsigned int)'A'] = 2;
-            }
-            for (a = 0; a < pass->totchan; a++) {
-              echan = pass->chan[a];
-              echan->rect = pass->rect + lookup[(unsigned int)echan->chan_id];
-              echan->xstride = pass->totchan;
-              echan->ystride = width * pass->totchan;
-              pass->chan_id[(unsigned int)lookup[(unsigned int)echan->chan_id]] = echan->chan_id;
-            }
-          }
-          else { /* unknown */
-            for (a = 0; a < pass->totchan; a++) {
-              echan = pass->chan[a];
-              echan->rect = pass->rect + a;
-              echan->xstride = pass->totchan;
-              echan->ystride = width * pass->totchan;
-              pass->chan_id[a] = echan->chan_id;
-            }
-          }
-        }
+  for (lay = (ExrLayer *)data->layers.first; lay; lay = lay_next) {
+    lay_next = lay->next;
+    for (pass = (ExrPass *)lay->passes.first; pass; pass = pass_next) {
+      pass_next = pass->next;
+      if (pass->totchan == 0) {
+        continue;
+      }
+      int chan_offset[EXR_PASS_MAXCHAN];
+      imb_exr_pass_layout(pass, width, chan_offset);
+      /* passes which are filtered out are never allocated nor decoded */
+      if (exr_read_filter && !exr_read_filter(exr_read_filter_userdata,
+                                              lay->name,
+                                              pass->internal_name,
+                                              pass->chan_id)) {
+        imb_exr_pass_remove(data, lay, pass);
+        continue;
       }
+      pass->rect = (float *)MEM_callocN(width * height * pass->totchan * sizeof(float),
+                                        "pass rect");
+      for (a = 0; a < pass->totchan; a++) {
+        pass->chan[a]->rect = pass->rect + chan_offset[a];
+      }
+    }
+    if (BLI_listbase_is_empty(&lay->passes)) {
+      BLI_freelinkN(&data->layers, lay);
     }
   }
 
@@ -40,6 +40,12 @@ extern "C" {
 
 struct StampData;
 
+/* Returns false for passes of multilayer files which are not to be read. */
+typedef bool (*ExrPassFilterFunc)(void *userdata,
+                                  const char *layname,
+                                  const char *passname,
+                                  const char *chan_id);
+
 void *IMB_exr_get_handle(void);
 void *IMB_exr_get_handle_name(const char *name);
 void IMB_exr_add_channel(void *handle,
@@ -78,6 +84,10 @@ void IMB_exrtile_write_channels(
     void *handle, int partx, int party, int level, const char *viewname, bool empty);
 void IMB_exr_clear_channels(void *handle);
 
+/* Only allocate and decode passes accepted by the filter when the calling thread loads multilayer
+ * files with IB_multilayer, until it is cleared again with NULL. */
+void IMB_exr_read_filter(ExrPassFilterFunc filter, void *userdata);
+
 void IMB_exr_multilayer_convert(void *handle,
                                 void *base,
                                 void *(*addview)(void *base, const char *str),
@@ -103,6 +103,10 @@ void IMB_exr_clear_channels(void * /*handle*/)
 {
 }
 
+void IMB_exr_read_filter(ExrPassFilterFunc /*filter*/, void * /*userdata*/)
+{
+}
+
 void IMB_exr_multilayer_convert(void * /*handle*/,
                                 void * /*base*/,
                                 void *(*/*addview*/)(void *base, const char *str),
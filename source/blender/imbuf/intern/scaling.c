@@ -22,8 +22,11 @@
  * \ingroup imbuf
  */
 
+#include "BLI_math_base.h"
 #include "BLI_math_color.h"
 #include "BLI_math_interp.h"
+#include "BLI_math_vector.h"
+#include "BLI_task.h"
 #include "BLI_utildefines.h"
 #include "MEM_guardedalloc.h"
 
@@ -35,6 +38,10 @@
 
 #include "BLI_sys_types.h"  // for intptr_t support
 
+#ifdef __SSE2__
+#  include <emmintrin.h>
+#endif
+
 static void imb_half_x_no_alloc(struct ImBuf *ibuf2, struct ImBuf *ibuf1)
 {
   uchar *p1, *_p1, *dest;
@@ -1874,3 +1881,367 @@ void IMB_scaleImBuf_threaded(ImBuf *ibuf, unsigned int newx, unsigned int newy)
     ibuf->rect_float = init_data.float_buffer;
   }
 }
+
+/* ******** filtered scaling ******** */
+
+/* Separable resampling: every output pixel is a weighted sum of source pixels in a window
+ * around it. Weights are computed once per output column and row, then the image is filtered
+ * horizontally into a temporary float buffer and vertically into the final buffer.
+ * Both passes are done in parallel bands of rows.
+ *
+ * Byte buffers are filtered with premultiplied alpha, float buffers are already premultiplied. */
+
+typedef struct ScaleFilterWeights {
+  /* First source pixel and number of source pixels contributing to each output pixel. */
+  int *start;
+  int *num;
+  /* Weights of the contributing pixels, max_taps per output pixel. */
+  float *weights;
+  int max_taps;
+} ScaleFilterWeights;
+
+static float scale_filter_radius(const IMB_ScaleFilter filter)
+{
+  switch (filter) {
+    case IMB_SCALE_FILTER_BOX:
+      return 0.5f;
+    case IMB_SCALE_FILTER_BILINEAR:
+      return 1.0f;
+    case IMB_SCALE_FILTER_LANCZOS3:
+      return 3.0f;
+    case IMB_SCALE_FILTER_MITCHELL:
+      return 2.0f;
+  }
+  return 1.0f;
+}
+
+MINLINE float scale_filter_sinc(const float x)
+{
+  if (x == 0.0f) {
+    return 1.0f;
+  }
+  return sinf((float)M_PI * x) / ((float)M_PI * x);
+}
+
+static float scale_filter_eval(const IMB_ScaleFilter filter, float x)
+{
+  x = fabsf(x);
+  switch (filter) {
+    case IMB_SCALE_FILTER_BOX:
+      return (x <= 0.5f) ? 1.0f : 0.0f;
+    case IMB_SCALE_FILTER_BILINEAR:
+      return (x < 1.0f) ? 1.0f - x : 0.0f;
+    case IMB_SCALE_FILTER_LANCZOS3:
+      return (x < 3.0f) ? scale_filter_sinc(x) * scale_filter_sinc(x / 3.0f) : 0.0f;
+    case IMB_SCALE_FILTER_MITCHELL: {
+      /* Mitchell-Netravali with B = C = 1/3. */
+      const float B = 1.0f / 3.0f, C = 1.0f / 3.0f;
+      if (x < 1.0f) {
+        return ((12.0f - 9.0f * B - 6.0f * C) * x * x * x +
+                (-18.0f + 12.0f * B + 6.0f * C) * x * x + (6.0f - 2.0f * B)) /
+               6.0f;
+      }
+      if (x < 2.0f) {
+        return ((-B - 6.0f * C) * x * x * x + (6.0f * B + 30.0f * C) * x * x +
+                (-12.0f * B - 48.0f * C) * x + (8.0f * B + 24.0f * C)) /
+               6.0f;
+      }
+      return 0.0f;
+    }
+  }
+  return 0.0f;
+}
+
+static void scale_filter_weights_init(ScaleFilterWeights *fw,
+                                      const IMB_ScaleFilter filter,
+                                      const int src_size,
+                                      const int dst_size)
+{
+  const float scale = (float)src_size / (float)dst_size;
+  /* When scaling down the filter is stretched to cover all the source pixels. */
+  const float filter_scale = max_ff(scale, 1.0f);
+  const float radius = scale_filter_radius(filter) * filter_scale;
+
+  fw->max_taps = (int)ceilf(2.0f * radius) + 2;
+  fw->start = MEM_malloc_arrayN(dst_size, sizeof(int), "scale filter start");
+  fw->num = MEM_malloc_arrayN(dst_size, sizeof(int), "scale filter num");
+  fw->weights = MEM_malloc_arrayN(
+      (size_t)dst_size * fw->max_taps, sizeof(float), "scale filter weights");
+
+  for (int i = 0; i < dst_size; i++) {
+    const float center = ((float)i + 0.5f) * scale;
+    const int start = max_ii(0, (int)floorf(center - radius));
+    const int end = min_ii(src_size, (int)ceilf(center + radius));
+    float *weights = &fw->weights[(size_t)i * fw->max_taps];
+    float weight_sum = 0.0f;
+    int num = 0;
+
+    for (int j = start; j < end && num < fw->max_taps; j++, num++) {
+      weights[num] = scale_filter_eval(filter, ((float)j + 0.5f - center) / filter_scale);
+      weight_sum += weights[num];
+    }
+
+    if (weight_sum != 0.0f) {
+      for (int j = 0; j < num; j++) {
+        weights[j] /= weight_sum;
+      }
+      fw->start[i] = start;
+      fw->num[i] = num;
+    }
+    else {
+      /* Can only happen for degenerate sizes, fall back to the nearest pixel. */
+      fw->start[i] = min_ii((int)center, src_size - 1);
+      fw->num[i] = 1;
+      weights[0] = 1.0f;
+    }
+  }
+}
+
+static void scale_filter_weights_free(ScaleFilterWeights *fw)
+{
+  MEM_freeN(fw->start);
+  MEM_freeN(fw->num);
+  MEM_freeN(fw->weights);
+}
+
+typedef struct ScaleFilterData {
+  const ScaleFilterWeights *weights;
+  int channels;
+  int src_x, dst_x;
+  /* Only one of the source and one of the destination buffers is set. */
+  const unsigned char *src_byte;
+  const float *src_float;
+  unsigned char *dst_byte;
+  float *dst_float;
+} ScaleFilterData;
+
+/* Accumulate a weighted sum of pixels, stride is in floats. */
+MINLINE void scale_filter_accumulate_rgba(float r_color[4],
+                                          const float *src,
+                                          const size_t stride,
+                                          const float *weights,
+                                          const int num)
+{
+#ifdef __SSE2__
+  __m128 sum = _mm_setzero_ps();
+  for (int i = 0; i < num; i++, src += stride) {
+    sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src), _mm_set1_ps(weights[i])));
+  }
+  _mm_storeu_ps(r_color, sum);
+#else
+  zero_v4(r_color);
+  for (int i = 0; i < num; i++, src += stride) {
+    madd_v4_v4fl(r_color, src, weights[i]);
+  }
+#endif
+}
+
+/* Filter a single row of float pixels horizontally. */
+static void scale_filter_x_row(const ScaleFilterData *data, const float *src, float *dst)
+{
+  const ScaleFilterWeights *fw = data->weights;
+  const int channels = data->channels;
+
+  for (int x = 0; x < data->dst_x; x++, dst += channels) {
+    const float *src_pixel = src + (size_t)fw->start[x] * channels;
+    const float *weights = &fw->weights[(size_t)x * fw->max_taps];
+    if (channels == 4) {
+      scale_filter_accumulate_rgba(dst, src_pixel, 4, weights, fw->num[x]);
+      continue;
+    }
+    for (int c = 0; c < channels; c++) {
+      dst[c] = 0.0f;
+    }
+    for (int i = 0; i < fw->num[x]; i++, src_pixel += channels) {
+      for (int c = 0; c < channels; c++) {
+        dst[c] += src_pixel[c] * weights[i];
+      }
+    }
+  }
+}
+
+typedef struct ScaleFilterByteTLS {
+  /* Source row converted to premultiplied float, allocated on first use. */
+  float *row;
+} ScaleFilterByteTLS;
+
+static void scale_filter_x_byte_cb(void *__restrict userdata,
+                                   const int y,
+                                   const TaskParallelTLS *__restrict tls)
+{
+  const ScaleFilterData *data = userdata;
+  ScaleFilterByteTLS *byte_tls = tls->userdata_chunk;
+  const unsigned char *src = data->src_byte + (size_t)y * data->src_x * 4;
+  float *dst = data->dst_float + (size_t)y * data->dst_x * 4;
+
+  /* Every source pixel contributes to several output pixels, convert it only once. */
+  if (byte_tls->row == NULL) {
+    byte_tls->row = MEM_malloc_arrayN((size_t)data->src_x * 4, sizeof(float), __func__);
+  }
+  float *row = byte_tls->row;
+  for (int x = 0; x < data->src_x; x++) {
+    straight_uchar_to_premul_float(&row[x * 4], &src[x * 4]);
+  }
+  scale_filter_x_row(data, row, dst);
+}
+
+static void scale_filter_x_byte_free(const void *__restrict UNUSED(userdata),
+                                     void *__restrict chunk)
+{
+  ScaleFilterByteTLS *byte_tls = chunk;
+  MEM_SAFE_FREE(byte_tls->row);
+}
+
+static void scale_filter_x_float_cb(void *__restrict userdata,
+                                    const int y,
+                                    const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const ScaleFilterData *data = userdata;
+  const int channels = data->channels;
+  const float *src = data->src_float + (size_t)y * data->src_x * channels;
+  float *dst = data->dst_float + (size_t)y * data->dst_x * channels;
+  scale_filter_x_row(data, src, dst);
+}
+
+static void scale_filter_y_cb(void *__restrict userdata,
+                              const int y,
+                              const TaskParallelTLS *__restrict UNUSED(tls))
+{
+  const ScaleFilterData *data = userdata;
+  const ScaleFilterWeights *fw = data->weights;
+  const int channels = data->channels;
+  const size_t row_stride = (size_t)data->dst_x * channels;
+  const float *src = data->src_float + (size_t)fw->start[y] * row_stride;
+  const float *weights = &fw->weights[(size_t)y * fw->max_taps];
+  const int num = fw->num[y];
+
+  for (int x = 0; x < data->dst_x; x++, src += channels) {
+    const size_t offset = ((size_t)y * data->dst_x + x) * channels;
+    if (channels == 4) {
+      float color[4];
+      scale_filter_accumulate_rgba(color, src, row_stride, weights, num);
+      if (data->dst_byte) {
+        premul_float_to_straight_uchar(data->dst_byte + offset, color);
+      }
+      else {
+        copy_v4_v4(data->dst_float + offset, color);
+      }
+      continue;
+    }
+    float *dst = data->dst_float + offset;
+    for (int c = 0; c < channels; c++) {
+      dst[c] = 0.0f;
+    }
+    for (int i = 0; i < num; i++) {
+      const float *src_pixel = src + i * row_stride;
+      for (int c = 0; c < channels; c++) {
+        dst[c] += src_pixel[c] * weights[i];
+      }
+    }
+  }
+}
+
+static void *scale_filter_buffer(const IMB_ScaleFilter filter,
+                                 const unsigned char *src_byte,
+                                 const float *src_float,
+                                 const int channels,
+                                 const int src_x,
+                                 const int src_y,
+                                 const int dst_x,
+                                 const int dst_y)
+{
+  ScaleFilterWeights weights_x, weights_y;
+  scale_filter_weights_init(&weights_x, filter, src_x, dst_x);
+  scale_filter_weights_init(&weights_y, filter, src_y, dst_y);
+
+  float *tmp = MEM_mallocN(sizeof(float) * channels * dst_x * src_y, "scale filter temp");
+  void *dst = (src_byte) ? MEM_mallocN(sizeof(char) * 4 * dst_x * dst_y, "scale filter byte") :
+                           MEM_mallocN(sizeof(float) * channels * dst_x * dst_y, "scale filter");
+
+  ScaleFilterData data = {
+      .weights = &weights_x,
+      .channels = channels,
+      .src_x = src_x,
+      .dst_x = dst_x,
+      .src_byte = src_byte,
+      .src_float = src_float,
+      .dst_float = tmp,
+  };
+
+  TaskParallelSettings settings;
+  BLI_parallel_range_settings_defaults(&settings);
+  settings.use_threading = ((size_t)dst_x * src_y > 64 * 64);
+  settings.min_iter_per_thread = 8;
+  if (src_byte) {
+    ScaleFilterByteTLS byte_tls = {NULL};
+    settings.userdata_chunk = &byte_tls;
+    settings.userdata_chunk_size = sizeof(byte_tls);
+    settings.func_free = scale_filter_x_byte_free;
+    BLI_task_parallel_range(0, src_y, &data, scale_filter_x_byte_cb, &settings);
+    settings.userdata_chunk = NULL;
+    settings.userdata_chunk_size = 0;
+    settings.func_free = NULL;
+  }
+  else {
+    BLI_task_parallel_range(0, src_y, &data, scale_filter_x_float_cb, &settings);
+  }
+
+  data.weights = &weights_y;
+  data.src_byte = NULL;
+  data.src_float = tmp;
+  data.dst_byte = (src_byte) ? dst : NULL;
+  data.dst_float = (src_byte) ? NULL : dst;
+
+  settings.use_threading = ((size_t)dst_x * dst_y > 64 * 64);
+  BLI_task_parallel_range(0, dst_y, &data, scale_filter_y_cb, &settings);
+
+  MEM_freeN(tmp);
+  scale_filter_weights_free(&weights_x);
+  scale_filter_weights_free(&weights_y);
+  return dst;
+}
+
+/**
+ * Scale both byte and float buffers with a separable filter, using multiple threads.
+ * Return true if \a ibuf is modified.
+ */
+bool IMB_scaleImBuf_filtered(struct ImBuf *ibuf,
+                             unsigned int newx,
+                             unsigned int newy,
+                             IMB_ScaleFilter filter)
+{
+  if (ibuf == NULL) {
+    return false;
+  }
+  if (ibuf->rect == NULL && ibuf->rect_float == NULL) {
+    return false;
+  }
+  if (newx == 0 || newy == 0) {
+    return false;
+  }
+  if (newx == ibuf->x && newy == ibuf->y) {
+    return false;
+  }
+
+  scalefast_Z_ImBuf(ibuf, newx, newy);
+
+  if (ibuf->rect) {
+    unsigned char *rect = scale_filter_buffer(
+        filter, (unsigned char *)ibuf->rect, NULL, 4, ibuf->x, ibuf->y, newx, newy);
+    imb_freerectImBuf(ibuf);
+    ibuf->mall |= IB_rect;
+    ibuf->rect = (unsigned int *)rect;
+  }
+
+  if (ibuf->rect_float) {
+    float *rect_float = scale_filter_buffer(
+        filter, NULL, ibuf->rect_float, ibuf->channels, ibuf->x, ibuf->y, newx, newy);
+    imb_freerectfloatImBuf(ibuf);
+    ibuf->mall |= IB_rectfloat;
+    ibuf->rect_float = rect_float;
+  }
+
+  ibuf->x = newx;
+  ibuf->y = newy;
+  return true;
+}
@@ -153,6 +153,7 @@ typedef enum {
   /* DEPRECATED, ONLY USED FOR DO-VERSIONS */
   eSubsurfModifierFlag_SubsurfUv_DEPRECATED = (1 << 3),
   eSubsurfModifierFlag_UseCrease = (1 << 4),
+  eSubsurfModifierFlag_UseCameraLevels = (1 << 5),
 } SubsurfModifierFlag;
 
 typedef enum {
@@ -175,7 +176,8 @@ typedef struct SubsurfModifierData {
   short subdivType, levels, renderLevels, flags;
   short uv_smooth;
   short quality;
-  char _pad[4];
+  /** Edge length in pixels to aim for with #eSubsurfModifierFlag_UseCameraLevels. */
+  float camera_edge_size;
 
   /* TODO(sergey): Get rid of those with the old CCG subdivision code. */
   void *emCache, *mCache;
@@ -2197,6 +2197,9 @@ typedef enum eSculptFlags {
 
   /* Don't display face sets in viewport. */
   SCULPT_HIDE_FACE_SETS = (1 << 16),
+
+  /* Reorder mesh vertices by PBVH node when entering sculpt mode. */
+  SCULPT_OPTIMIZE_VERTEX_ORDER = (1 << 17),
 } eSculptFlags;
 
 /* ImagePaintSettings.mode */
@@ -34,6 +34,12 @@
 
 #define STATS_MAX_SIZE 16384
 
+/* Formats of the exported evaluation profile. */
+enum {
+  DEPSGRAPH_PROFILE_FORMAT_CHROME_TRACE = 0,
+  DEPSGRAPH_PROFILE_FORMAT_CSV = 1,
+};
+
 #ifdef RNA_RUNTIME
 
 #  ifdef WITH_PYTHON
@@ -250,6 +256,33 @@ static void rna_Depsgraph_debug_stats_gnuplot(Depsgraph *depsgraph,
   fclose(f);
 }
 
+static void rna_Depsgraph_debug_profile_begin(Depsgraph *depsgraph)
+{
+  DEG_debug_profile_begin(depsgraph);
+}
+
+static void rna_Depsgraph_debug_profile_end(Depsgraph *depsgraph)
+{
+  DEG_debug_profile_end(depsgraph);
+}
+
+static void rna_Depsgraph_debug_profile_write(Depsgraph *depsgraph,
+                                              const char *filename,
+                                              int format)
+{
+  FILE *f = fopen(filename, "w");
+  if (f == NULL) {
+    return;
+  }
+  if (format == DEPSGRAPH_PROFILE_FORMAT_CSV) {
+    DEG_debug_profile_write_csv(depsgraph, f);
+  }
+  else {
+    DEG_debug_profile_write_chrome_trace(depsgraph, f);
+  }
+  fclose(f);
+}
+
 static void rna_Depsgraph_debug_tag_update(Depsgraph *depsgraph)
 {
   DEG_graph_tag_relations_update(depsgraph);
@@ -627,6 +660,16 @@ static void rna_def_depsgraph(BlenderRNA *brna)
       {0, NULL, 0, NULL, NULL},
   };
 
+  static EnumPropertyItem enum_depsgraph_profile_format_items[] = {
+      {DEPSGRAPH_PROFILE_FORMAT_CHROME_TRACE,
+       "CHROME_TRACE",
+       0,
+       "Chrome Trace",
+       "JSON file in the trace event format, which can be opened in chrome://tracing"},
+      {DEPSGRAPH_PROFILE_FORMAT_CSV, "CSV", 0, "CSV", "Table with comma separated values"},
+      {0, NULL, 0, NULL, NULL},
+  };
+
   srna = RNA_def_struct(brna, "Depsgraph", NULL);
   RNA_def_struct_ui_text(srna, "Dependency Graph", "");
 
@@ -654,6 +697,25 @@ static void rna_def_depsgraph(BlenderRNA *brna)
                                   "File name where gnuplot script will save the result");
   RNA_def_parameter_flags(parm, 0, PARM_REQUIRED);
 
+  func = RNA_def_function(srna, "debug_profile_begin", "rna_Depsgraph_debug_profile_begin");
+  RNA_def_function_ui_description(
+      func, "Start recording timing of every operation evaluated by the dependency graph");
+
+  func = RNA_def_function(srna, "debug_profile_end", "rna_Depsgraph_debug_profile_end");
+  RNA_def_function_ui_description(func, "Stop recording timing of evaluated operations");
+
+  func = RNA_def_function(srna, "debug_profile_write", "rna_Depsgraph_debug_profile_write");
+  RNA_def_function_ui_description(func, "Write recorded timing of evaluated operations");
+  parm = RNA_def_string_file_path(
+      func, "filename", NULL, FILE_MAX, "File Name", "Output path for the profile file");
+  RNA_def_parameter_flags(parm, 0, PARM_REQUIRED);
+  RNA_def_enum(func,
+               "format",
+               enum_depsgraph_profile_format_items,
+               DEPSGRAPH_PROFILE_FORMAT_CHROME_TRACE,
+               "Format",
+               "Format of the profile file");
+
   func = RNA_def_function(srna, "debug_tag_update", "rna_Depsgraph_debug_tag_update");
 
   func = RNA_def_function(srna, "debug_stats", "rna_Depsgraph_debug_stats");
@@ -1743,6 +1743,24 @@ static void rna_def_modifier_subsurf(BlenderRNA *brna)
   RNA_def_property_ui_text(
       prop, "Use Creases", "Use mesh edge crease information to sharpen edges");
   RNA_def_property_update(prop, 0, "rna_Modifier_update");
+
+  prop = RNA_def_property(srna, "use_camera_levels", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flags", eSubsurfModifierFlag_UseCameraLevels);
+  RNA_def_property_ui_text(prop,
+                           "Camera Levels",
+                           "Lower the render levels of objects which appear small from the scene "
+                           "camera, render levels are used as the maximum");
+  RNA_def_property_update(prop, 0, "rna_Modifier_dependency_update");
+
+  prop = RNA_def_property(srna, "camera_edge_size", PROP_FLOAT, PROP_PIXEL);
+  RNA_def_property_float_sdna(prop, NULL, "camera_edge_size");
+  RNA_def_property_range(prop, 0.1f, 1000.0f);
+  RNA_def_property_ui_range(prop, 0.5f, 100.0f, 10, 1);
+  RNA_def_property_ui_text(prop,
+                           "Edge Size",
+                           "Size of subdivided edges in pixels as seen from the scene camera, "
+                           "used to choose the render levels");
+  RNA_def_property_update(prop, 0, "rna_Modifier_update");
 }
 
 static void rna_def_modifier_generic_map_info(StructRNA *srna)
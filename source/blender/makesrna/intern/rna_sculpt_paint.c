@@ -778,6 +778,15 @@ static void rna_def_sculpt(BlenderRNA *brna)
   RNA_def_property_flag(prop, PROP_CONTEXT_UPDATE);
   RNA_def_property_update(prop, NC_OBJECT | ND_DRAW, "rna_Sculpt_update");
 
+  prop = RNA_def_property(srna, "use_optimized_vertex_order", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flags", SCULPT_OPTIMIZE_VERTEX_ORDER);
+  RNA_def_property_ui_text(prop,
+                           "Optimize Vertex Order",
+                           "Reorder the vertices of meshes without modifiers when entering sculpt "
+                           "mode, for faster brushes on dense meshes (the original order is "
+                           "restored when leaving sculpt mode)");
+  RNA_def_property_update(prop, NC_SCENE | ND_TOOLSETTINGS, NULL);
+
   prop = RNA_def_property(srna, "show_mask", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_negative_sdna(prop, NULL, "flags", SCULPT_HIDE_MASK);
   RNA_def_property_ui_text(prop, "Show Mask", "Show mask as overlay on object");
@@ -184,6 +184,7 @@ static const EnumPropertyItem rna_enum_userdef_viewport_aa_items[] = {
 #  include "BKE_paint.h"
 #  include "BKE_pbvh.h"
 #  include "BKE_screen.h"
+#  include "BKE_subdiv.h"
 
 #  include "DEG_depsgraph.h"
 
@@ -548,6 +549,8 @@ static void rna_Userdef_memcache_update(Main *UNUSED(bmain),
                                         PointerRNA *UNUSED(ptr))
 {
   MEM_CacheLimiter_set_maximum(((size_t)U.memcachelimit) * 1024 * 1024);
+  /* The subdivision topology cache budget follows the limit. */
+  BKE_subdiv_topology_cache_trim();
   USERDEF_TAG_DIRTY;
 }
 
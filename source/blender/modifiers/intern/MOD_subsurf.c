@@ -25,12 +25,18 @@
 
 #include "MEM_guardedalloc.h"
 
+#include "BLI_listbase.h"
+#include "BLI_math.h"
 #include "BLI_utildefines.h"
 
 #include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
 #include "DNA_object_types.h"
 #include "DNA_scene_types.h"
 
+#include "BKE_camera.h"
+#include "BKE_layer.h"
+#include "BKE_mesh.h"
 #include "BKE_scene.h"
 #include "BKE_subdiv.h"
 #include "BKE_subdiv_ccg.h"
@@ -39,6 +45,7 @@
 #include "BKE_subsurf.h"
 
 #include "DEG_depsgraph.h"
+#include "DEG_depsgraph_build.h"
 #include "DEG_depsgraph_query.h"
 
 #include "MOD_modifiertypes.h"
@@ -58,6 +65,7 @@ static void initData(ModifierData *md)
   smd->renderLevels = 2;
   smd->uv_smooth = SUBSURF_UV_SMOOTH_PRESERVE_CORNERS;
   smd->quality = 3;
+  smd->camera_edge_size = 2.0f;
   smd->flags |= (eSubsurfModifierFlag_UseCrease | eSubsurfModifierFlag_ControlEdges);
 }
 
@@ -108,13 +116,87 @@ static bool isDisabled(const Scene *scene, ModifierData *md, bool useRenderParam
   return get_render_subsurf_level(&scene->r, levels, useRenderParams != 0) == 0;
 }
 
+/* Camera used for final render, resolved the same way as the render pipeline does it: camera
+ * switch markers take priority over the scene camera, and the first camera of the render view
+ * layer is used when the scene has no camera set. */
+static Object *subdiv_render_camera_get(Scene *scene)
+{
+  Object *camera = BKE_scene_camera_switch_find(scene);
+  if (camera == NULL) {
+    camera = scene->camera;
+  }
+  if (camera == NULL) {
+    camera = BKE_view_layer_camera_find(BKE_view_layer_default_render(scene));
+  }
+  return camera;
+}
+
+/* Lower the number of levels for objects which appear small from the render camera, so that the
+ * average subdivided edge is not much smaller than the requested size in pixels. */
+static int subdiv_levels_from_camera_get(const SubsurfModifierData *smd,
+                                         const ModifierEvalContext *ctx,
+                                         Scene *scene,
+                                         const Mesh *mesh,
+                                         const int levels)
+{
+  const Object *camera = subdiv_render_camera_get(scene);
+  if (camera == NULL || mesh->totedge == 0) {
+    return levels;
+  }
+  /* Average edge length of the coarse mesh in world space. */
+  const MVert *mvert = mesh->mvert;
+  const MEdge *medge = mesh->medge;
+  float edge_length = 0.0f;
+  for (int i = 0; i < mesh->totedge; i++) {
+    edge_length += len_v3v3(mvert[medge[i].v1].co, mvert[medge[i].v2].co);
+  }
+  edge_length *= mat4_to_scale(ctx->object->obmat) / (float)mesh->totedge;
+  /* Distance from the camera to the closest point of the object bounds. */
+  float min[3], max[3], center[3];
+  INIT_MINMAX(min, max);
+  if (!BKE_mesh_minmax(mesh, min, max)) {
+    return levels;
+  }
+  mid_v3_v3v3(center, min, max);
+  mul_m4_v3(ctx->object->obmat, center);
+  const float radius = len_v3v3(min, max) * 0.5f * mat4_to_scale(ctx->object->obmat);
+  /* Size of a pixel at that distance. */
+  CameraParams params;
+  BKE_camera_params_init(&params);
+  BKE_camera_params_from_object(&params, camera);
+  BKE_camera_params_compute_viewplane(&params,
+                                      scene->r.xsch * scene->r.size / 100,
+                                      scene->r.ysch * scene->r.size / 100,
+                                      scene->r.xasp,
+                                      scene->r.yasp);
+  float pixel_size = params.viewdx;
+  if (!params.is_ortho) {
+    const float distance = max_ff(len_v3v3(camera->obmat[3], center) - radius,
+                                  params.clip_start);
+    pixel_size *= distance / params.clip_start;
+  }
+  /* Every level halves the edge length. */
+  float edge_size = edge_length / max_ff(pixel_size, FLT_EPSILON);
+  int camera_levels = 0;
+  while (camera_levels < levels && edge_size > smd->camera_edge_size) {
+    edge_size *= 0.5f;
+    camera_levels++;
+  }
+  return camera_levels;
+}
+
 static int subdiv_levels_for_modifier_get(const SubsurfModifierData *smd,
-                                          const ModifierEvalContext *ctx)
+                                          const ModifierEvalContext *ctx,
+                                          const Mesh *mesh)
 {
   Scene *scene = DEG_get_evaluated_scene(ctx->depsgraph);
   const bool use_render_params = (ctx->flag & MOD_APPLY_RENDER);
   const int requested_levels = (use_render_params) ? smd->renderLevels : smd->levels;
-  return get_render_subsurf_level(&scene->r, requested_levels, use_render_params);
+  const int levels = get_render_subsurf_level(&scene->r, requested_levels, use_render_params);
+  if (use_render_params && (smd->flags & eSubsurfModifierFlag_UseCameraLevels)) {
+    return subdiv_levels_from_camera_get(smd, ctx, scene, mesh, levels);
+  }
+  return levels;
 }
 
 static void subdiv_settings_init(SubdivSettings *settings, const SubsurfModifierData *smd)
@@ -144,9 +226,10 @@ static Subdiv *subdiv_descriptor_ensure(SubsurfModifierData *smd,
 
 static void subdiv_mesh_settings_init(SubdivToMeshSettings *settings,
                                       const SubsurfModifierData *smd,
-                                      const ModifierEvalContext *ctx)
+                                      const ModifierEvalContext *ctx,
+                                      const Mesh *mesh)
 {
-  const int level = subdiv_levels_for_modifier_get(smd, ctx);
+  const int level = subdiv_levels_for_modifier_get(smd, ctx, mesh);
   settings->resolution = (1 << level) + 1;
   settings->use_optimal_display = (smd->flags & eSubsurfModifierFlag_ControlEdges) &&
                                   !(ctx->flag & MOD_APPLY_TO_BASE_MESH);
@@ -159,7 +242,7 @@ static Mesh *subdiv_as_mesh(SubsurfModifierData *smd,
 {
   Mesh *result = mesh;
   SubdivToMeshSettings mesh_settings;
-  subdiv_mesh_settings_init(&mesh_settings, smd, ctx);
+  subdiv_mesh_settings_init(&mesh_settings, smd, ctx, mesh);
   if (mesh_settings.resolution < 3) {
     return result;
   }
@@ -171,9 +254,10 @@ static Mesh *subdiv_as_mesh(SubsurfModifierData *smd,
 
 static void subdiv_ccg_settings_init(SubdivToCCGSettings *settings,
                                      const SubsurfModifierData *smd,
-                                     const ModifierEvalContext *ctx)
+                                     const ModifierEvalContext *ctx,
+                                     const Mesh *mesh)
 {
-  const int level = subdiv_levels_for_modifier_get(smd, ctx);
+  const int level = subdiv_levels_for_modifier_get(smd, ctx, mesh);
   settings->resolution = (1 << level) + 1;
   settings->need_normal = true;
   settings->need_mask = false;
@@ -186,7 +270,7 @@ static Mesh *subdiv_as_ccg(SubsurfModifierData *smd,
 {
   Mesh *result = mesh;
   SubdivToCCGSettings ccg_settings;
-  subdiv_ccg_settings_init(&ccg_settings, smd, ctx);
+  subdiv_ccg_settings_init(&ccg_settings, smd, ctx, mesh);
   if (ccg_settings.resolution < 3) {
     return result;
   }
@@ -241,6 +325,36 @@ static Mesh *modifyMesh(ModifierData *md, const ModifierEvalContext *ctx, Mesh *
   return result;
 }
 
+static void subdiv_camera_relations_add(const ModifierUpdateDepsgraphContext *ctx, Object *camera)
+{
+  DEG_add_object_relation(ctx->node, camera, DEG_OB_COMP_TRANSFORM, "Subsurf Modifier");
+  DEG_add_object_relation(ctx->node, camera, DEG_OB_COMP_PARAMETERS, "Subsurf Modifier");
+}
+
+static void updateDepsgraph(ModifierData *md, const ModifierUpdateDepsgraphContext *ctx)
+{
+  SubsurfModifierData *smd = (SubsurfModifierData *)md;
+  if ((smd->flags & eSubsurfModifierFlag_UseCameraLevels) == 0) {
+    return;
+  }
+  /* Camera levels are only used for final render, keep viewport dependencies unchanged. */
+  if (DEG_get_mode(DEG_get_graph_from_handle(ctx->node)) != DAG_EVAL_RENDER) {
+    return;
+  }
+  Object *camera = subdiv_render_camera_get(ctx->scene);
+  if (camera == NULL) {
+    return;
+  }
+  subdiv_camera_relations_add(ctx, camera);
+  /* Camera switch markers change the render camera on frame change without relations update. */
+  LISTBASE_FOREACH (TimeMarker *, marker, &ctx->scene->markers) {
+    if (marker->camera != NULL && marker->camera != camera) {
+      subdiv_camera_relations_add(ctx, marker->camera);
+    }
+  }
+  DEG_add_modifier_to_transform_relation(ctx->node, "Subsurf Modifier");
+}
+
 static void deformMatrices(ModifierData *md,
                            const ModifierEvalContext *UNUSED(ctx),
                            Mesh *mesh,
@@ -299,7 +413,7 @@ ModifierTypeInfo modifierType_Subsurf = {
     /* requiredDataMask */ NULL,
     /* freeData */ freeData,
     /* isDisabled */ isDisabled,
-    /* updateDepsgraph */ NULL,
+    /* updateDepsgraph */ updateDepsgraph,
     /* dependsOnTime */ NULL,
     /* dependsOnNormals */ NULL,
     /* foreachObjectLink */ NULL,
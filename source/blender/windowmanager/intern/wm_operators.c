@@ -76,6 +76,8 @@
 
 #include "BKE_idtype.h"
 
+#include "DEG_depsgraph_debug.h"
+
 #include "BLF_api.h"
 
 #include "GPU_immediate.h"
@@ -3154,6 +3156,7 @@ enum {
   eRTAnimationStep = 4,
   eRTAnimationPlay = 5,
   eRTUndo = 6,
+  eRTDepsgraphEvaluation = 7,
 };
 
 static const EnumPropertyItem redraw_timer_type_items[] = {
@@ -3164,6 +3167,11 @@ static const EnumPropertyItem redraw_timer_type_items[] = {
     {eRTAnimationStep, "ANIM_STEP", 0, "Anim Step", "Animation Steps"},
     {eRTAnimationPlay, "ANIM_PLAY", 0, "Anim Play", "Animation Playback"},
     {eRTUndo, "UNDO", 0, "Undo/Redo", "Undo/Redo"},
+    {eRTDepsgraphEvaluation,
+     "DEPSGRAPH_EVAL",
+     0,
+     "Depsgraph Evaluation",
+     "Replay evaluation of the whole dependency graph"},
     {0, NULL, 0, NULL, NULL},
 };
 
@@ -3236,6 +3244,9 @@ static void redraw_timer_step(bContext *C,
       redraw_timer_window_swap(C);
     }
   }
+  else if (type == eRTDepsgraphEvaluation) {
+    DEG_debug_replay_evaluation(bmain, depsgraph);
+  }
   else { /* eRTUndo */
     /* Undo and redo, including depsgraph update since that can be a
      * significant part of the cost. */
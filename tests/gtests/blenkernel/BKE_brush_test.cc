@@ -0,0 +1,56 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+extern "C" {
+#include "DNA_brush_types.h"
+#include "DNA_color_types.h"
+
+#include "BKE_brush.h"
+}
+
+TEST(brush_curve_strength, ArrayMatchesScalar)
+{
+  const int presets[] = {BRUSH_CURVE_SMOOTH,
+                         BRUSH_CURVE_SPHERE,
+                         BRUSH_CURVE_ROOT,
+                         BRUSH_CURVE_SHARP,
+                         BRUSH_CURVE_LIN,
+                         BRUSH_CURVE_POW4,
+                         BRUSH_CURVE_INVSQUARE,
+                         BRUSH_CURVE_CONSTANT,
+                         BRUSH_CURVE_SMOOTHER};
+  const float radius = 2.5f;
+  /* More values than fit in one internal chunk, some outside of the radius. */
+  float dist[150];
+  for (int i = 0; i < 150; i++) {
+    dist[i] = i * 0.02f;
+  }
+
+  Brush brush = {{nullptr}};
+  for (int preset : presets) {
+    brush.curve_preset = preset;
+    float values[150];
+    memcpy(values, dist, sizeof(values));
+    BKE_brush_curve_strength_array(&brush, values, 150, radius);
+    for (int i = 0; i < 150; i++) {
+      EXPECT_FLOAT_EQ(values[i], BKE_brush_curve_strength(&brush, dist[i], radius))
+          << "preset " << preset << ", distance " << dist[i];
+    }
+  }
+}
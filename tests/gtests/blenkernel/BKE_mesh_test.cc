@@ -0,0 +1,246 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+/* Declares eOverlayFlags, which BKE_paint.h forward declares, that is not valid C++. */
+#include "DNA_brush_types.h"
+
+#include "BKE_customdata.h"
+#include "BKE_idtype.h"
+#include "BKE_lib_id.h"
+#include "BKE_main.h"
+#include "BKE_mesh.h"
+#include "BKE_object.h"
+#include "BKE_paint.h"
+
+#include "BLI_math.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+}
+
+/* Two triangles sharing an edge: (0, 1, 2) and (2, 1, 3). */
+static Mesh *mesh_two_tris_create()
+{
+  Mesh *me = BKE_mesh_new_nomain(4, 5, 0, 6, 2);
+  const float co[4][3] = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}, {1, 1, 0}};
+  for (int i = 0; i < 4; i++) {
+    copy_v3_v3(me->mvert[i].co, co[i]);
+  }
+  const int edges[5][2] = {{0, 1}, {1, 2}, {2, 0}, {1, 3}, {3, 2}};
+  for (int i = 0; i < 5; i++) {
+    me->medge[i].v1 = edges[i][0];
+    me->medge[i].v2 = edges[i][1];
+  }
+  const int loops[6] = {0, 1, 2, 2, 1, 3};
+  for (int i = 0; i < 6; i++) {
+    me->mloop[i].v = loops[i];
+  }
+  for (int i = 0; i < 2; i++) {
+    me->mpoly[i].loopstart = i * 3;
+    me->mpoly[i].totloop = 3;
+  }
+  return me;
+}
+
+class MeshVertReorderTest : public testing::Test {
+ protected:
+  static void SetUpTestCase()
+  {
+    BKE_idtype_init();
+  }
+};
+
+TEST_F(MeshVertReorderTest, RoundTrip)
+{
+  Mesh *me = mesh_two_tris_create();
+  int *value = (int *)CustomData_add_layer_named(
+      &me->vdata, CD_PROP_INT, CD_CALLOC, NULL, me->totvert, "value");
+  for (int i = 0; i < me->totvert; i++) {
+    value[i] = i * 10;
+  }
+
+  const uint vert_order[4] = {3, 0, 2, 1};
+  BKE_mesh_vert_reorder(me, vert_order);
+
+  value = (int *)CustomData_get_layer_named(&me->vdata, CD_PROP_INT, "value");
+  for (int i = 0; i < me->totvert; i++) {
+    EXPECT_EQ(value[i], vert_order[i] * 10);
+  }
+  /* Loops still reference the same positions. */
+  EXPECT_EQ(me->mvert[me->mloop[5].v].co[0], 1.0f);
+  EXPECT_EQ(me->mvert[me->mloop[5].v].co[1], 1.0f);
+  EXPECT_EQ(me->mloop[0].v, 1);
+  EXPECT_EQ(me->mloop[5].v, 0);
+  EXPECT_EQ(me->medge[3].v1, 3);
+  EXPECT_EQ(me->medge[3].v2, 0);
+
+  const uint vert_order_inv[4] = {1, 3, 2, 0};
+  BKE_mesh_vert_reorder(me, vert_order_inv);
+  value = (int *)CustomData_get_layer_named(&me->vdata, CD_PROP_INT, "value");
+  for (int i = 0; i < me->totvert; i++) {
+    EXPECT_EQ(value[i], i * 10);
+    EXPECT_EQ(me->mvert[i].co[0], (float)(i % 2));
+  }
+  EXPECT_EQ(me->mloop[5].v, 3);
+
+  BKE_id_free(NULL, me);
+}
+
+TEST_F(MeshVertReorderTest, SculptOrderRestore)
+{
+  Mesh *me = mesh_two_tris_create();
+  int *orig_index = (int *)CustomData_add_layer_named(
+      &me->vdata, CD_PROP_INT, CD_CALLOC, NULL, me->totvert, SCULPT_ORIG_VERT_INDEX_LAYER_NAME);
+  for (int i = 0; i < me->totvert; i++) {
+    orig_index[i] = i;
+  }
+  const uint vert_order[4] = {2, 3, 0, 1};
+  BKE_mesh_vert_reorder(me, vert_order);
+
+  EXPECT_TRUE(BKE_sculpt_vertex_order_restore(me));
+  EXPECT_FALSE(CustomData_has_layer(&me->vdata, CD_PROP_INT));
+  for (int i = 0; i < me->totvert; i++) {
+    EXPECT_EQ(me->mvert[i].co[0], (float)(i % 2));
+    EXPECT_EQ(me->mvert[i].co[1], (float)(i / 2));
+  }
+  EXPECT_EQ(me->mloop[5].v, 3);
+  EXPECT_FALSE(BKE_sculpt_vertex_order_restore(me));
+
+  BKE_id_free(NULL, me);
+}
+
+TEST_F(MeshVertReorderTest, SculptOrderRestoreInvalid)
+{
+  Mesh *me = mesh_two_tris_create();
+  int *orig_index = (int *)CustomData_add_layer_named(
+      &me->vdata, CD_PROP_INT, CD_CALLOC, NULL, me->totvert, SCULPT_ORIG_VERT_INDEX_LAYER_NAME);
+  /* Not a permutation, as left behind by topology changing tools. */
+  orig_index[0] = 1;
+  orig_index[1] = 1;
+
+  EXPECT_TRUE(BKE_sculpt_vertex_order_restore(me));
+  EXPECT_FALSE(CustomData_has_layer(&me->vdata, CD_PROP_INT));
+  EXPECT_EQ(me->mloop[5].v, 3);
+
+  BKE_id_free(NULL, me);
+}
+
+/* Grid of quads twice as wide as high, large enough for several PBVH leaves. The vertex indices
+ * are scattered, so the order by PBVH leaf is not the identity. */
+static Mesh *mesh_grid_add(Main *bmain, const int size)
+{
+  const int verts_num = (size + 1) * (size + 1);
+  const int polys_num = size * size;
+  Mesh *me = BKE_mesh_add(bmain, "Grid");
+  me->totvert = verts_num;
+  me->totloop = polys_num * 4;
+  me->totpoly = polys_num;
+  CustomData_add_layer(&me->vdata, CD_MVERT, CD_CALLOC, NULL, me->totvert);
+  CustomData_add_layer(&me->ldata, CD_MLOOP, CD_CALLOC, NULL, me->totloop);
+  CustomData_add_layer(&me->pdata, CD_MPOLY, CD_CALLOC, NULL, me->totpoly);
+  BKE_mesh_update_customdata_pointers(me, false);
+
+  /* 7919 is prime, so this is a permutation of the vertices. */
+  auto vert_index = [&](int x, int y) { return ((y * (size + 1) + x) * 7919) % verts_num; };
+
+  for (int y = 0; y <= size; y++) {
+    for (int x = 0; x <= size; x++) {
+      MVert *mv = &me->mvert[vert_index(x, y)];
+      mv->co[0] = 2.0f * x / size;
+      mv->co[1] = (float)y / size;
+    }
+  }
+  for (int y = 0; y < size; y++) {
+    for (int x = 0; x < size; x++) {
+      const int p = y * size + x;
+      me->mpoly[p].loopstart = p * 4;
+      me->mpoly[p].totloop = 4;
+      me->mloop[p * 4 + 0].v = vert_index(x, y);
+      me->mloop[p * 4 + 1].v = vert_index(x + 1, y);
+      me->mloop[p * 4 + 2].v = vert_index(x + 1, y + 1);
+      me->mloop[p * 4 + 3].v = vert_index(x, y + 1);
+    }
+  }
+  return me;
+}
+
+/* Sculpt undo steps store vertex indices in the optimized order. Undoing after leaving sculpt
+ * mode enters it again, which has to give the same order as before, even though the vertices
+ * moved since it was computed. */
+TEST_F(MeshVertReorderTest, SculptOrderUndoReenter)
+{
+  Main *bmain = BKE_main_new();
+  Mesh *me = mesh_grid_add(bmain, 128);
+  Object *ob = BKE_object_add_only_object(bmain, OB_MESH, "Grid");
+  ob->data = me;
+
+  float(*orig_co)[3] = (float(*)[3])MEM_malloc_arrayN(me->totvert, sizeof(*orig_co), __func__);
+  float(*undo_co)[3] = (float(*)[3])MEM_malloc_arrayN(me->totvert, sizeof(*undo_co), __func__);
+  int *sculpt_orig_index = (int *)MEM_malloc_arrayN(
+      me->totvert, sizeof(*sculpt_orig_index), __func__);
+  for (int i = 0; i < me->totvert; i++) {
+    copy_v3_v3(orig_co[i], me->mvert[i].co);
+  }
+
+  /* Enter sculpt mode. */
+  EXPECT_TRUE(BKE_sculpt_vertex_order_optimize(bmain, ob));
+  const int *orig_index = (const int *)CustomData_get_layer_named(
+      &me->vdata, CD_PROP_INT, SCULPT_ORIG_VERT_INDEX_LAYER_NAME);
+  ASSERT_NE(orig_index, nullptr);
+  memcpy(sculpt_orig_index, orig_index, sizeof(*sculpt_orig_index) * me->totvert);
+
+  /* Stroke, the undo step stores the coordinates before it by vertex index. Mirroring the mesh
+   * reverses the order of the PBVH leaves. */
+  for (int i = 0; i < me->totvert; i++) {
+    copy_v3_v3(undo_co[i], me->mvert[i].co);
+    me->mvert[i].co[0] = 2.0f - me->mvert[i].co[0];
+    me->mvert[i].co[2] = 0.1f * (i % 3);
+  }
+
+  /* Exit sculpt mode. */
+  EXPECT_TRUE(BKE_sculpt_vertex_order_restore(me));
+  EXPECT_EQ(CustomData_get_named_layer_index(
+                &me->vdata, CD_PROP_INT, SCULPT_ORIG_VERT_INDEX_LAYER_NAME),
+            -1);
+
+  /* Undo the stroke, which enters sculpt mode again. */
+  EXPECT_TRUE(BKE_sculpt_vertex_order_optimize(bmain, ob));
+  orig_index = (const int *)CustomData_get_layer_named(
+      &me->vdata, CD_PROP_INT, SCULPT_ORIG_VERT_INDEX_LAYER_NAME);
+  ASSERT_NE(orig_index, nullptr);
+  for (int i = 0; i < me->totvert; i++) {
+    EXPECT_EQ(orig_index[i], sculpt_orig_index[i]);
+    copy_v3_v3(me->mvert[i].co, undo_co[i]);
+  }
+
+  /* Exit sculpt mode, the mesh is back to where it started. */
+  EXPECT_TRUE(BKE_sculpt_vertex_order_restore(me));
+  for (int i = 0; i < me->totvert; i++) {
+    EXPECT_V3_NEAR(me->mvert[i].co, orig_co[i], 0.0f);
+  }
+
+  MEM_freeN(orig_co);
+  MEM_freeN(undo_co);
+  MEM_freeN(sculpt_orig_index);
+  BKE_main_free(bmain);
+}
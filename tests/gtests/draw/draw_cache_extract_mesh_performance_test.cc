@@ -0,0 +1,432 @@
+/* Apache License, Version 2.0 */
+
+/* Benchmark of the mesh draw cache extraction (`mesh_buffer_cache_create_requested`).
+ *
+ * Extraction only fills the CPU side of vertex and index buffers, uploading happens on first
+ * use. Buffers are never drawn here, so this runs without a GPU context. Each extractor runs in
+ * isolation and then all of them together, for every thread count up to the number of cores.
+ *
+ * Run with `--extract-blendfile=<path>` to additionally benchmark the evaluated meshes of a file.
+ */
+
+#include "testing/testing.h"
+
+#include "blenloader/blendfile_loading_base_test.h"
+
+#include "MEM_guardedalloc.h"
+
+extern "C" {
+#include "BLI_listbase.h"
+#include "BLI_math.h"
+#include "BLI_task.h"
+#include "BLI_string.h"
+#include "BLI_threads.h"
+#include "BLI_utildefines.h"
+
+#include "BKE_customdata.h"
+#include "BKE_editmesh.h"
+#include "BKE_lib_id.h"
+#include "BKE_main.h"
+#include "BKE_mesh.h"
+#include "BKE_object.h"
+#include "BKE_scene.h"
+
+#include "BLO_readfile.h"
+
+#include "DEG_depsgraph_query.h"
+
+#include "DNA_mesh_types.h"
+#include "DNA_meshdata_types.h"
+#include "DNA_object_types.h"
+#include "DNA_scene_types.h"
+
+#include "GPU_batch.h"
+
+#include "bmesh.h"
+
+#include "PIL_time.h"
+
+#include "draw_cache_extract.h"
+}
+
+DEFINE_string(extract_blendfile, "", "Blend file whose evaluated meshes are benchmarked.");
+
+#define NUM_RUN_AVERAGED 5
+
+/* Requirements of an extractor on the mesh or the mode. */
+enum {
+  EXTRACT_REQ_EDIT = (1 << 0),
+  EXTRACT_REQ_UV = (1 << 1),
+  EXTRACT_REQ_VCOL = (1 << 2),
+  EXTRACT_REQ_ORCO = (1 << 3),
+  EXTRACT_REQ_SKIN = (1 << 4),
+  /* `lines_loose` is a sub-range of `lines`. */
+  EXTRACT_REQ_LINES = (1 << 5),
+  /* Paint mode buffers, never requested in edit mode. */
+  EXTRACT_REQ_PAINT = (1 << 6),
+};
+
+struct ExtractorInfo {
+  const char *name;
+  size_t offset;
+  bool is_ibo;
+  int required;
+};
+
+#define EXTRACT_VBO(name, required) {#name, offsetof(MeshBufferCache, vbo.name), false, required}
+#define EXTRACT_IBO(name, required) {#name, offsetof(MeshBufferCache, ibo.name), true, required}
+
+static const ExtractorInfo extractors[] = {
+    EXTRACT_VBO(pos_nor, 0),
+    EXTRACT_VBO(lnor, 0),
+    EXTRACT_VBO(edge_fac, 0),
+    EXTRACT_VBO(weights, 0),
+    EXTRACT_VBO(uv, EXTRACT_REQ_UV),
+    EXTRACT_VBO(tan, EXTRACT_REQ_UV),
+    EXTRACT_VBO(vcol, EXTRACT_REQ_VCOL),
+    EXTRACT_VBO(orco, EXTRACT_REQ_ORCO),
+    EXTRACT_VBO(edit_data, EXTRACT_REQ_EDIT),
+    EXTRACT_VBO(edituv_data, EXTRACT_REQ_EDIT | EXTRACT_REQ_UV),
+    EXTRACT_VBO(stretch_area, EXTRACT_REQ_EDIT | EXTRACT_REQ_UV),
+    EXTRACT_VBO(stretch_angle, EXTRACT_REQ_EDIT | EXTRACT_REQ_UV),
+    EXTRACT_VBO(mesh_analysis, EXTRACT_REQ_EDIT),
+    EXTRACT_VBO(fdots_pos, 0),
+    EXTRACT_VBO(fdots_nor, EXTRACT_REQ_EDIT),
+    EXTRACT_VBO(fdots_uv, EXTRACT_REQ_EDIT | EXTRACT_REQ_UV),
+    EXTRACT_VBO(fdots_edituv_data, EXTRACT_REQ_EDIT | EXTRACT_REQ_UV),
+    EXTRACT_VBO(skin_roots, EXTRACT_REQ_EDIT | EXTRACT_REQ_SKIN),
+    EXTRACT_VBO(vert_idx, 0),
+    EXTRACT_VBO(edge_idx, 0),
+    EXTRACT_VBO(poly_idx, 0),
+    EXTRACT_VBO(fdot_idx, 0),
+    EXTRACT_IBO(tris, 0),
+    EXTRACT_IBO(lines, 0),
+    EXTRACT_IBO(lines_loose, EXTRACT_REQ_LINES),
+    EXTRACT_IBO(points, 0),
+    EXTRACT_IBO(fdots, 0),
+    EXTRACT_IBO(lines_paint_mask, EXTRACT_REQ_PAINT),
+    EXTRACT_IBO(lines_adjacency, 0),
+    EXTRACT_IBO(edituv_tris, EXTRACT_REQ_EDIT | EXTRACT_REQ_UV),
+    EXTRACT_IBO(edituv_lines, EXTRACT_REQ_EDIT | EXTRACT_REQ_UV),
+    EXTRACT_IBO(edituv_points, EXTRACT_REQ_EDIT | EXTRACT_REQ_UV),
+    EXTRACT_IBO(edituv_fdots, EXTRACT_REQ_EDIT | EXTRACT_REQ_UV),
+};
+
+#undef EXTRACT_VBO
+#undef EXTRACT_IBO
+
+static void **extractor_buffer_slot(MeshBufferCache *mbc, const ExtractorInfo *info)
+{
+  return (void **)((char *)mbc + info->offset);
+}
+
+static const ExtractorInfo *extractor_find(const char *name)
+{
+  for (const ExtractorInfo &info : extractors) {
+    if (STREQ(info.name, name)) {
+      return &info;
+    }
+  }
+  return nullptr;
+}
+
+/* -------------------------------------------------------------------- */
+/** \name Benchmark Mesh
+ * \{ */
+
+struct BenchmarkMesh {
+  const char *name;
+  Mesh *mesh;
+  bool is_editmode;
+  int available;
+};
+
+static int mesh_available_requirements(const Mesh *me, const bool is_editmode)
+{
+  const CustomData *vdata = is_editmode ? &me->edit_mesh->bm->vdata : &me->vdata;
+  const CustomData *ldata = is_editmode ? &me->edit_mesh->bm->ldata : &me->ldata;
+  int available = EXTRACT_REQ_LINES;
+  available |= is_editmode ? EXTRACT_REQ_EDIT : EXTRACT_REQ_PAINT;
+  if (CustomData_has_layer(ldata, CD_MLOOPUV)) {
+    available |= EXTRACT_REQ_UV;
+  }
+  if (CustomData_has_layer(ldata, CD_MLOOPCOL)) {
+    available |= EXTRACT_REQ_VCOL;
+  }
+  if (CustomData_has_layer(vdata, CD_ORCO)) {
+    available |= EXTRACT_REQ_ORCO;
+  }
+  if (CustomData_has_layer(vdata, CD_MVERT_SKIN)) {
+    available |= EXTRACT_REQ_SKIN;
+  }
+  return available;
+}
+
+/* Grid of `res * res` vertices on a wave, with UV, color, orco and skin layers. */
+static Mesh *mesh_grid_create(const int res)
+{
+  const int verts_len = res * res;
+  const int polys_len = (res - 1) * (res - 1);
+  Mesh *me = BKE_mesh_new_nomain(verts_len, 0, 0, polys_len * 4, polys_len);
+
+  float(*orco)[3] = (float(*)[3])CustomData_add_layer(
+      &me->vdata, CD_ORCO, CD_CALLOC, nullptr, verts_len);
+  MVertSkin *skin = (MVertSkin *)CustomData_add_layer(
+      &me->vdata, CD_MVERT_SKIN, CD_CALLOC, nullptr, verts_len);
+  MLoopUV *mloopuv = (MLoopUV *)CustomData_add_layer(
+      &me->ldata, CD_MLOOPUV, CD_CALLOC, nullptr, polys_len * 4);
+  MLoopCol *mloopcol = (MLoopCol *)CustomData_add_layer(
+      &me->ldata, CD_MLOOPCOL, CD_CALLOC, nullptr, polys_len * 4);
+  BKE_mesh_update_customdata_pointers(me, false);
+
+  for (int y = 0; y < res; y++) {
+    for (int x = 0; x < res; x++) {
+      const int v = y * res + x;
+      const float u = (float)x / (res - 1), w = (float)y / (res - 1);
+      me->mvert[v].co[0] = u;
+      me->mvert[v].co[1] = w;
+      me->mvert[v].co[2] = 0.05f * sinf(u * 20.0f) * cosf(w * 20.0f);
+      copy_v3_v3(orco[v], me->mvert[v].co);
+      skin[v].radius[0] = skin[v].radius[1] = 0.25f;
+    }
+  }
+  skin[0].flag |= MVERT_SKIN_ROOT;
+
+  int l = 0;
+  for (int y = 0; y < res - 1; y++) {
+    for (int x = 0; x < res - 1; x++) {
+      const int p = y * (res - 1) + x;
+      const int v = y * res + x;
+      const int corners[4] = {v, v + 1, v + res + 1, v + res};
+      me->mpoly[p].loopstart = l;
+      me->mpoly[p].totloop = 4;
+      me->mpoly[p].flag = ME_SMOOTH;
+      for (int i = 0; i < 4; i++, l++) {
+        me->mloop[l].v = corners[i];
+        copy_v2_v2(mloopuv[l].uv, me->mvert[corners[i]].co);
+        mloopcol[l].r = (uchar)(x & 0xff);
+        mloopcol[l].g = (uchar)(y & 0xff);
+        mloopcol[l].b = 128;
+        mloopcol[l].a = 255;
+      }
+    }
+  }
+
+  BKE_mesh_calc_edges(me, false, false);
+  BKE_mesh_calc_normals(me);
+  return me;
+}
+
+/* Wrap `me` in an edit-mesh, the way edit mode without modifiers does. */
+static void mesh_editmode_enter(Mesh *me)
+{
+  BMeshCreateParams create_params = {0};
+  BMeshFromMeshParams convert_params = {0};
+  convert_params.calc_face_normal = true;
+  BMesh *bm = BKE_mesh_to_bmesh_ex(me, &create_params, &convert_params);
+
+  BMEditMesh *em = BKE_editmesh_create(bm, true);
+  em->mesh_eval_final = em->mesh_eval_cage = BKE_mesh_from_editmesh_with_coords_thin_wrap(
+      em, nullptr, nullptr, me);
+  me->edit_mesh = em;
+}
+
+static void mesh_editmode_exit(Mesh *me)
+{
+  BKE_editmesh_free(me->edit_mesh);
+  MEM_freeN(me->edit_mesh);
+  me->edit_mesh = nullptr;
+}
+
+/** \} */
+
+/* -------------------------------------------------------------------- */
+/** \name Extraction
+ * \{ */
+
+static void mesh_batch_cache_discard_buffers(MeshBufferCache *mbc)
+{
+  for (const ExtractorInfo &info : extractors) {
+    void **slot = extractor_buffer_slot(mbc, &info);
+    if (*slot == nullptr) {
+      continue;
+    }
+    if (info.is_ibo) {
+      GPU_indexbuf_discard((GPUIndexBuf *)*slot);
+    }
+    else {
+      GPU_vertbuf_discard((GPUVertBuf *)*slot);
+    }
+    *slot = nullptr;
+  }
+}
+
+/* Request the buffers of `infos` and extract them, returns the time it took. */
+static double mesh_extract_run(const BenchmarkMesh &bmesh,
+                               const ExtractorInfo **infos,
+                               const int infos_len,
+                               const Scene *scene)
+{
+  Mesh *me = bmesh.mesh;
+  MeshBatchCache cache;
+  memset(&cache, 0, sizeof(cache));
+  cache.weight_state.defgroup_active = -1;
+
+  const int available = bmesh.available;
+  cache.cd_used.uv = cache.cd_used.tan = (available & EXTRACT_REQ_UV) ? 1 : 0;
+  cache.cd_used.edit_uv = (available & EXTRACT_REQ_UV) && bmesh.is_editmode ? 1 : 0;
+  cache.cd_used.vcol = (available & EXTRACT_REQ_VCOL) ? 1 : 0;
+  cache.cd_used.orco = (available & EXTRACT_REQ_ORCO) ? 1 : 0;
+
+  /* `lines_loose` extraction writes to `cache.final`, so request into it directly. */
+  MeshBufferCache *mbc = &cache.final;
+  for (int i = 0; i < infos_len; i++) {
+    void **slot = extractor_buffer_slot(mbc, infos[i]);
+    if (infos[i]->is_ibo) {
+      *slot = MEM_callocN(sizeof(GPUIndexBuf), __func__);
+    }
+    else {
+      *slot = MEM_callocN(sizeof(GPUVertBuf), __func__);
+    }
+  }
+
+  float obmat[4][4];
+  unit_m4(obmat);
+
+  const double time_start = PIL_check_seconds_timer();
+  mesh_buffer_cache_create_requested(&cache,
+                                     *mbc,
+                                     me,
+                                     bmesh.is_editmode,
+                                     false,
+                                     obmat,
+                                     true,
+                                     false,
+                                     false,
+                                     &cache.cd_used,
+                                     scene,
+                                     scene->toolsettings,
+                                     false);
+  const double time_end = PIL_check_seconds_timer();
+
+  mesh_batch_cache_discard_buffers(mbc);
+  return time_end - time_start;
+}
+
+static double mesh_extract_run_averaged(const BenchmarkMesh &bmesh,
+                                        const ExtractorInfo **infos,
+                                        const int infos_len,
+                                        const Scene *scene)
+{
+  /* Warm up caches and the lazily initialized vertex formats. */
+  mesh_extract_run(bmesh, infos, infos_len, scene);
+
+  double time = 0.0;
+  for (int i = 0; i < NUM_RUN_AVERAGED; i++) {
+    time += mesh_extract_run(bmesh, infos, infos_len, scene);
+  }
+  return time / NUM_RUN_AVERAGED;
+}
+
+static void mesh_extract_benchmark(const BenchmarkMesh &bmesh, const Scene *scene)
+{
+  const Mesh *me_final = bmesh.is_editmode ? bmesh.mesh->edit_mesh->mesh_eval_final :
+                                             bmesh.mesh;
+  const int loops_len = me_final->totloop;
+  const int threads_max = BLI_system_thread_count();
+  const ExtractorInfo *lines = extractor_find("lines");
+
+  for (int threads = 1;; threads = min_ii(threads * 2, threads_max)) {
+    BLI_system_num_threads_override_set(threads);
+    BLI_task_scheduler_init();
+
+    printf("\n%s (%s, %d verts, %d loops, %d threads)\n",
+           bmesh.name,
+           bmesh.is_editmode ? "edit mode" : "object mode",
+           me_final->totvert,
+           loops_len,
+           threads);
+
+    const ExtractorInfo *all[ARRAY_SIZE(extractors)];
+    int all_len = 0;
+    for (const ExtractorInfo &info : extractors) {
+      if ((info.required & bmesh.available) != info.required) {
+        continue;
+      }
+      const ExtractorInfo *infos[2] = {&info, lines};
+      const int infos_len = (info.required & EXTRACT_REQ_LINES) ? 2 : 1;
+      const double time = mesh_extract_run_averaged(bmesh, infos, infos_len, scene);
+      printf("  %-20s %9.3f ms %9.2f Mloops/s\n",
+             info.name,
+             time * 1000.0,
+             (double)loops_len / time * 1e-6);
+      all[all_len++] = &info;
+    }
+    const double time = mesh_extract_run_averaged(bmesh, all, all_len, scene);
+    printf("  %-20s %9.3f ms %9.2f Mloops/s\n",
+           "(all)",
+           time * 1000.0,
+           (double)loops_len / time * 1e-6);
+
+    BLI_task_scheduler_exit();
+    if (threads == threads_max) {
+      break;
+    }
+  }
+  BLI_system_num_threads_override_set(0);
+}
+
+/** \} */
+
+class DrawCacheExtractMeshPerformance : public BlendfileLoadingBaseTest {
+};
+
+TEST_F(DrawCacheExtractMeshPerformance, Grid)
+{
+  Main *bmain = BKE_main_new();
+  Scene *scene = BKE_scene_add(bmain, "Scene");
+
+  for (const int res : {64, 256, 1024}) {
+    char name[64];
+    BLI_snprintf(name, sizeof(name), "Grid %dx%d", res, res);
+
+    BenchmarkMesh bmesh = {name, mesh_grid_create(res), false, 0};
+    bmesh.available = mesh_available_requirements(bmesh.mesh, false);
+    mesh_extract_benchmark(bmesh, scene);
+
+    mesh_editmode_enter(bmesh.mesh);
+    bmesh.is_editmode = true;
+    bmesh.available = mesh_available_requirements(bmesh.mesh, true);
+    mesh_extract_benchmark(bmesh, scene);
+    mesh_editmode_exit(bmesh.mesh);
+
+    BKE_id_free(nullptr, bmesh.mesh);
+  }
+
+  BKE_main_free(bmain);
+}
+
+TEST_F(DrawCacheExtractMeshPerformance, Blendfile)
+{
+  if (FLAGS_extract_blendfile.empty()) {
+    printf("Pass --extract-blendfile to benchmark the meshes of a blend file.\n");
+    return;
+  }
+  bfile = BLO_read_from_file(FLAGS_extract_blendfile.c_str(), BLO_READ_SKIP_NONE, nullptr);
+  ASSERT_NE(bfile, nullptr) << "Unable to load '" << FLAGS_extract_blendfile << "'";
+  depsgraph_create(DAG_EVAL_VIEWPORT);
+
+  LISTBASE_FOREACH (Object *, ob, &bfile->main->objects) {
+    Object *ob_eval = DEG_get_evaluated_object(depsgraph, ob);
+    if (ob_eval == nullptr || ob_eval->type != OB_MESH) {
+      continue;
+    }
+    Mesh *me_eval = BKE_object_get_evaluated_mesh(ob_eval);
+    if (me_eval == nullptr) {
+      continue;
+    }
+    BenchmarkMesh bmesh = {ob->id.name + 2, me_eval, false, 0};
+    bmesh.available = mesh_available_requirements(me_eval, false);
+    mesh_extract_benchmark(bmesh, bfile->curscene);
+  }
+}
@@ -0,0 +1,187 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "DNA_brush_types.h"
+#include "DNA_scene_types.h"
+
+#include "BLI_math.h"
+#include "BLI_rand.h"
+
+#include "BKE_paint.h"
+#include "BKE_pbvh.h"
+
+#include "ED_view3d.h"
+
+#include "sculpt_intern.h"
+}
+
+#define NUM_VERTS 1000
+
+/* Vertices around the brush, some of them outside of it, with random normals and masks. */
+struct BrushBlockTestData {
+  float co[NUM_VERTS][3];
+  short no[NUM_VERTS][3];
+  float mask[NUM_VERTS];
+  float automask[NUM_VERTS];
+
+  BrushBlockTestData(const float location[3], const float radius)
+  {
+    RNG *rng = BLI_rng_new(0);
+    for (int i = 0; i < NUM_VERTS; i++) {
+      for (int j = 0; j < 3; j++) {
+        co[i][j] = location[j] + (BLI_rng_get_float(rng) * 2.0f - 1.0f) * radius * 1.2f;
+      }
+      float nor[3];
+      BLI_rng_get_float_unit_v3(rng, nor);
+      normal_float_to_short_v3(no[i], nor);
+      mask[i] = (i % 3 == 0) ? BLI_rng_get_float(rng) : 0.0f;
+      automask[i] = BLI_rng_get_float(rng);
+    }
+    BLI_rng_free(rng);
+  }
+};
+
+/* Displacement of the draw brush with the per-vertex brush test and strength factor, as the
+ * brushes which are not converted to blocks compute it. */
+static void draw_brush_displace_per_vertex(SculptSession *ss,
+                                           const Brush *brush,
+                                           SculptBrushTest *test,
+                                           const float offset[3],
+                                           BrushBlockTestData &data,
+                                           float (*r_proxy)[3])
+{
+  SculptBrushTestFn sculpt_brush_test_sq_fn = (brush->falloff_shape ==
+                                               PAINT_FALLOFF_SHAPE_SPHERE) ?
+                                                  SCULPT_brush_test_sphere_sq :
+                                                  SCULPT_brush_test_circle_sq;
+  for (int i = 0; i < NUM_VERTS; i++) {
+    zero_v3(r_proxy[i]);
+    if (!sculpt_brush_test_sq_fn(test, data.co[i])) {
+      continue;
+    }
+    const float fade = SCULPT_brush_strength_factor(
+        ss, brush, data.co[i], sqrtf(test->dist), data.no[i], NULL, data.mask[i], i, 0);
+    mul_v3_v3fl(r_proxy[i], offset, fade);
+  }
+}
+
+/* Displacement of the draw brush with the vertices gathered in blocks, same as
+ * #do_draw_brush_task_cb_ex. */
+static void draw_brush_displace_block(SculptSession *ss,
+                                      const Brush *brush,
+                                      const SculptBrushTest *test,
+                                      const float offset[3],
+                                      BrushBlockTestData &data,
+                                      float (*r_proxy)[3])
+{
+  SculptVertexBlock block;
+  block.len = 0;
+  for (int i = 0; i < NUM_VERTS; i++) {
+    zero_v3(r_proxy[i]);
+
+    PBVHVertexIter vd;
+    memset(&vd, 0, sizeof(vd));
+    vd.co = data.co[i];
+    vd.no = data.no[i];
+    vd.mask = &data.mask[i];
+    vd.index = i;
+    vd.i = i;
+    SCULPT_vertex_block_add(&block, &vd);
+
+    if (block.len == SCULPT_VERTEX_BLOCK_SIZE || i == NUM_VERTS - 1) {
+      SCULPT_vertex_block_brush_test_sq(&block, test, brush->falloff_shape);
+      SCULPT_vertex_block_strength_factor(ss, brush, &block, 0);
+      for (int j = 0; j < block.len; j++) {
+        mul_v3_v3fl(r_proxy[block.node_index[j]], offset, block.fade[j]);
+      }
+      block.len = 0;
+    }
+  }
+}
+
+static void test_draw_brush_block_matches_per_vertex(const char falloff_shape,
+                                                     const float hardness,
+                                                     const bool use_automasking)
+{
+  const float location[3] = {0.5f, -0.25f, 1.0f};
+  const float radius = 0.75f;
+  float view_normal[3] = {0.3f, -0.2f, 0.9f};
+  normalize_v3(view_normal);
+  BrushBlockTestData data(location, radius);
+
+  Brush brush;
+  memset(&brush, 0, sizeof(brush));
+  brush.curve_preset = BRUSH_CURVE_SMOOTH;
+  brush.hardness = hardness;
+  brush.flag = BRUSH_FRONTFACE;
+  brush.falloff_shape = falloff_shape;
+
+  ViewContext vc;
+  memset(&vc, 0, sizeof(vc));
+  StrokeCache cache;
+  memset(&cache, 0, sizeof(cache));
+  cache.vc = &vc;
+  cache.radius = radius;
+  copy_v3_v3(cache.view_normal, view_normal);
+  cache.automask = use_automasking ? data.automask : NULL;
+
+  SculptSession ss;
+  memset(&ss, 0, sizeof(ss));
+  ss.cache = &cache;
+
+  SculptBrushTest test;
+  memset(&test, 0, sizeof(test));
+  test.radius = radius;
+  test.radius_squared = radius * radius;
+  copy_v3_v3(test.location, location);
+  plane_from_point_normal_v3(test.plane_view, location, view_normal);
+
+  const float offset[3] = {0.1f, 0.2f, -0.3f};
+  std::vector<float> proxy_per_vertex(NUM_VERTS * 3), proxy_block(NUM_VERTS * 3);
+  draw_brush_displace_per_vertex(
+      &ss, &brush, &test, offset, data, (float(*)[3])proxy_per_vertex.data());
+  draw_brush_displace_block(&ss, &brush, &test, offset, data, (float(*)[3])proxy_block.data());
+
+  int num_displaced = 0;
+  for (int i = 0; i < NUM_VERTS * 3; i++) {
+    EXPECT_NEAR(proxy_block[i], proxy_per_vertex[i], 1e-5f) << "vertex " << i / 3;
+    num_displaced += (proxy_per_vertex[i] != 0.0f);
+  }
+  /* Make sure the test is not trivially passing. */
+  EXPECT_GT(num_displaced, NUM_VERTS / 4);
+}
+
+TEST(sculpt_brush_block, DrawSphereMatchesPerVertex)
+{
+  test_draw_brush_block_matches_per_vertex(PAINT_FALLOFF_SHAPE_SPHERE, 0.0f, false);
+}
+
+TEST(sculpt_brush_block, DrawSphereHardnessAutomaskMatchesPerVertex)
+{
+  test_draw_brush_block_matches_per_vertex(PAINT_FALLOFF_SHAPE_SPHERE, 0.4f, true);
+}
+
+TEST(sculpt_brush_block, DrawTubeMatchesPerVertex)
+{
+  test_draw_brush_block_matches_per_vertex(PAINT_FALLOFF_SHAPE_TUBE, 0.2f, true);
+}
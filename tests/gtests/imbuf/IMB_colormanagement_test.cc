@@ -0,0 +1,224 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+extern "C" {
+#include "BLI_math_base.h"
+#include "BLI_string.h"
+
+#include "DNA_color_types.h"
+
+#include "IMB_colormanagement.h"
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+}
+
+/* The OCIO handle types conflict with the forward declarations used by the color management
+ * headers in C++, so the OCIO API gets its own namespace here. */
+namespace ocio {
+#include "ocio_capi.h"
+}  // namespace ocio
+
+class imbuf_colormanagement : public testing::Test {
+ protected:
+  static void SetUpTestCase()
+  {
+    IMB_init();
+  }
+
+  static void TearDownTestCase()
+  {
+    IMB_exit();
+  }
+};
+
+/* Regular, HDR and negative colors, with opaque, transparent and partially transparent alpha. */
+static const float test_pixels[][4] = {
+    {0.0f, 0.5f, 1.0f, 1.0f},
+    {0.18f, 0.02f, 0.75f, 1.0f},
+    {0.0031308f, 0.04045f, 0.001f, 1.0f},
+    {2.0f, 0.1f, 4.0f, 1.0f},
+    {100.0f, 16.0f, 1.5f, 1.0f},
+    {-0.05f, 0.7f, 0.01f, 1.0f},
+    {-2.0f, -0.5f, 3.0f, 1.0f},
+    {0.2f, 0.1f, 0.4f, 0.5f},
+    {0.8f, 1.2f, -0.1f, 0.5f},
+    {0.3f, 0.6f, 0.9f, 0.0f},
+};
+
+#define NUM_TEST_PIXELS (sizeof(test_pixels) / sizeof(*test_pixels))
+
+/* Same tolerance the fast paths are detected with. */
+#define EPSILON 1e-3f
+
+static void expect_pixels_near(const float (*result)[4], const float (*expected)[4])
+{
+  for (int i = 0; i < NUM_TEST_PIXELS; i++) {
+    for (int c = 0; c < 4; c++) {
+      EXPECT_NEAR(result[i][c], expected[i][c], EPSILON) << "pixel " << i << " channel " << c;
+    }
+  }
+}
+
+/* Compare a color management processor against the OCIO processor of the same transform, for
+ * the buffer and single pixel code paths. */
+static void test_colorspace_processor(const char *from_colorspace, const char *to_colorspace)
+{
+  ocio::OCIO_ConstConfigRcPtr *config = ocio::OCIO_getCurrentConfig();
+  ocio::OCIO_ConstProcessorRcPtr *ocio_processor = ocio::OCIO_configGetProcessorWithNames(
+      config, from_colorspace, to_colorspace);
+  ColormanageProcessor *cm_processor = IMB_colormanagement_colorspace_processor_new(
+      from_colorspace, to_colorspace);
+  ASSERT_NE(ocio_processor, nullptr);
+
+  for (int predivide = 0; predivide < 2; predivide++) {
+    float expected[NUM_TEST_PIXELS][4], result[NUM_TEST_PIXELS][4];
+    memcpy(expected, test_pixels, sizeof(test_pixels));
+    memcpy(result, test_pixels, sizeof(test_pixels));
+
+    ocio::OCIO_PackedImageDesc *img = ocio::OCIO_createOCIO_PackedImageDesc(
+        (float *)expected, NUM_TEST_PIXELS, 1, 4, sizeof(float), 4 * sizeof(float), 0);
+    if (predivide) {
+      ocio::OCIO_processorApply_predivide(ocio_processor, img);
+    }
+    else {
+      ocio::OCIO_processorApply(ocio_processor, img);
+    }
+    ocio::OCIO_PackedImageDescRelease(img);
+
+    IMB_colormanagement_processor_apply(
+        cm_processor, (float *)result, NUM_TEST_PIXELS, 1, 4, predivide);
+    expect_pixels_near(result, expected);
+
+    memcpy(result, test_pixels, sizeof(test_pixels));
+    for (int i = 0; i < NUM_TEST_PIXELS; i++) {
+      if (predivide) {
+        IMB_colormanagement_processor_apply_v4_predivide(cm_processor, result[i]);
+      }
+      else {
+        IMB_colormanagement_processor_apply_v4(cm_processor, result[i]);
+      }
+    }
+    expect_pixels_near(result, expected);
+  }
+
+  IMB_colormanagement_processor_free(cm_processor);
+  ocio::OCIO_processorRelease(ocio_processor);
+  ocio::OCIO_configRelease(config);
+}
+
+TEST_F(imbuf_colormanagement, linear_to_srgb)
+{
+  test_colorspace_processor(
+      IMB_colormanagement_role_colorspace_name_get(COLOR_ROLE_SCENE_LINEAR),
+      IMB_colormanagement_role_colorspace_name_get(COLOR_ROLE_DEFAULT_BYTE));
+}
+
+TEST_F(imbuf_colormanagement, srgb_to_linear)
+{
+  test_colorspace_processor(
+      IMB_colormanagement_role_colorspace_name_get(COLOR_ROLE_DEFAULT_BYTE),
+      IMB_colormanagement_role_colorspace_name_get(COLOR_ROLE_SCENE_LINEAR));
+}
+
+TEST_F(imbuf_colormanagement, colorspace_to_scene_linear)
+{
+  const char *from_colorspace = IMB_colormanagement_role_colorspace_name_get(
+      COLOR_ROLE_DEFAULT_BYTE);
+  ocio::OCIO_ConstConfigRcPtr *config = ocio::OCIO_getCurrentConfig();
+  ocio::OCIO_ConstProcessorRcPtr *ocio_processor = ocio::OCIO_configGetProcessorWithNames(
+      config, from_colorspace, OCIO_ROLE_SCENE_LINEAR);
+  ASSERT_NE(ocio_processor, nullptr);
+
+  float expected[NUM_TEST_PIXELS][4], result[NUM_TEST_PIXELS][4];
+  memcpy(expected, test_pixels, sizeof(test_pixels));
+  memcpy(result, test_pixels, sizeof(test_pixels));
+
+  ocio::OCIO_PackedImageDesc *img = ocio::OCIO_createOCIO_PackedImageDesc(
+      (float *)expected, NUM_TEST_PIXELS, 1, 4, sizeof(float), 4 * sizeof(float), 0);
+  ocio::OCIO_processorApply_predivide(ocio_processor, img);
+  ocio::OCIO_PackedImageDescRelease(img);
+
+  /* Color spaces are not exposed by name, get it from an image buffer instead. */
+  ImBuf *ibuf = IMB_allocImBuf(1, 1, 32, IB_rect);
+  IMB_colormanagement_assign_rect_colorspace(ibuf, from_colorspace);
+  IMB_colormanagement_colorspace_to_scene_linear(
+      (float *)result, NUM_TEST_PIXELS, 1, 4, ibuf->rect_colorspace, true);
+  expect_pixels_near(result, expected);
+  IMB_freeImBuf(ibuf);
+
+  ocio::OCIO_processorRelease(ocio_processor);
+  ocio::OCIO_configRelease(config);
+}
+
+/* Display transforms without fast path (such as with exposure) are baked into a LUT for large
+ * buffers, compare against the OCIO processor applied pixel by pixel. */
+static void test_display_buffer_lut(const ColorManagedViewSettings *view_settings,
+                                    const ColorManagedDisplaySettings *display_settings)
+{
+  /* Just above the size a LUT is baked for. */
+  const int width = 1100, height = 1000;
+  ImBuf *ibuf = IMB_allocImBuf(width, height, 32, IB_rectfloat);
+  float(*pixels)[4] = (float(*)[4])ibuf->rect_float;
+  const size_t num_pixels = (size_t)width * height;
+
+  /* Regular and HDR colors, with steps different per channel to cover all combinations. */
+  for (size_t i = 0; i < num_pixels; i++) {
+    pixels[i][0] = (i % 97) / 96.0f;
+    pixels[i][1] = (i % 89) / 88.0f * 4.0f;
+    pixels[i][2] = (i % 101) / 100.0f * 0.1f;
+    pixels[i][3] = 1.0f;
+  }
+
+  IMB_colormanagement_imbuf_make_display_space(ibuf, view_settings, display_settings);
+
+  ColormanageProcessor *cm_processor = IMB_colormanagement_display_processor_new(
+      view_settings, display_settings);
+  for (size_t i = 0; i < num_pixels; i += 997) {
+    float expected[4] = {(i % 97) / 96.0f, (i % 89) / 88.0f * 4.0f, (i % 101) / 100.0f * 0.1f, 1.0f};
+    IMB_colormanagement_processor_apply_v4(cm_processor, expected);
+    for (int c = 0; c < 4; c++) {
+      /* Tolerance of the LUT, below a single step of 8 bit display buffers and relative to HDR
+       * colors. */
+      EXPECT_NEAR(pixels[i][c], expected[c], 4e-3f * max_ff(1.0f, fabsf(expected[c])))
+          << "pixel " << i << " channel " << c;
+    }
+  }
+  IMB_colormanagement_processor_free(cm_processor);
+
+  IMB_freeImBuf(ibuf);
+}
+
+TEST_F(imbuf_colormanagement, display_buffer_lut)
+{
+  ColorManagedDisplaySettings display_settings;
+  ColorManagedViewSettings view_settings;
+  BLI_strncpy(display_settings.display_device,
+              IMB_colormanagement_display_get_default_name(),
+              sizeof(display_settings.display_device));
+  IMB_colormanagement_init_default_view_settings(&view_settings, &display_settings);
+
+  view_settings.exposure = 1.0f;
+  test_display_buffer_lut(&view_settings, &display_settings);
+  /* Same settings, the LUT baked for the previous buffer is used. */
+  test_display_buffer_lut(&view_settings, &display_settings);
+  /* Other settings must not use that LUT. */
+  view_settings.exposure = -1.0f;
+  view_settings.gamma = 1.5f;
+  test_display_buffer_lut(&view_settings, &display_settings);
+}
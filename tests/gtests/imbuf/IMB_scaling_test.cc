@@ -0,0 +1,157 @@
+/*
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * The Original Code is Copyright (C) 2020 by Blender Foundation.
+ */
+#include "testing/testing.h"
+
+#include <cstdlib>
+
+extern "C" {
+#include "BLI_math_interp.h"
+
+#include "IMB_imbuf.h"
+#include "IMB_imbuf_types.h"
+}
+
+class imbuf_scaling : public testing::Test {
+ protected:
+  static void SetUpTestCase()
+  {
+    IMB_init();
+  }
+
+  static void TearDownTestCase()
+  {
+    IMB_exit();
+  }
+};
+
+#define SRC_X 16
+#define SRC_Y 12
+
+/* Opaque image with gradients and a hard edge, filled in both byte and float buffers. */
+static ImBuf *scaling_test_image_create(const bool use_float)
+{
+  ImBuf *ibuf = IMB_allocImBuf(SRC_X, SRC_Y, 32, use_float ? IB_rectfloat : IB_rect);
+  for (int y = 0; y < SRC_Y; y++) {
+    for (int x = 0; x < SRC_X; x++) {
+      const int offset = (y * SRC_X + x) * 4;
+      const unsigned char color[4] = {(unsigned char)(x * 16),
+                                      (unsigned char)(y * 20),
+                                      (unsigned char)((x < SRC_X / 2) ? 32 : 224),
+                                      255};
+      for (int c = 0; c < 4; c++) {
+        if (use_float) {
+          ibuf->rect_float[offset + c] = color[c] / 255.0f;
+        }
+        else {
+          ((unsigned char *)ibuf->rect)[offset + c] = color[c];
+        }
+      }
+    }
+  }
+  return ibuf;
+}
+
+/* Results may differ by one byte step: rounding differs, and the area average down-scaler
+ * accumulates a small error. */
+static void scaling_test_compare(const ImBuf *ibuf, const ImBuf *ibuf_ref, const int border)
+{
+  ASSERT_EQ(ibuf->x, ibuf_ref->x);
+  ASSERT_EQ(ibuf->y, ibuf_ref->y);
+  for (int y = border; y < ibuf->y - border; y++) {
+    for (int x = border; x < ibuf->x - border; x++) {
+      const int offset = (y * ibuf->x + x) * 4;
+      for (int c = 0; c < 4; c++) {
+        if (ibuf->rect_float) {
+          EXPECT_NEAR(ibuf->rect_float[offset + c], ibuf_ref->rect_float[offset + c], 1.0f / 255.0f)
+              << "pixel " << x << ", " << y << ", channel " << c;
+        }
+        else {
+          EXPECT_LE(abs(((unsigned char *)ibuf->rect)[offset + c] -
+                        ((unsigned char *)ibuf_ref->rect)[offset + c]),
+                    1)
+              << "pixel " << x << ", " << y << ", channel " << c;
+        }
+      }
+    }
+  }
+}
+
+/* Box filter of an integer down-scale is the area average done by IMB_scaleImBuf(). */
+static void scaling_test_box(const bool use_float)
+{
+  ImBuf *ibuf = scaling_test_image_create(use_float);
+  ImBuf *ibuf_ref = scaling_test_image_create(use_float);
+  IMB_scaleImBuf_filtered(ibuf, SRC_X / 2, SRC_Y / 2, IMB_SCALE_FILTER_BOX);
+  IMB_scaleImBuf(ibuf_ref, SRC_X / 2, SRC_Y / 2);
+  scaling_test_compare(ibuf, ibuf_ref, 0);
+  IMB_freeImBuf(ibuf);
+  IMB_freeImBuf(ibuf_ref);
+}
+
+/* Bilinear up-scale matches bilinear interpolation at the centers of the new pixels. Border
+ * pixels are skipped, the filter clamps to the image there instead of blending to black. */
+static void scaling_test_bilinear(const bool use_float)
+{
+  const int dst_x = SRC_X * 2, dst_y = SRC_Y * 2;
+  ImBuf *ibuf = scaling_test_image_create(use_float);
+  ImBuf *ibuf_ref = IMB_allocImBuf(dst_x, dst_y, 32, use_float ? IB_rectfloat : IB_rect);
+  for (int y = 0; y < dst_y; y++) {
+    for (int x = 0; x < dst_x; x++) {
+      const float u = ((float)x + 0.5f) * SRC_X / dst_x - 0.5f;
+      const float v = ((float)y + 0.5f) * SRC_Y / dst_y - 0.5f;
+      const int offset = (y * dst_x + x) * 4;
+      if (use_float) {
+        BLI_bilinear_interpolation_fl(
+            ibuf->rect_float, &ibuf_ref->rect_float[offset], SRC_X, SRC_Y, 4, u, v);
+      }
+      else {
+        BLI_bilinear_interpolation_char((unsigned char *)ibuf->rect,
+                                        &((unsigned char *)ibuf_ref->rect)[offset],
+                                        SRC_X,
+                                        SRC_Y,
+                                        4,
+                                        u,
+                                        v);
+      }
+    }
+  }
+  IMB_scaleImBuf_filtered(ibuf, dst_x, dst_y, IMB_SCALE_FILTER_BILINEAR);
+  scaling_test_compare(ibuf, ibuf_ref, 1);
+  IMB_freeImBuf(ibuf);
+  IMB_freeImBuf(ibuf_ref);
+}
+
+TEST_F(imbuf_scaling, BoxMatchesAreaAverageByte)
+{
+  scaling_test_box(false);
+}
+
+TEST_F(imbuf_scaling, BoxMatchesAreaAverageFloat)
+{
+  scaling_test_box(true);
+}
+
+TEST_F(imbuf_scaling, BilinearMatchesInterpolationByte)
+{
+  scaling_test_bilinear(false);
+}
+
+TEST_F(imbuf_scaling, BilinearMatchesInterpolationFloat)
+{
+  scaling_test_bilinear(true);
+}